@@ -0,0 +1,394 @@
+#include "../common/crypto/CCrypto.h"
+#include "../common/sphere_library/CSRand.h"
+#include "../common/CExpression.h"
+#include "../common/CLog.h"
+#include "../common/CServerMap.h"
+#include "../common/CUOInstall.h"
+#include "../game/chars/CChar.h"
+#include "../game/chars/CCharBase.h"
+#include "../game/chars/CCharNPC.h"
+#include "../game/items/CItemBase.h"
+#include "../game/items/CItemContainer.h"
+#include "../game/uo_files/CUOMapList.h"
+#include "../game/CRegion.h"
+#include "../game/CServer.h"
+#include "../game/CWorld.h"
+#include "../game/CWorldMap.h"
+#include "CBenchWorld.h"
+#include <memory>
+
+
+#define BENCHWORLD_TERRAIN_GRASS	0x0003
+#define BENCHWORLD_TERRAIN_WATER	0x00A8
+#define BENCHWORLD_LAKES			40
+#define BENCHWORLD_DEFS				4000
+
+// Items of the synthetic world, with their tiledata.
+static const struct BenchItemDef
+{
+	ITEMID_TYPE id;
+	IT_TYPE type;
+	uint64 uiFlags;
+	byte bWeight;
+	GUMP_TYPE gump;		// Containers only (TDATA2).
+	lpctstr pszName;
+} sm_BenchItemDefs[] =
+{
+	{ ITEMID_GOLD_C1,		IT_GOLD,		UFLAG2_STACKABLE,	0,	GUMP_NONE,		"gold coin" },
+	{ ITEMID_REAG_1,		IT_REAGENT,		UFLAG2_STACKABLE,	1,	GUMP_NONE,		"bat wing" },
+	{ ITEMID_REAG_BP,		IT_REAGENT,		UFLAG2_STACKABLE,	1,	GUMP_NONE,		"black pearl" },
+	{ ITEMID_LOG_1,			IT_LOG,			UFLAG2_STACKABLE,	2,	GUMP_NONE,		"log" },
+	{ ITEMID_INGOT_IRON,	IT_INGOT,		UFLAG2_STACKABLE,	1,	GUMP_NONE,		"iron ingot" },
+	{ ITEMID_BACKPACK,		IT_CONTAINER,	UFLAG3_CONTAINER,	3,	GUMP_BACKPACK,	"backpack" },
+	{ ITEMID_BAG,			IT_CONTAINER,	UFLAG3_CONTAINER,	2,	GUMP_BAG,		"bag" }
+};
+#define BENCHWORLD_RESOURCE_DEFS	5	// The first ones of sm_BenchItemDefs, lying around and in the containers.
+
+// NPCs of the synthetic world.
+static const struct BenchCharDef
+{
+	CREID_TYPE id;
+	NPCBRAIN_TYPE brain;
+	lpctstr pszName;
+} sm_BenchCharDefs[] =
+{
+	{ CREID_MAN,			NPCBRAIN_HUMAN,		"man" },
+	{ CREID_RAT,			NPCBRAIN_ANIMAL,	"rat" },
+	{ CREID_WOLF_TIMBER,	NPCBRAIN_ANIMAL,	"timber wolf" },
+	{ CREID_ORC,			NPCBRAIN_MONSTER,	"orc" }
+};
+
+
+static bool BenchWorld_IsWalkable( const CPointMap & pt )
+{
+	if ( !pt.IsValidPoint() )
+		return false;
+	const CUOMapMeter * pMeter = CWorldMap::GetMapMeter(pt);
+	return (pMeter != nullptr) && (pMeter->m_wTerrainIndex != BENCHWORLD_TERRAIN_WATER);
+}
+
+// Random walkable point around ptCenter (or anywhere, if ptCenter is invalid).
+static CPointMap BenchWorld_GetRandomPoint( const CPointMap & ptCenter, int iRange )
+{
+	CPointMap pt;
+	do
+	{
+		if ( ptCenter.IsValidPoint() )
+		{
+			pt = ptCenter;
+			pt.m_x += (short)CSRand::genRandInt32(-iRange, iRange);
+			pt.m_y += (short)CSRand::genRandInt32(-iRange, iRange);
+		}
+		else
+		{
+			pt = CPointMap((short)CSRand::genRandInt32(iRange, BENCHWORLD_MAP_SIZE - 1 - iRange),
+				(short)CSRand::genRandInt32(iRange, BENCHWORLD_MAP_SIZE - 1 - iRange), 0, 0);
+		}
+	} while ( !BenchWorld_IsWalkable(pt) );
+	return pt;
+}
+
+
+CBenchWorld::CBenchWorld() :
+	_pCenterChar(nullptr)
+{
+}
+
+void CBenchWorld::InitSettings()
+{
+	ADDTOCALLSTACK("CBenchWorld::InitSettings");
+	// What sphere.ini would set. The map blocks are made once, they must never expire from the cache.
+	g_Cfg.m_fUseMapDiffs = false;
+	g_Cfg._iMapCacheTime = INT64_MAX / 2;
+	g_Cfg.m_iMaxCharComplexity = UINT32_MAX;	// The spawn points are crowded on purpose.
+	g_Cfg.m_iMaxSectorComplexity = UINT32_MAX;
+
+	// Client keys, as in SphereCrypt.ini: one for each game encryption.
+	CCrypto::client_keys.clear();
+	CCrypto::addNoCryptKey();
+	CCrypto::client_keys.push_back({ 0x7008500, 0x3D33D2AD, 0xAAC95E7F, ENC_TFISH });	// 7.0.85
+	CCrypto::client_keys.push_back({ 0x2000000, 0x2D13A5FD, 0xA39D527F, ENC_BFISH });	// 2.0.0
+}
+
+void CBenchWorld::InitTiledata()
+{
+	ADDTOCALLSTACK("CBenchWorld::InitTiledata");
+	CUOTiledata & tiledata = g_Install.m_tiledata;
+
+	tiledata._tiledataTerrainEntries.assign(TERRAIN_QTY, CUOTerrainTypeRec_HS{});
+	CUOTerrainTypeRec_HS & grass = tiledata._tiledataTerrainEntries[BENCHWORLD_TERRAIN_GRASS];
+	grass.m_index = BENCHWORLD_TERRAIN_GRASS;
+	Str_CopyLimitNull(grass.m_name, "grass", sizeof(grass.m_name));
+	CUOTerrainTypeRec_HS & water = tiledata._tiledataTerrainEntries[BENCHWORLD_TERRAIN_WATER];
+	water.m_flags = UFLAG1_WATER|UFLAG1_BLOCK;
+	water.m_index = BENCHWORLD_TERRAIN_WATER;
+	Str_CopyLimitNull(water.m_name, "water", sizeof(water.m_name));
+
+	tiledata._tiledataItemEntries.assign(ITEMID_MULTI, CUOItemTypeRec_HS{});
+	for ( const BenchItemDef & itemDef : sm_BenchItemDefs )
+	{
+		CUOItemTypeRec_HS & entry = tiledata._tiledataItemEntries[itemDef.id];
+		entry.m_flags = itemDef.uiFlags;
+		entry.m_weight = itemDef.bWeight;
+		entry.m_height = (itemDef.type == IT_CONTAINER) ? 4 : 1;
+		Str_CopyLimitNull(entry.m_name, itemDef.pszName, sizeof(entry.m_name));
+	}
+}
+
+void CBenchWorld::InitMap()
+{
+	ADDTOCALLSTACK("CBenchWorld::InitMap");
+	// Map 0 only, as MAP0=maxx,maxy,sectorsize,mapnum,mapid in sphere.ini. The other maps are disabled.
+	tchar szArgs[64];
+	snprintf(szArgs, sizeof(szArgs), "%d,%d,%d,0,0", BENCHWORLD_MAP_SIZE, BENCHWORLD_MAP_SIZE, BENCHWORLD_SECTOR_SIZE);
+	g_MapList.Load(0, szArgs);
+	for ( int iMap = 1; iMap < MAP_SUPPORTED_QTY; ++iMap )
+	{
+		szArgs[0] = '\0';
+		g_MapList.Load(iMap, szArgs);
+	}
+	g_World.Init();
+	g_World._Cache.Init();
+
+	// Grass at z 0, with round lakes. Every block is put in the cache, so nothing is ever read from the MUL files.
+	struct Lake
+	{
+		int x, y, iRadius;
+	};
+	std::vector<Lake> vLakes(BENCHWORLD_LAKES);
+	for ( Lake & lake : vLakes )
+	{
+		lake.iRadius = CSRand::genRandInt32(4, 24);
+		lake.x = CSRand::genRandInt32(0, BENCHWORLD_MAP_SIZE - 1);
+		lake.y = CSRand::genRandInt32(0, BENCHWORLD_MAP_SIZE - 1);
+	}
+
+	const int iBlocks = BENCHWORLD_MAP_SIZE / UO_BLOCK_SIZE;
+	CUOMapBlock terrain = {};
+	for ( int iBy = 0; iBy < iBlocks; ++iBy )
+	{
+		for ( int iBx = 0; iBx < iBlocks; ++iBx )
+		{
+			for ( int iYo = 0; iYo < UO_BLOCK_SIZE; ++iYo )
+			{
+				for ( int iXo = 0; iXo < UO_BLOCK_SIZE; ++iXo )
+				{
+					const int x = (iBx * UO_BLOCK_SIZE) + iXo, y = (iBy * UO_BLOCK_SIZE) + iYo;
+					bool fWater = false;
+					for ( const Lake & lake : vLakes )
+					{
+						if ( ((x - lake.x) * (x - lake.x)) + ((y - lake.y) * (y - lake.y)) <= (lake.iRadius * lake.iRadius) )
+						{
+							fWater = true;
+							break;
+						}
+					}
+					CUOMapMeter & meter = terrain.m_Meter[(iYo * UO_BLOCK_SIZE) + iXo];
+					meter.m_wTerrainIndex = fWater ? BENCHWORLD_TERRAIN_WATER : BENCHWORLD_TERRAIN_GRASS;
+					meter.m_z = fWater ? -5 : 0;
+				}
+			}
+			g_World._Cache._mapBlocks[0][(iBy * iBlocks) + iBx] = std::make_unique<CServerMapBlock>(iBx, iBy, 0, terrain);
+		}
+	}
+}
+
+void CBenchWorld::InitDefs()
+{
+	ADDTOCALLSTACK("CBenchWorld::InitDefs");
+	// The definitions are created already loaded, as FindItemBase and FindCharBase would do reading the scripts.
+	for ( const BenchItemDef & itemDef : sm_BenchItemDefs )
+	{
+		CItemBase * pItemDef = new CItemBase(itemDef.id);
+		pItemDef->SetType(itemDef.type);
+		if ( itemDef.type == IT_CONTAINER )
+			pItemDef->m_ttContainer.m_idGump = itemDef.gump;
+		g_Cfg.m_ResHash.AddSortKey(pItemDef->GetResourceID(), pItemDef);
+	}
+	for ( const BenchCharDef & charDef : sm_BenchCharDefs )
+	{
+		CCharBase * pCharDef = new CCharBase(charDef.id);
+		pCharDef->SetTypeName(charDef.pszName);
+		pCharDef->m_Str = 60;
+		pCharDef->m_Dex = 40;
+		pCharDef->m_Int = 20;
+		g_Cfg.m_ResHash.AddSortKey(pCharDef->GetResourceID(), pCharDef);
+	}
+
+	// The dead NPCs are respawned through the resurrection spell (its effect and sound).
+	g_Cfg.m_SpellDefs.assign_at_grow(SPELL_Resurrection, new CSpellDef(SPELL_Resurrection));
+
+	// DEFs, as many as a shard scripts pack has.
+	tchar szKey[32];
+	for ( int i = 0; i < BENCHWORLD_DEFS; ++i )
+	{
+		snprintf(szKey, sizeof(szKey), "bench_def_%d", i);
+		g_Exp.m_VarDefs.SetNumNew(szKey, i);
+	}
+	g_Exp.m_VarDefs.Freeze();
+}
+
+void CBenchWorld::InitRegions()
+{
+	ADDTOCALLSTACK("CBenchWorld::InitRegions");
+	// An area for the whole map, then small areas (towns) each with a room (a house) inside, and a city full of houses.
+	CRectMap rect;
+	rect.SetRect(0, 0, BENCHWORLD_MAP_SIZE, BENCHWORLD_MAP_SIZE, 0);
+	CRegionWorld * pArea = new CRegionWorld(CResourceID(RES_AREA, 1), "Bench world");
+	pArea->AddRegionRect(rect);
+	if ( pArea->RealizeRegion() )
+	{
+		g_Cfg.m_ResHash.AddSortKey(pArea->GetResourceID(), pArea);
+		g_Cfg.m_RegionDefs.push_back(pArea);
+	}
+
+	tchar szName[32];
+	for ( int i = 0; i < BENCHWORLD_REGIONS; ++i )
+	{
+		const int iSize = CSRand::genRandInt32(16, 48);
+		const int x = CSRand::genRandInt32(0, BENCHWORLD_MAP_SIZE - iSize), y = CSRand::genRandInt32(0, BENCHWORLD_MAP_SIZE - iSize);
+		rect.SetRect(x, y, x + iSize, y + iSize, 0);
+		snprintf(szName, sizeof(szName), "Bench town %d", i);
+		pArea = new CRegionWorld(CResourceID(RES_AREA, 2 + i), szName);
+		pArea->AddRegionRect(rect);
+		if ( !pArea->RealizeRegion() )
+		{
+			delete pArea;
+			continue;
+		}
+		g_Cfg.m_ResHash.AddSortKey(pArea->GetResourceID(), pArea);
+		g_Cfg.m_RegionDefs.push_back(pArea);
+
+		rect.SetRect(x + 4, y + 4, x + 12, y + 12, 0);
+		snprintf(szName, sizeof(szName), "Bench house %d", i);
+		CRegion * pRoom = new CRegion(CResourceID(RES_ROOM, 1 + i), szName);
+		pRoom->AddRegionRect(rect);
+		if ( !pRoom->RealizeRegion() )
+		{
+			delete pRoom;
+			continue;
+		}
+		g_Cfg.m_ResHash.AddSortKey(pRoom->GetResourceID(), pRoom);
+		g_Cfg.m_RegionDefs.push_back(pRoom);
+	}
+
+	// The city: its sectors have dozens of regions each, like the big towns of a shard.
+	const int iCityStart = (BENCHWORLD_MAP_SIZE - BENCHWORLD_CITY_SIZE) / 2;
+	rect.SetRect(iCityStart, iCityStart, iCityStart + BENCHWORLD_CITY_SIZE, iCityStart + BENCHWORLD_CITY_SIZE, 0);
+	pArea = new CRegionWorld(CResourceID(RES_AREA, 2 + BENCHWORLD_REGIONS), "Bench city");
+	pArea->AddRegionRect(rect);
+	if ( pArea->RealizeRegion() )
+	{
+		g_Cfg.m_ResHash.AddSortKey(pArea->GetResourceID(), pArea);
+		g_Cfg.m_RegionDefs.push_back(pArea);
+	}
+
+	int iHouse = 0;
+	for ( int y = iCityStart; y < iCityStart + BENCHWORLD_CITY_SIZE; y += 8 )
+	{
+		for ( int x = iCityStart; x < iCityStart + BENCHWORLD_CITY_SIZE; x += 8 )
+		{
+			rect.SetRect(x + 1, y + 1, x + 7, y + 7, 0);
+			snprintf(szName, sizeof(szName), "Bench city house %d", iHouse);
+			CRegion * pRoom = new CRegion(CResourceID(RES_ROOM, 1 + BENCHWORLD_REGIONS + iHouse), szName);
+			++iHouse;
+			pRoom->AddRegionRect(rect);
+			if ( !pRoom->RealizeRegion() )
+			{
+				delete pRoom;
+				continue;
+			}
+			g_Cfg.m_ResHash.AddSortKey(pRoom->GetResourceID(), pRoom);
+			g_Cfg.m_RegionDefs.push_back(pRoom);
+		}
+	}
+}
+
+void CBenchWorld::CreateItems()
+{
+	ADDTOCALLSTACK("CBenchWorld::CreateItems");
+	const CPointMap ptNowhere;
+
+	// Piles of resources and gold lying around.
+	for ( int i = 0; i < BENCHWORLD_GROUND_ITEMS; ++i )
+	{
+		CItem * pItem = CItem::CreateBase(sm_BenchItemDefs[CSRand::genRandInt32(0, BENCHWORLD_RESOURCE_DEFS - 1)].id);
+		pItem->SetAmount((word)CSRand::genRandInt32(1, 100));
+		pItem->MoveTo(BenchWorld_GetRandomPoint(ptNowhere, 1));
+	}
+
+	// Backpacks, with a bag inside. Resources in both.
+	_vContainers.reserve(BENCHWORLD_CONTAINERS * 2);
+	for ( int i = 0; i < BENCHWORLD_CONTAINERS; ++i )
+	{
+		CItemContainer * pPack = dynamic_cast<CItemContainer *>(CItem::CreateBase(ITEMID_BACKPACK));
+		CItemContainer * pBag = dynamic_cast<CItemContainer *>(CItem::CreateBase(ITEMID_BAG));
+		ASSERT(pPack && pBag);
+		pPack->MoveTo(BenchWorld_GetRandomPoint(ptNowhere, 1));
+		pPack->ContentAdd(pBag);
+		for ( int j = 0; j < 16; ++j )
+		{
+			CItem * pItem = CItem::CreateBase(sm_BenchItemDefs[j % BENCHWORLD_RESOURCE_DEFS].id);
+			pItem->SetAmount((word)CSRand::genRandInt32(1, 50));
+			((j & 1) ? pBag : pPack)->ContentAdd(pItem, true);
+		}
+		_vContainers.emplace_back(pPack);
+		_vContainers.emplace_back(pBag);
+	}
+}
+
+void CBenchWorld::CreateChars()
+{
+	ADDTOCALLSTACK("CBenchWorld::CreateChars");
+	// Created like a spawn does, around its point, with the spawn point as home.
+	auto CreateNPC = [](const BenchCharDef & charDef, const CPointMap & ptHome, int iRange) -> CChar *
+	{
+		CChar * pChar = CChar::CreateBasic(charDef.id);
+		ASSERT(pChar);
+		pChar->SetNPCBrain(charDef.brain);
+		const CCharBase * pCharDef = pChar->Char_GetDef();
+		pChar->Stat_SetBase(STAT_STR, pCharDef->m_Str);
+		pChar->Stat_SetBase(STAT_DEX, pCharDef->m_Dex);
+		pChar->Stat_SetBase(STAT_INT, pCharDef->m_Int);
+		pChar->NPC_LoadScript(true);
+		pChar->StatFlag_Set(STATF_SPAWNED);
+		pChar->MoveTo(BenchWorld_GetRandomPoint(ptHome, iRange));
+		pChar->m_ptHome = ptHome;
+		pChar->m_pNPC->m_Home_Dist_Wander = (word)iRange;
+		pChar->NPC_CreateTrigger();
+		pChar->Update();
+		return pChar;
+	};
+
+	const CPointMap ptCenter(BENCHWORLD_MAP_SIZE / 2, BENCHWORLD_MAP_SIZE / 2, 0, 0);
+	_pCenterChar = CreateNPC(sm_BenchCharDefs[0], BenchWorld_GetRandomPoint(ptCenter, 16), 0);
+
+	_vSpawnPoints.reserve(BENCHWORLD_SPAWNS);
+	for ( int i = 0; i < BENCHWORLD_SPAWNS; ++i )
+	{
+		const CPointMap ptSpawn((i < BENCHWORLD_CITY_SPAWNS) ?
+			BenchWorld_GetRandomPoint(ptCenter, (BENCHWORLD_CITY_SIZE / 2) - BENCHWORLD_SPAWN_RANGE) :
+			BenchWorld_GetRandomPoint(CPointMap(), BENCHWORLD_SPAWN_RANGE + 1));
+		_vSpawnPoints.emplace_back(ptSpawn);
+		for ( int j = 0; j < BENCHWORLD_SPAWN_NPCS; ++j )
+			CreateNPC(sm_BenchCharDefs[j % CountOf(sm_BenchCharDefs)], ptSpawn, BENCHWORLD_SPAWN_RANGE);
+	}
+}
+
+bool CBenchWorld::Create()
+{
+	ADDTOCALLSTACK("CBenchWorld::Create");
+	g_Serv.SetServerMode(SERVMODE_Loading);
+	InitSettings();
+	InitTiledata();
+	InitMap();
+	InitDefs();
+	InitRegions();
+
+	// The objects created while loading wait for the UID of the world file: they need the server running.
+	g_World.InitUIDs();
+	g_Serv.SetServerMode(SERVMODE_Run);
+	CreateItems();
+	CreateChars();
+	return (_pCenterChar != nullptr);
+}
@@ -0,0 +1,73 @@
+/**
+* @file CBenchWorld.h
+* @brief Synthetic world for the standalone benchmarks, built in memory without the MUL files and the scripts.
+*/
+
+#ifndef _INC_CBENCHWORLD_H
+#define _INC_CBENCHWORLD_H
+
+#include "../common/CPointBase.h"
+#include <vector>
+
+class CChar;
+class CItemContainer;
+
+
+#define BENCHWORLD_MAP_SIZE			1024	// Map 0 only, square.
+#define BENCHWORLD_SECTOR_SIZE		64
+#define BENCHWORLD_SPAWNS			64		// Spawn points, the NPCs are crowded around them.
+#define BENCHWORLD_SPAWN_NPCS		40		// NPCs around each spawn point.
+#define BENCHWORLD_SPAWN_RANGE		8		// Distance of the NPCs from their spawn point (and wander distance).
+#define BENCHWORLD_GROUND_ITEMS		20000
+#define BENCHWORLD_CONTAINERS		1000	// Backpacks on the ground, each with a bag and resources inside.
+#define BENCHWORLD_REGIONS			128		// Small areas (towns, houses...) over the whole map area.
+#define BENCHWORLD_CITY_SIZE		128		// City in the middle of the map, crowded with houses (a room every 8 tiles).
+#define BENCHWORLD_CITY_SPAWNS		8		// Spawn points in the city, the first ones.
+
+class CBenchWorld
+{
+	// What a loaded server reads from the MUL files and the scripts is made up here: tiledata, terrain (grass with
+	//  some lakes), item and char definitions, DEFs, regions and client keys. Then the world is filled with items,
+	//  containers and NPCs, through the same calls the scripts use, so the benchmarks run on the real structures.
+private:
+	CChar * _pCenterChar;					// Middle of the map, the path finding starts from it.
+	std::vector<CPointMap> _vSpawnPoints;
+	std::vector<CItemContainer *> _vContainers;
+
+	void InitSettings();
+	void InitTiledata();
+	void InitMap();
+	void InitDefs();
+	void InitRegions();
+	void CreateItems();
+	void CreateChars();
+
+public:
+	CBenchWorld();
+	~CBenchWorld() = default;
+private:
+	CBenchWorld(const CBenchWorld& copy);
+	CBenchWorld& operator=(const CBenchWorld& other);
+
+public:
+	/**
+	* @brief Build the whole world. It must be done once, before anything else uses the world.
+	*/
+	bool Create();
+
+	CChar * GetCenterChar() const noexcept
+	{
+		return _pCenterChar;
+	}
+	const std::vector<CPointMap> & GetSpawnPoints() const noexcept
+	{
+		return _vSpawnPoints;
+	}
+	const std::vector<CItemContainer *> & GetContainers() const noexcept
+	{
+		return _vContainers;
+	}
+};
+
+
+#endif // _INC_CBENCHWORLD_H
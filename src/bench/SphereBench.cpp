@@ -0,0 +1,113 @@
+/**
+* @file SphereBench.cpp
+* @brief Benchmark program entry point: runs the BENCH benchmarks on a synthetic world, without MUL files, scripts or network.
+*/
+
+#include "../common/sphere_library/CSString.h"
+#include "../common/sphere_library/CSStringPool.h"
+#include "../common/sphere_library/CSTime.h"
+#include "../common/CLog.h"
+#include "../common/CTextConsole.h"
+#include "../game/chars/CChar.h"
+#include "../game/CServer.h"
+#include "../game/CServerBench.h"
+#include "../game/CWorld.h"
+#include "CBenchWorld.h"
+#include <cstdio>
+#include <cstring>
+
+
+class CBenchConsole : public CTextConsole
+{
+	// Prints to stdout. Its char is the one the path finding starts from.
+	CChar * _pChar;
+
+public:
+	explicit CBenchConsole( CChar * pChar ) : _pChar(pChar)
+	{
+	}
+
+	virtual PLEVEL_TYPE GetPrivLevel() const override
+	{
+		return PLEVEL_Owner;
+	}
+	virtual lpctstr GetName() const override
+	{
+		return "sphere_bench";
+	}
+	virtual CChar * GetChar() const override
+	{
+		return _pChar;
+	}
+	virtual void SysMessage( lpctstr pszMessage ) const override
+	{
+		fputs(pszMessage, stdout);
+	}
+};
+
+static void SphereBench_Usage()
+{
+	printf(
+		"Usage: sphere_bench [options]\n"
+		"Builds a synthetic world in memory and runs the benchmarks of the BENCH command on it,\n"
+		"then the ones changing it (creating and deleting objects, respawning NPCs...).\n"
+		"  -?, --help      Show this help.\n"
+		"  -o <file.csv>   Also write the results to this CSV file (benchmark,ops,total_us,ns_per_op).\n");
+}
+
+int _cdecl main( int argc, char * argv[] )
+{
+	lpctstr pszFileCSV = nullptr;
+	for ( int i = 1; i < argc; ++i )
+	{
+		if ( !strcmp(argv[i], "-?") || !strcmp(argv[i], "--help") )
+		{
+			SphereBench_Usage();
+			return 0;
+		}
+		if ( !strcmp(argv[i], "-o") && (i + 1 < argc) )
+		{
+			pszFileCSV = argv[++i];
+			continue;
+		}
+		fprintf(stderr, "Unknown option '%s'.\n", argv[i]);
+		SphereBench_Usage();
+		return 1;
+	}
+
+	printf("Building the synthetic world...\n");
+	llong iTimeStart = GetPreciseSysTimeMicro();
+	CBenchWorld world;
+	if ( !world.Create() )
+	{
+		fprintf(stderr, "The synthetic world could not be built.\n");
+		return 1;
+	}
+	printf("Done in %lld ms: %" PRIuSIZE_T " items, %" PRIuSIZE_T " chars.\n", (GetPreciseSysTimeMicro() - iTimeStart) / 1000,
+		g_Serv.StatGet(SERV_STAT_ITEMS), g_Serv.StatGet(SERV_STAT_CHARS));
+#ifdef DEBUG_STRINGS
+	printf("Strings: %u, heap memory=%" PRIuSIZE_T ", heap allocations=%u, reallocations=%u, pooled names=%" PRIuSIZE_T "\n",
+		gAmount, gMemAmount, gAllocs, gReallocs, CSStringPool::Get().GetCount());
+#endif
+
+	CBenchConsole console(world.GetCenterChar());
+	CServerBench bench;
+	iTimeStart = GetPreciseSysTimeMicro();
+	bench.Run(&console);
+	bench.RunWorldChanges(&console);	// Last, they change the world.
+	bench.Report(&console);
+	printf("Benchmarks done in %lld ms.\n", (GetPreciseSysTimeMicro() - iTimeStart) / 1000);
+
+	int iRet = 0;
+	if ( (pszFileCSV != nullptr) && !bench.DumpCSV(pszFileCSV) )
+	{
+		fprintf(stderr, "Can't write the results to '%s'.\n", pszFileCSV);
+		iRet = 1;
+	}
+
+	// Same cleanup of the server exit: the objects must be gone before the static ones are destroyed.
+	g_Serv.SetServerMode(SERVMODE_Exiting);
+	g_World.Close();
+	g_Log.Close();
+	return iRet;
+}
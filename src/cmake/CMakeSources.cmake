@@ -2,15 +2,21 @@
 SET (sphere_SRCS
 sphere/asyncdb.cpp
 sphere/asyncdb.h
+sphere/asynclog.cpp
+sphere/asynclog.h
 sphere/containers.h
 sphere/ConsoleInterface.cpp
 sphere/ConsoleInterface.h
 sphere/ProfileData.cpp
 sphere/ProfileData.h
+sphere/ProfileMetrics.cpp
+sphere/ProfileMetrics.h
 sphere/ProfileTask.cpp
 sphere/ProfileTask.h
 sphere/threads.cpp
 sphere/threads.h
+sphere/TickWatchdog.cpp
+sphere/TickWatchdog.h
 sphere/ntservice.cpp
 sphere/ntservice.h
 sphere/ntwindow.cpp
@@ -148,6 +154,8 @@ common/CScriptContexts.cpp
 common/CScriptContexts.h
 common/CScriptObj.cpp
 common/CScriptObj.h
+common/CScriptTextTemplate.cpp
+common/CScriptTextTemplate.h
 common/CScriptTriggerArgs.cpp
 common/CScriptTriggerArgs.h
 common/CSFileObj.cpp
@@ -230,6 +238,8 @@ common/sphere_library/CSFileList.cpp
 common/sphere_library/CSFileList.h
 common/sphere_library/CSFileText.cpp
 common/sphere_library/CSFileText.h
+common/sphere_library/CSIndexBitmap.cpp
+common/sphere_library/CSIndexBitmap.h
 common/sphere_library/CSMemBlock.cpp
 common/sphere_library/CSMemBlock.h
 common/sphere_library/CSObjArray.h
@@ -247,8 +257,12 @@ common/sphere_library/CSQueue.cpp
 common/sphere_library/CSQueue.h
 common/sphere_library/CSRand.cpp
 common/sphere_library/CSRand.h
+common/sphere_library/CSSlabPool.cpp
+common/sphere_library/CSSlabPool.h
 common/sphere_library/CSString.cpp
 common/sphere_library/CSString.h
+common/sphere_library/CSStringPool.cpp
+common/sphere_library/CSStringPool.h
 common/sphere_library/CSTime.cpp
 common/sphere_library/CSTime.h
 common/sphere_library/CSWindow.cpp
@@ -292,6 +306,7 @@ game/CRegion.h
 game/CRegionBase.cpp
 game/CRegionBase.h
 game/CResourceCalc.cpp
+game/CScriptProfiler.cpp
 game/CScriptProfiler.h
 game/CSector.cpp
 game/CSector.h
@@ -303,6 +318,8 @@ game/CSectorList.cpp
 game/CSectorList.h
 game/CServer.cpp
 game/CServer.h
+game/CServerBench.cpp
+game/CServerBench.h
 game/CServerConfig.cpp
 game/CServerConfig.h
 game/CServerDef.cpp
@@ -557,6 +574,27 @@ tables/triggers.tbl
 )
 SOURCE_GROUP (tables FILES ${tables_SRCS})
 
+# Load generator (sphereloadgen, a separate executable): headless clients measuring a running server
+SET (loadgen_SRCS
+loadgen/CLoadBot.cpp
+loadgen/CLoadBot.h
+loadgen/CLoadHuffman.cpp
+loadgen/CLoadHuffman.h
+loadgen/CLoadStats.cpp
+loadgen/CLoadStats.h
+loadgen/LoadGen.cpp
+loadgen/loadgen.h
+)
+SOURCE_GROUP (loadgen FILES ${loadgen_SRCS})
+
+# Benchmark program (sphere_bench, the server code with its own main): the BENCH benchmarks on a synthetic world
+SET (bench_SRCS
+bench/CBenchWorld.cpp
+bench/CBenchWorld.h
+bench/SphereBench.cpp
+)
+SOURCE_GROUP (bench FILES ${bench_SRCS})
+
 # Misc doc and *.ini files
 SET (docs_TEXT
 ../Changelog-X1-Nightlies.txt
@@ -382,6 +382,9 @@ int Calc_GetSCurve( int iValDiff, int iVariance )
 
 CExpression::CExpression()
 {
+	// Loaded once with the scripts and kept: their names are worth pooling.
+	m_VarResDefs.SetInternKeys();
+	m_VarDefs.SetInternKeys();
 }
 
 CExpression::~CExpression()
@@ -1,4 +1,5 @@
 
+#include "../sphere/asynclog.h"
 #include "../sphere/ProfileTask.h"
 #include "../game/CServer.h"
 #include "CException.h"
@@ -77,6 +78,7 @@ int CEventLog::EventEvent(lpctstr pszFormat, ...)
 CLog::CLog()
 {
 	m_fLockOpen = false;
+	m_fBatchOpen = false;
 	m_pScriptContext = nullptr;
 	m_pObjectContext = nullptr;
 	m_dwMsgMask = LOGL_ERROR | LOGM_INIT | LOGM_CLIENTS_LOG | LOGM_GM_PAGE;
@@ -217,34 +219,11 @@ int CLog::EventStr( dword dwMask, lpctstr pszMsg )
 
 	try
 	{
-        ConsoleTextColor iLogTextColor = CTCOL_DEFAULT;
-        ConsoleTextColor iLogTypeColor = CTCOL_DEFAULT;
-
 		// Put up the date/time.
 		CSTime datetime = CSTime::GetCurrentTime();	// last real time stamp.
 
 		tchar szTime[32];
 		snprintf(szTime, sizeof(szTime), "%02d:%02d:", datetime.GetHour(), datetime.GetMinute());
-		lpctstr pszLabel = nullptr;
-		switch (dwMask & LOGL_QTY)
-		{
-			case LOGL_FATAL:	// fatal error !
-				pszLabel = "FATAL:";
-                iLogTypeColor = CTCOL_RED;
-				break;
-			case LOGL_CRIT:		// critical.
-				pszLabel = "CRITICAL:";
-                iLogTypeColor = CTCOL_RED;
-				break;
-			case LOGL_ERROR:	// non-fatal errors.
-				pszLabel = "ERROR:";
-                iLogTypeColor = CTCOL_RED;
-				break;
-			case LOGL_WARN:
-                pszLabel = "WARNING:";
-                iLogTypeColor = CTCOL_RED;
-				break;
-		}
 
 		// Get the script context. (if there is one)
 		tchar szScriptContext[ _MAX_PATH + 16 ];
@@ -258,84 +237,144 @@ int CLog::EventStr( dword dwMask, lpctstr pszMsg )
             szScriptContext[0] = '\0';
         }
 
-		// Print to screen.
-		if ( !(dwMask & LOGF_LOGFILE_ONLY) )
+		const bool fConsoleTime = ( !(dwMask & LOGM_INIT) && !g_Serv.IsLoading() );
+
+		// The message is formatted here, the writer thread (if enabled) does the console output and the file append.
+		// Fatal and critical messages are written right away, after the pending ones, since we may be about to crash.
+		const LOG_TYPE iLevel = (LOG_TYPE)(dwMask & LOGL_QTY);
+		if ( g_asyncLog.isActive() && (iLevel != LOGL_FATAL) && (iLevel != LOGL_CRIT) )
 		{
-			if ( !(dwMask & LOGM_INIT) && !g_Serv.IsLoading() )
-			{
-				g_Serv.PrintStr(CTCOL_YELLOW, szTime );
-			}
+			if ( g_asyncLog.Push(dwMask, datetime, szTime, szScriptContext, pszMsg, fConsoleTime) )
+				return 1;
+		}
+		if ( g_asyncLog.isActive() )
+			g_asyncLog.Flush(LOGASYNC_FLUSH_TIMEOUT);
 
-			if ( pszLabel )	// some sort of error
-			{
-				g_Serv.PrintStr( iLogTypeColor, pszLabel );
-                if ((dwMask & 0x07) == LOGL_WARN)
-                {
-                    iLogTextColor = CTCOL_DEFAULT;
-                }
-                else
-                {
-                    iLogTextColor = CTCOL_WHITE;
-                }
-			}
-			else if ((dwMask & LOGM_DEBUG) && !(dwMask & LOGM_INIT))	// debug log
-			{
-				pszLabel = "DEBUG:";
-				g_Serv.PrintStr(CTCOL_MAGENTA, pszLabel);
-			}
+		OutputEvent(dwMask, datetime, szTime, szScriptContext, pszMsg, fConsoleTime);
+		iRet = 1;
+	}
+	catch (...)
+	{
+		// Not much we can do about this
+		iRet = 0;
+		CurrentProfileData.Count(PROFILE_STAT_FAULTS, 1);
+	}
 
-			if ( szScriptContext[0] )
-			{
-				g_Serv.PrintStr( CTCOL_CYAN, szScriptContext );
-			}
-			g_Serv.PrintStr( iLogTextColor, pszMsg );
-		}
+	return iRet;
+}
+
+void CLog::BeginEventBatch()
+{
+	THREAD_UNIQUE_LOCK_SET;
+	m_fBatchOpen = true;
+#ifndef _WIN32
+	_Close(); // The log file is opened for the first time by the OpenLog call done when reading the sphere.ini.
+	_Open(nullptr, OF_READWRITE|OF_TEXT|OF_SHARE_DENY_NONE);	// Keep it open for the whole batch instead of re-opening it for each line.
+#endif
+}
+
+void CLog::EndEventBatch()
+{
+	THREAD_UNIQUE_LOCK_SET;
+	m_fBatchOpen = false;
+#ifndef _WIN32
+	_Close();
+#endif
+}
+
+void CLog::OutputEvent( dword dwMask, const CSTime & datetime, lpctstr pszTime, lpctstr pszScriptContext, lpctstr pszMsg, bool fConsoleTime )
+{
+	ConsoleTextColor iLogTextColor = CTCOL_DEFAULT;
+	ConsoleTextColor iLogTypeColor = CTCOL_DEFAULT;
 
-		// Print to log file.
-		if ( !(dwMask & LOGF_CONSOLE_ONLY) )
+	lpctstr pszLabel = nullptr;
+	switch (dwMask & LOGL_QTY)
+	{
+		case LOGL_FATAL:	// fatal error !
+			pszLabel = "FATAL:";
+			iLogTypeColor = CTCOL_RED;
+			break;
+		case LOGL_CRIT:		// critical.
+			pszLabel = "CRITICAL:";
+			iLogTypeColor = CTCOL_RED;
+			break;
+		case LOGL_ERROR:	// non-fatal errors.
+			pszLabel = "ERROR:";
+			iLogTypeColor = CTCOL_RED;
+			break;
+		case LOGL_WARN:
+			pszLabel = "WARNING:";
+			iLogTypeColor = CTCOL_RED;
+			break;
+	}
+
+	// Print to screen.
+	if ( !(dwMask & LOGF_LOGFILE_ONLY) )
+	{
+		if ( fConsoleTime )
 		{
-			THREAD_UNIQUE_LOCK_SET;
+			g_Serv.PrintStr(CTCOL_YELLOW, pszTime );
+		}
 
-			if ( datetime.GetDay() != m_dateStamp.GetDay())
+		if ( pszLabel )	// some sort of error
+		{
+			g_Serv.PrintStr( iLogTypeColor, pszLabel );
+			if ((dwMask & 0x07) == LOGL_WARN)
 			{
-				// it's a new day, open a log file with new day name.
-				_Close();	// LINUX should alrady be closed.
-				_OpenLog();
-                _Printf("Log date: %s\n", m_dateStamp.Format(nullptr));
+				iLogTextColor = CTCOL_DEFAULT;
 			}
-#ifndef _WIN32
 			else
 			{
-                _Close(); // The log file is opened for the first time by the OpenLog call done when reading the sphere.ini.
-				const uint mode = OF_READWRITE|OF_TEXT|OF_SHARE_DENY_NONE;
-				_Open(nullptr, mode);	// LINUX needs to close and re-open for each log line !
+				iLogTextColor = CTCOL_WHITE;
 			}
-#endif
+		}
+		else if ((dwMask & LOGM_DEBUG) && !(dwMask & LOGM_INIT))	// debug log
+		{
+			pszLabel = "DEBUG:";
+			g_Serv.PrintStr(CTCOL_MAGENTA, pszLabel);
+		}
 
-			_WriteString( szTime );
-			if ( pszLabel )
-				_WriteString( pszLabel );
-			if ( szScriptContext[0] )
-				_WriteString( szScriptContext );
+		if ( pszScriptContext[0] )
+		{
+			g_Serv.PrintStr( CTCOL_CYAN, pszScriptContext );
+		}
+		g_Serv.PrintStr( iLogTextColor, pszMsg );
+	}
 
-			_WriteString( pszMsg );
+	// Print to log file.
+	if ( !(dwMask & LOGF_CONSOLE_ONLY) )
+	{
+		THREAD_UNIQUE_LOCK_SET;
 
+		if ( datetime.GetDay() != m_dateStamp.GetDay())
+		{
+			// it's a new day, open a log file with new day name.
+			_Close();	// LINUX should alrady be closed.
+			_OpenLog();
+			_Printf("Log date: %s\n", m_dateStamp.Format(nullptr));
+		}
 #ifndef _WIN32
-			_Close();
-#endif
+		else if ( !m_fBatchOpen )
+		{
+			_Close(); // The log file is opened for the first time by the OpenLog call done when reading the sphere.ini.
+			const uint mode = OF_READWRITE|OF_TEXT|OF_SHARE_DENY_NONE;
+			_Open(nullptr, mode);	// LINUX needs to close and re-open for each log line !
 		}
+#endif
 
-		iRet = 1;
+		_WriteString( pszTime );
+		if ( pszLabel )
+			_WriteString( pszLabel );
+		if ( pszScriptContext[0] )
+			_WriteString( pszScriptContext );
 
-	}
-	catch (...)
-	{
-		// Not much we can do about this
-		iRet = 0;
-		CurrentProfileData.Count(PROFILE_STAT_FAULTS, 1);
-	}
+		_WriteString( pszMsg );
 
-	return iRet;
+#ifndef _WIN32
+		if ( !m_fBatchOpen )
+			_Close();
+#endif
+	}
 }
 
 
@@ -94,6 +94,8 @@ private:
 
 	static CSTime sm_prevCatchTick;			// don't flood with these.
 
+	bool m_fBatchOpen;			// The log file is kept open by the async log writer while writing a batch of messages.
+
 public:
 	bool m_fLockOpen;
 
@@ -118,6 +120,11 @@ public:		bool OpenLog(lpctstr pszName = nullptr);
 	bool IsLogged( dword dwMask ) const;
 
 	virtual int EventStr( dword dwMask, lpctstr pszMsg );
+
+	// Write an already formatted message to the console and to the log file. Called directly by EventStr or by the async log writer thread.
+	void OutputEvent( dword dwMask, const CSTime & datetime, lpctstr pszTime, lpctstr pszScriptContext, lpctstr pszMsg, bool fConsoleTime );
+	void BeginEventBatch();
+	void EndEventBatch();
 	void _cdecl CatchEvent( const CSError * pErr, lpctstr pszCatchContext, ...  ) __printfargs(3,4);
     void _cdecl CatchStdException( const std::exception * pExc, lpctstr pszCatchContext, ...  ) __printfargs(3,4);
 
@@ -16,6 +16,7 @@
 #include "../game/CWorldMap.h"
 #include "../game/CTimedFunctions.h"
 #include "../sphere/ProfileTask.h"
+#include "../sphere/TickWatchdog.h"
 #include "crypto/CBCrypt.h"
 #include "crypto/CMD5.h"
 #include "resource/sections/CResourceNamedDef.h"
@@ -23,6 +24,7 @@
 #include "CFloatMath.h"
 #include "CExpression.h"
 #include "CSFileObjContainer.h"
+#include "CScriptTextTemplate.h"
 #include "CScriptTriggerArgs.h"
 
 class CStoneMember;
@@ -55,13 +57,14 @@ static lpctstr const _ptcSRefKeys[SREF_QTY+1] =
     "UID",
     nullptr
 };
+static const CKeyTableIndex _kiSRefKeys(_ptcSRefKeys, CountOf(_ptcSRefKeys)-1);
 
 bool CScriptObj::r_GetRef( lpctstr & ptcKey, CScriptObj * & pRef )
 {
 	ADDTOCALLSTACK("CScriptObj::r_GetRef");
 	// A key name that just links to another object.
 
-    int index = FindTableHeadSorted(ptcKey, _ptcSRefKeys, CountOf(_ptcSRefKeys)-1);
+    int index = _kiSRefKeys.FindHead(ptcKey);
     switch (index)
     {
         case SREF_SERV:
@@ -141,6 +144,7 @@ lpctstr const CScriptObj::sm_szLoadKeys[SSC_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CScriptObj::sm_LoadKeysIndex(CScriptObj::sm_szLoadKeys, CountOf(CScriptObj::sm_szLoadKeys)-1);
 
 size_t CScriptObj::r_GetFunctionIndex(lpctstr pszFunction) // static
 {
@@ -169,6 +173,13 @@ bool CScriptObj::r_Call( lpctstr pszFunction, CTextConsole * pSrc, CScriptTrigge
     return r_Call(index, pSrc, pArgs, psVal, piRet);
 }
 
+static dword GetScriptObjUID( const CScriptObj * pObj )
+{
+	// UID of the world object running the script, for the slow tick log.
+	const CObjBase * pObjBase = dynamic_cast<const CObjBase *>(pObj);
+	return pObjBase ? pObjBase->GetUID().GetObjUID() : 0;
+}
+
 bool CScriptObj::r_Call( size_t uiFunctionIndex, CTextConsole * pSrc, CScriptTriggerArgs * pArgs, CSString * psVal, TRIGRET_TYPE * piRet )
 {
     ADDTOCALLSTACK("CScriptObj::r_Call (FunctionIndex)");
@@ -179,66 +190,17 @@ bool CScriptObj::r_Call( size_t uiFunctionIndex, CTextConsole * pSrc, CScriptTri
     CResourceLock sFunction;
     if ( pFunction->ResourceLock(sFunction) )
     {
-        CScriptProfiler::CScriptProfilerFunction *pFun = nullptr;
-        TIME_PROFILE_INIT;
-
-        //	If functions profiler is on, search this function record and get pointer to it
-        //	if not, create the corresponding record
+        const TickWatchdogUnit watchdogUnit(TICKUNIT_FUNCTION, CTickWatchdog::IsRecording() ? GetScriptObjUID(this) : 0, pFunction->GetName());
+        TRIGRET_TYPE iRet;
         if ( IsSetEF(EF_Script_Profiler) )
         {
-            char *pName = Str_GetTemp();
-            char *pSpace;
-
-            //	lowercase for speed, and strip arguments
-            Str_CopyLimitNull(pName, pFunction->GetName(), STR_TEMPLENGTH);
-            if ( (pSpace = strchr(pName, ' ')) != nullptr )
-                *pSpace = 0;
-            _strlwr(pName);
-
-            if ( g_profiler.initstate != 0xf1 )	// it is not initalised
-            {
-                memset(&g_profiler, 0, sizeof(g_profiler));
-                g_profiler.initstate = (uchar)(0xf1); // ''
-            }
-            for ( pFun = g_profiler.FunctionsHead; pFun != nullptr; pFun = pFun->next )
-            {
-                if ( !strcmp(pFun->name, pName) )
-                    break;
-            }
-
-            // first time function called. so create a record for it
-            if ( pFun == nullptr )
-            {
-                pFun = new CScriptProfiler::CScriptProfilerFunction;
-                memset(pFun, 0, sizeof(CScriptProfiler::CScriptProfilerFunction));
-                Str_CopyLimitNull(pFun->name, pName, sizeof(CScriptProfiler::CScriptProfilerFunction::name));
-                if ( g_profiler.FunctionsTail )
-                    g_profiler.FunctionsTail->next = pFun;
-                else
-                    g_profiler.FunctionsHead = pFun;
-                g_profiler.FunctionsTail = pFun;
-            }
-
-            //	prepare the informational block
-            ++pFun->called;
-            ++g_profiler.called;
-            TIME_PROFILE_START;
+            //	Time the function, by name and by the script line it begins at
+            const CScriptProfilerSample profilerSample(g_profiler.GetFunction(pFunction->GetName()), g_profiler.GetLine(sFunction));
+            iRet = OnTriggerRun(sFunction, TRIGRUN_SECTION_TRUE, pSrc, pArgs, psVal);
         }
-
-        TRIGRET_TYPE iRet = OnTriggerRun(sFunction, TRIGRUN_SECTION_TRUE, pSrc, pArgs, psVal);
-
-        if ( IsSetEF(EF_Script_Profiler) )
+        else
         {
-            //	update the time call information
-            TIME_PROFILE_END;
-            llTicksStart = llTicksEnd - llTicksStart;
-            pFun->total += llTicksStart;
-            pFun->average = (pFun->total / pFun->called);
-            if ( pFun->max < llTicksStart )
-                pFun->max = llTicksStart;
-            if (( pFun->min > llTicksStart ) || ( !pFun->min ))
-                pFun->min = llTicksStart;
-            g_profiler.total += llTicksStart;
+            iRet = OnTriggerRun(sFunction, TRIGRUN_SECTION_TRUE, pSrc, pArgs, psVal);
         }
 
         if ( piRet )
@@ -269,7 +231,7 @@ bool CScriptObj::r_LoadVal( CScript & s )
 	}
 
 	// ignore these.
-	int index = FindTableHeadSorted(ptcKey, sm_szLoadKeys, CountOf(sm_szLoadKeys)-1);
+	int index = sm_LoadKeysIndex.FindHead(ptcKey);
 	if ( index < 0 )
 	{
 		DEBUG_ERR(("Undefined keyword '%s'\n", s.GetKey()));
@@ -445,7 +407,7 @@ bool CScriptObj::r_WriteVal( lpctstr ptcKey, CSString &sVal, CTextConsole * pSrc
         return false;
     }
 
-	int index = FindTableHeadSorted( ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 );
+	int index = sm_LoadKeysIndex.FindHead(ptcKey);
 	if ( index < 0 )
 	{
 		// <dSOMEVAL> same as <eval <SOMEVAL>> to get dec from the val
@@ -1115,6 +1077,7 @@ lpctstr const CScriptObj::sm_szVerbKeys[SSV_QTY+1] =
 	"SHOW",
 	nullptr
 };
+const CKeyTableIndex CScriptObj::sm_VerbKeysIndex(CScriptObj::sm_szVerbKeys, CountOf(CScriptObj::sm_szVerbKeys)-1);
 
 
 bool CScriptObj::r_Verb( CScript & s, CTextConsole * pSrc ) // Execute command from script
@@ -1175,7 +1138,7 @@ bool CScriptObj::r_Verb( CScript & s, CTextConsole * pSrc ) // Execute command f
 		return pRef->r_Verb(script, pSrc);
 	}
 
-	index = FindTableSorted( s.GetKey(), sm_szVerbKeys, CountOf( sm_szVerbKeys )-1 );
+	index = sm_VerbKeysIndex.Find(s.GetKey());
 
 	switch (index)
 	{
@@ -1401,6 +1364,15 @@ size_t CScriptObj::ParseText( tchar * pszResponse, CTextConsole * pSrc, int iFla
 	static int sm_iReentrant = 0;
 	static bool sm_fBrackets = false;	// allowed to span multi lines.
 
+	if ( (iFlags == 0) && IsSetEF(EF_ParseTextCache) )
+	{
+		if ( strchr(pszResponse, '<') == nullptr )
+			return strlen(pszResponse);
+		const std::shared_ptr<const CScriptTextTemplate> pTemplate = CScriptTextTemplate::Get(pszResponse);
+		if ( pTemplate->IsValid() )
+			return ParseTextTemplate(*pTemplate, pszResponse, pSrc, pArgs);
+	}
+
 	//***Qval Fix***
 	bool fQvalCondition = false;
 	const tchar chQval = '?';
@@ -1515,6 +1487,76 @@ size_t CScriptObj::ParseText( tchar * pszResponse, CTextConsole * pSrc, int iFla
 	return i;
 }
 
+size_t CScriptObj::ParseTextTemplate( const CScriptTextTemplate & textTemplate, tchar * pszResponse, CTextConsole * pSrc, CScriptTriggerArgs * pArgs )
+{
+	ADDTOCALLSTACK("CScriptObj::ParseTextTemplate");
+	// Same result of ParseText, but the brackets were already found: build the keys from the literal text
+	// and the nested values, resolve them, and write the line once.
+	// RETURN:
+	//  New length of the string.
+
+	lpctstr pszText = textTemplate.GetText().c_str();
+	std::string sKeys[SCRIPTTEMPLATE_MAX_DEPTH + 1];	// Keys being built for each nesting level (the level 0 goes straight to pszResponse).
+	int iDepth = 0;
+	size_t uiLength = 0;
+
+	EXC_TRY("ParseTextTemplate");
+	for ( const CScriptTextTemplate::Op & op : textTemplate.GetOps() )
+	{
+		switch ( op.type )
+		{
+			case CScriptTextTemplate::OP_TEXT:
+				if ( iDepth == 0 )
+				{
+					memcpy(pszResponse + uiLength, pszText + op.uiOffset, op.uiLength);
+					uiLength += op.uiLength;
+				}
+				else
+					sKeys[iDepth].append(pszText + op.uiOffset, op.uiLength);
+				break;
+
+			case CScriptTextTemplate::OP_OPEN:
+				++iDepth;
+				sKeys[iDepth].clear();
+				break;
+
+			case CScriptTextTemplate::OP_CLOSE:
+			{
+				CSString sVal;
+				lpctstr ptcKey = sKeys[iDepth].c_str();
+
+				EXC_SET_BLOCK("writeval");
+				bool fRes = r_WriteVal( ptcKey, sVal, pSrc );
+				if ( fRes == false )
+				{
+					// write the value of functions or triggers variables/objects like ARGO, ARGN1/2/3, LOCALs...
+					if ( pArgs != nullptr && pArgs->r_WriteVal( ptcKey, sVal, pSrc ) )
+						fRes = true;
+				}
+				if ( fRes == false )
+					DEBUG_ERR(( "Can't resolve <%s>\n", ptcKey ));
+
+				--iDepth;
+				if ( iDepth == 0 )
+				{
+					memcpy(pszResponse + uiLength, sVal.GetPtr(), sVal.GetLength());
+					uiLength += sVal.GetLength();
+				}
+				else
+					sKeys[iDepth].append(sVal.GetPtr(), sVal.GetLength());
+				break;
+			}
+		}
+	}
+	EXC_CATCH;
+
+	EXC_DEBUG_START;
+	g_Log.EventDebug("template '%s' source addr '0%p' args '%p'\n", pszText, static_cast<void *>(pSrc), static_cast<void *>(pArgs));
+	EXC_DEBUG_END;
+	pszResponse[uiLength] = '\0';
+	return uiLength;
+}
+
 
 TRIGRET_TYPE CScriptObj::OnTriggerForLoop( CScript &s, int iType, CTextConsole * pSrc, CScriptTriggerArgs * pArgs, CSString * pResult )
 {
@@ -1882,67 +1924,21 @@ TRIGRET_TYPE CScriptObj::OnTriggerScript( CScript & s, lpctstr pszTrigName, CTex
 
 	const ProfileTask scriptsTask(PROFILE_SCRIPTS);
 
-	CScriptProfiler::CScriptProfilerTrigger	*pTrig = nullptr;
-	TIME_PROFILE_INIT;
-
-	//	If script profiler is on, search this trigger record and get pointer to it
-	//	if not, create the corresponding record
+	//	If script profiler is on, time the trigger by name, by the resource section (ITEMDEF, CHARDEF, EVENTS...)
+	//	it was found in and by the script line of its ON=@ header
+	std::optional<CScriptProfilerSample> profilerSample;
 	if ( IsSetEF(EF_Script_Profiler) )
 	{
-		tchar * pName = Str_GetTemp();
-
-		//	lowercase for speed
-		strcpy(pName, pszTrigName);
-		_strlwr(pName);
-
-		if ( g_profiler.initstate != 0xf1 )	// it is not initalised
-		{
-			memset(&g_profiler, 0, sizeof(g_profiler));
-			g_profiler.initstate = (uchar)(0xf1); // ''
-		}
-
-		for ( pTrig = g_profiler.TriggersHead; pTrig != nullptr; pTrig = pTrig->next )
-		{
-			if ( !strcmp(pTrig->name, pName) )
-				break;
-		}
-
-		// first time this trigger is called. so create a record for it
-		if ( pTrig == nullptr )
-		{
-			pTrig = new CScriptProfiler::CScriptProfilerTrigger;
-			memset(pTrig, 0, sizeof(CScriptProfiler::CScriptProfilerTrigger));
-			Str_CopyLimitNull(pTrig->name, pName, sizeof(pTrig->name));
-			if ( g_profiler.TriggersTail )
-				g_profiler.TriggersTail->next = pTrig;
-			else
-				g_profiler.TriggersHead = pTrig;
-			g_profiler.TriggersTail = pTrig;
-		}
-
-		//	prepare the informational block
-		++ pTrig->called;
-		++ g_profiler.called;
-		TIME_PROFILE_START;
-	}
-
-	TRIGRET_TYPE iRet = OnTriggerRunVal(s, TRIGRUN_SECTION_TRUE, pSrc, pArgs);
-
-	if ( IsSetEF(EF_Script_Profiler) && pTrig != nullptr )
-	{
-		//	update the time call information
-		TIME_PROFILE_END;
-		llTicksStart = llTicksEnd - llTicksStart;
-		pTrig->total += llTicksStart;
-		pTrig->average = (pTrig->total/pTrig->called);
-		if ( pTrig->max < llTicksStart )
-			pTrig->max = llTicksStart;
-		if (( pTrig->min > llTicksStart ) || ( !pTrig->min ))
-			pTrig->min = llTicksStart;
-		g_profiler.total += llTicksStart;
+		const CResourceLock * pResourceLock = dynamic_cast<const CResourceLock *>(&s);
+		profilerSample.emplace(
+			g_profiler.GetTrigger(pszTrigName),
+			g_profiler.GetResource(pResourceLock ? pResourceLock->GetResourceLink() : nullptr),
+			g_profiler.GetLine(s));
 	}
 
-	return iRet;
+	const TickWatchdogUnit watchdogUnit(TICKUNIT_TRIGGER, CTickWatchdog::IsRecording() ? GetScriptObjUID(this) : 0, pszTrigName);
+	const TemporaryBufferScope tempBufferScope(IsSetEF(EF_TempBufferScopes));
+	return OnTriggerRunVal(s, TRIGRUN_SECTION_TRUE, pSrc, pArgs);
 }
 
 TRIGRET_TYPE CScriptObj::OnTrigger( lpctstr pszTrigName, CTextConsole * pSrc, CScriptTriggerArgs * pArgs)
@@ -2027,6 +2023,7 @@ lpctstr const CScriptObj::sm_szScriptKeys[SK_QTY+1] =
 	"WHILE",
 	nullptr
 };
+const CKeyTableIndex CScriptObj::sm_ScriptKeysIndex(CScriptObj::sm_szScriptKeys, CountOf(CScriptObj::sm_szScriptKeys)-1);
 
 
 TRIGRET_TYPE CScriptObj::OnTriggerRun( CScript &s, TRIGRUN_TYPE trigrun, CTextConsole * pSrc, CScriptTriggerArgs * pArgs, CSString * pResult )
@@ -2065,7 +2062,7 @@ TRIGRET_TYPE CScriptObj::OnTriggerRun( CScript &s, TRIGRUN_TYPE trigrun, CTextCo
 			break;
 
 jump_in:
-		SK_TYPE iCmd = (SK_TYPE) FindTableSorted( s.GetKey(), sm_szScriptKeys, CountOf( sm_szScriptKeys )-1 );
+		SK_TYPE iCmd = (SK_TYPE) sm_ScriptKeysIndex.Find(s.GetKey());
 		TRIGRET_TYPE iRet = TRIGRET_RET_DEFAULT;
 
 		switch ( iCmd )
@@ -14,6 +14,8 @@ class CSFileText;
 class CSString;
 class CChar;
 class CScriptTriggerArgs;
+class CKeyTableIndex;
+class CScriptTextTemplate;
 
 
 enum TRIGRUN_TYPE
@@ -46,11 +48,15 @@ class CScriptObj
 	// This object can be scripted. (but might not be)
 
 	static lpctstr const sm_szScriptKeys[];
+	static const CKeyTableIndex sm_ScriptKeysIndex;
 	static lpctstr const sm_szLoadKeys[];
+	static const CKeyTableIndex sm_LoadKeysIndex;
 	static lpctstr const sm_szVerbKeys[];
+	static const CKeyTableIndex sm_VerbKeysIndex;
 
 private:
 	TRIGRET_TYPE OnTriggerForLoop( CScript &s, int iType, CTextConsole * pSrc, CScriptTriggerArgs * pArgs, CSString * pResult );
+	size_t ParseTextTemplate( const CScriptTextTemplate & textTemplate, tchar * pszResponse, CTextConsole * pSrc, CScriptTriggerArgs * pArgs );
 
 public:
 	static const char *m_sClassName;
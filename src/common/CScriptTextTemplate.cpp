@@ -0,0 +1,104 @@
+#include "sphere_library/sstring.h"
+#include "CScriptTextTemplate.h"
+
+typedef std::unordered_map<std::string_view, std::shared_ptr<const CScriptTextTemplate>> ScriptTextTemplateMap;
+
+// Each thread has its own cache, keyed by the text owned by the template.
+static thread_local ScriptTextTemplateMap sm_mapTemplates;
+
+
+CScriptTextTemplate::CScriptTextTemplate( lpctstr pszText ) :
+	_sText(pszText), _fValid(true)
+{
+	// Same scan of CScriptObj::ParseText (without the HTML mode), but nothing is resolved.
+	bool fQvalCondition = false;	// Like in ParseText, it's not reset between the brackets of the line.
+	size_t uiTextStart = 0;
+	size_t i = 0;
+	for ( ; i < _sText.size(); ++i )
+	{
+		if ( _sText[i] != '<' )
+			continue;
+		if ( !( IsAlnum( _sText[i + 1] ) || _sText[i + 1] == '<' ) ) // ignore this.
+			continue;
+
+		_AddText(uiTextStart, i - uiTextStart);
+		size_t uiEnd = 0;
+		if ( !_CompileBracket(i, fQvalCondition, 1, uiEnd) )
+		{
+			_fValid = false;
+			_vOps.clear();
+			return;
+		}
+		i = uiEnd;
+		uiTextStart = uiEnd + 1;
+	}
+	_AddText(uiTextStart, i - uiTextStart);
+}
+
+void CScriptTextTemplate::_AddText( size_t uiOffset, size_t uiLength )
+{
+	if ( uiLength == 0 )
+		return;
+	_vOps.push_back({ OP_TEXT, (uint)uiOffset, (uint)uiLength });
+}
+
+bool CScriptTextTemplate::_CompileBracket( size_t uiBegin, bool & fQvalCondition, int iDepth, size_t & uiEnd )
+{
+	if ( iDepth > SCRIPTTEMPLATE_MAX_DEPTH )
+		return false;
+
+	_vOps.push_back({ OP_OPEN, 0, 0 });
+	const bool fQval = !strnicmp(_sText.c_str() + uiBegin + 1, "QVAL", 4);
+	size_t uiTextStart = uiBegin + 1;
+	for ( size_t i = uiBegin + 1; i < _sText.size(); ++i )
+	{
+		const tchar ch = _sText[i];
+		if ( ch == '<' )	// recursive brackets
+		{
+			if ( !( IsAlnum( _sText[i + 1] ) || _sText[i + 1] == '<' ) ) // ignore this.
+				continue;
+			// ParseText looks for QVAL in the text after the '<' as it is when it finds a '?' or the '>':
+			// a substitution in the first 4 chars would make it depend on the value.
+			if ( i <= uiBegin + 4 )
+				return false;
+
+			_AddText(uiTextStart, i - uiTextStart);
+			bool fNestedQvalCondition = false;
+			size_t uiNestedEnd = 0;
+			if ( !_CompileBracket(i, fNestedQvalCondition, iDepth + 1, uiNestedEnd) )
+				return false;
+			i = uiNestedEnd;
+			uiTextStart = i + 1;
+			continue;
+		}
+
+		if ( (ch == '?') && fQval )
+			fQvalCondition = true;
+
+		if ( ch == '>' )
+		{
+			if ( fQval && !fQvalCondition )
+				continue;
+			_AddText(uiTextStart, i - uiTextStart);
+			_vOps.push_back({ OP_CLOSE, 0, 0 });
+			uiEnd = i;
+			return true;
+		}
+	}
+	return false;	// Not closed: the old way will handle it.
+}
+
+std::shared_ptr<const CScriptTextTemplate> CScriptTextTemplate::Get( lpctstr pszText )
+{
+	ScriptTextTemplateMap::const_iterator it = sm_mapTemplates.find(std::string_view(pszText));
+	if ( it != sm_mapTemplates.end() )
+		return it->second;
+
+	// Text built at runtime (or given by the console) may never be seen again: don't let them pile up.
+	if ( sm_mapTemplates.size() >= SCRIPTTEMPLATE_CACHE_MAX )
+		sm_mapTemplates.clear();
+
+	std::shared_ptr<const CScriptTextTemplate> pTemplate = std::make_shared<const CScriptTextTemplate>(pszText);
+	sm_mapTemplates.emplace(std::string_view(pTemplate->GetText()), pTemplate);
+	return pTemplate;
+}
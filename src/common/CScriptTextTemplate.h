@@ -0,0 +1,75 @@
+/**
+* @file CScriptTextTemplate.h
+* @brief Pre-parsed <...> substitutions of the script lines, for CScriptObj::ParseText.
+*/
+
+#ifndef _INC_CSCRIPTTEXTTEMPLATE_H
+#define _INC_CSCRIPTTEXTTEMPLATE_H
+
+#include "common.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#define SCRIPTTEMPLATE_MAX_DEPTH	8		// Lines with more nested brackets are parsed the old way.
+#define SCRIPTTEMPLATE_CACHE_MAX	4096	// The cache is emptied when it holds this many lines.
+
+
+class CScriptTextTemplate
+{
+	// The bracket structure of a line, as found by the ParseText scan: the literal text between the brackets
+	// and where each substitution begins and ends. Since the substituted values are never scanned again,
+	// the structure only depends on the original text and can be reused every time the same text is parsed.
+public:
+	enum OP_TYPE : uchar
+	{
+		OP_TEXT,	// Append the literal text at uiOffset, uiLength chars long.
+		OP_OPEN,	// Begin the key of a substitution.
+		OP_CLOSE	// Resolve the key and append its value to the enclosing key (or the result).
+	};
+	struct Op
+	{
+		OP_TYPE type;
+		uint uiOffset;
+		uint uiLength;
+	};
+
+private:
+	std::string _sText;		// Original text, also the key of the cache.
+	std::vector<Op> _vOps;
+	bool _fValid;			// False if the line can't be pre-parsed (unclosed or too deep brackets...).
+
+public:
+	explicit CScriptTextTemplate( lpctstr pszText );
+	~CScriptTextTemplate() = default;
+private:
+	CScriptTextTemplate(const CScriptTextTemplate& copy);
+	CScriptTextTemplate& operator=(const CScriptTextTemplate& other);
+
+private:
+	void _AddText( size_t uiOffset, size_t uiLength );
+	bool _CompileBracket( size_t uiBegin, bool & fQvalCondition, int iDepth, size_t & uiEnd );
+
+public:
+	bool IsValid() const noexcept
+	{
+		return _fValid;
+	}
+	const std::string & GetText() const noexcept
+	{
+		return _sText;
+	}
+	const std::vector<Op> & GetOps() const noexcept
+	{
+		return _vOps;
+	}
+
+	// Template of a text parsed by the current thread, built on first use. Shared, since the cache may be
+	// emptied by a nested ParseText while the caller still resolves the values.
+	static std::shared_ptr<const CScriptTextTemplate> Get( lpctstr pszText );
+};
+
+
+#endif // _INC_CSCRIPTTEXTTEMPLATE_H
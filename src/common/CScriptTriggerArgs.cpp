@@ -192,6 +192,7 @@ lpctstr const CScriptTriggerArgs::sm_szLoadKeys[AGC_QTY+1] =
     "TRYSRV",
     nullptr
 };
+const CKeyTableIndex CScriptTriggerArgs::sm_LoadKeysIndex(CScriptTriggerArgs::sm_szLoadKeys, CountOf(CScriptTriggerArgs::sm_szLoadKeys)-1);
 
 
 bool CScriptTriggerArgs::r_Verb( CScript & s, CTextConsole * pSrc )
@@ -262,7 +263,7 @@ bool CScriptTriggerArgs::r_Verb( CScript & s, CTextConsole * pSrc )
         }
     }
     else
-        index = FindTableSorted( s.GetKey(), sm_szLoadKeys, CountOf(sm_szLoadKeys)-1 );
+        index = sm_LoadKeysIndex.Find(s.GetKey());
 
     switch (index)
     {
@@ -448,7 +449,7 @@ bool CScriptTriggerArgs::r_WriteVal( lpctstr ptcKey, CSString &sVal, CTextConsol
     }
 
     EXC_SET_BLOCK("generic");
-    int index = FindTableSorted( ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 );
+    int index = sm_LoadKeysIndex.Find(ptcKey);
     switch (index)
     {
         case AGC_N:
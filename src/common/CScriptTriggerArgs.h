@@ -14,6 +14,7 @@ class CScriptTriggerArgs : public CScriptObj
 {
     // All the args an event will need.
     static lpctstr const sm_szLoadKeys[];
+    static const CKeyTableIndex sm_LoadKeysIndex;
 
 public:
     static const char *m_sClassName;
@@ -529,6 +529,14 @@ CServerMapBlock::CServerMapBlock(int bx, int by, int map) :
 	Load( bx, by );
 }
 
+CServerMapBlock::CServerMapBlock(int bx, int by, int map, const CUOMapBlock & terrain) :
+		CPointSort((short)(bx)* UO_BLOCK_SIZE, (short)(by) * UO_BLOCK_SIZE, 0, (uchar)map)
+{
+	++sm_iCount;
+	memcpy( &m_Terrain, &terrain, sizeof(CUOMapBlock) );
+	m_CacheTime.HitCacheTime();
+}
+
 CServerMapBlock::~CServerMapBlock()
 {
 	--sm_iCount;
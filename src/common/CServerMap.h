@@ -187,6 +187,7 @@ private:
 
 public:
 	CServerMapBlock(int bx, int by, int map);
+	CServerMapBlock(int bx, int by, int map, const CUOMapBlock & terrain);	// Given terrain and no statics, nothing is read from the MUL files.
 	virtual ~CServerMapBlock();
 
 private:
@@ -21,11 +21,11 @@ inline static int VarDefCompare(const CVarDefCont* pVar, lpctstr ptcKey)
 *
 ***************************************************************************/
 
-CVarDefContNum::CVarDefContNum( lpctstr ptcKey, int64 iVal ) : m_sKey( ptcKey ), m_iVal( iVal )
+CVarDefContNum::CVarDefContNum( lpctstr ptcKey, int64 iVal, bool fInternKey ) : m_sKey( ptcKey, fInternKey ), m_iVal( iVal )
 {
 }
 
-CVarDefContNum::CVarDefContNum( lpctstr ptcKey ) : m_sKey( ptcKey ), m_iVal( 0 )
+CVarDefContNum::CVarDefContNum( lpctstr ptcKey ) : m_sKey( ptcKey, false ), m_iVal( 0 )
 {
 }
 
@@ -48,9 +48,9 @@ bool CVarDefContNum::r_WriteVal( lpctstr pKey, CSString & sVal, CTextConsole * p
 	return true;
 }
 
-CVarDefCont * CVarDefContNum::CopySelf() const
+CVarDefCont * CVarDefContNum::CopySelf( bool fInternKey ) const
 { 
-	return new CVarDefContNum( GetKey(), m_iVal );
+	return new CVarDefContNum( GetKey(), m_iVal, fInternKey );
 }
 
 /***************************************************************************
@@ -61,11 +61,11 @@ CVarDefCont * CVarDefContNum::CopySelf() const
 *
 ***************************************************************************/
 
-CVarDefContStr::CVarDefContStr( lpctstr ptcKey, lpctstr pszVal ) : m_sKey( ptcKey ), m_sVal( pszVal ) 
+CVarDefContStr::CVarDefContStr( lpctstr ptcKey, lpctstr pszVal, bool fInternKey ) : m_sKey( ptcKey, fInternKey ), m_sVal( pszVal ) 
 {
 }
 
-CVarDefContStr::CVarDefContStr( lpctstr ptcKey ) : m_sKey( ptcKey )
+CVarDefContStr::CVarDefContStr( lpctstr ptcKey ) : m_sKey( ptcKey, false )
 {
 }
 
@@ -98,9 +98,9 @@ bool CVarDefContStr::r_WriteVal( lpctstr pKey, CSString & sVal, CTextConsole * p
 	return true;
 }
 
-CVarDefCont * CVarDefContStr::CopySelf() const 
+CVarDefCont * CVarDefContStr::CopySelf( bool fInternKey ) const 
 { 
-	return new CVarDefContStr( GetKey(), m_sVal ); 
+	return new CVarDefContStr( GetKey(), m_sVal, fInternKey ); 
 }
 
 
@@ -169,6 +169,8 @@ CVarDefCont * CVarDefMap::GetAt( size_t at ) const
 CVarDefCont * CVarDefMap::GetAtKey( lpctstr ptcKey ) const
 {
 	ADDTOCALLSTACK_INTENSIVE("CVarDefMap::GetAtKey");
+	if ( _pFrozen )
+		return FrozenFind(ptcKey);
     const size_t idx = m_Container.find_predicate(ptcKey, VarDefCompare);
 
 	if ( idx != SCONT_BADINDEX )
@@ -184,6 +186,8 @@ void CVarDefMap::DeleteAt( size_t at )
 
     CVarDefCont *pVarBase = m_Container[at];
     m_Container.erase(m_Container.begin() + at);
+	if ( _pFrozen )
+		FrozenDelete(pVarBase);
 
     if ( pVarBase )
     {
@@ -219,6 +223,7 @@ void CVarDefMap::DeleteKey( lpctstr key )
 void CVarDefMap::Clear()
 {
 	ADDTOCALLSTACK_INTENSIVE("CVarDefMap::Empty");
+	_pFrozen.reset();
 	iterator it = m_Container.begin();
 	while ( it != m_Container.end() )
 	{
@@ -242,7 +247,7 @@ void CVarDefMap::Copy( const CVarDefMap * pArray )
 
     for (const CVarDefCont* pVar : pArray->m_Container)
 	{
-		m_Container.insert( pVar->CopySelf() );
+		m_Container.insert( pVar->CopySelf(_fInternKeys) );
 	}
 }
 
@@ -308,16 +313,70 @@ size_t CVarDefMap::GetCount() const
 	return m_Container.size();
 }
 
+void CVarDefMap::Freeze()
+{
+	ADDTOCALLSTACK("CVarDefMap::Freeze");
+	std::unique_ptr<FrozenIndex> pFrozen = std::make_unique<FrozenIndex>();
+	const size_t uiCount = m_Container.size();
+	pFrozen->vKeys.reserve(uiCount);
+	pFrozen->vKeyPtrs.reserve(uiCount);
+	pFrozen->vVars.reserve(uiCount);
+	for ( CVarDefCont * pVar : m_Container )
+	{
+		pFrozen->vKeys.emplace_back(pVar->GetKey());
+		pFrozen->vKeyPtrs.emplace_back(pFrozen->vKeys.back().GetPtr());
+		pFrozen->vVars.emplace_back(pVar);
+	}
+	pFrozen->pIndex = std::make_unique<CKeyTableIndex>(pFrozen->vKeyPtrs.data(), (int)uiCount);
+	_pFrozen = std::move(pFrozen);
+}
+
+CVarDefCont * CVarDefMap::FrozenFind( lpctstr ptcKey ) const
+{
+	const int iIndex = _pFrozen->pIndex->Find(ptcKey);
+	if ( (iIndex >= 0) && (_pFrozen->vVars[iIndex] != nullptr) )
+		return _pFrozen->vVars[iIndex];
+
+	// Not there when it was frozen, or deleted (and maybe added again) since.
+	const size_t idx = _pFrozen->Overlay.find_predicate(ptcKey, VarDefCompare);
+	if ( idx != SCONT_BADINDEX )
+		return _pFrozen->Overlay[idx];
+	return nullptr;
+}
+
+void CVarDefMap::FrozenAdd( CVarDefCont * pVar )
+{
+	_pFrozen->Overlay.insert(pVar);
+}
+
+void CVarDefMap::FrozenDelete( const CVarDefCont * pVar )
+{
+	const int iIndex = _pFrozen->pIndex->Find(pVar->GetKey());
+	if ( (iIndex >= 0) && (_pFrozen->vVars[iIndex] == pVar) )
+	{
+		_pFrozen->vVars[iIndex] = nullptr;
+		return;
+	}
+
+	const size_t idx = _pFrozen->Overlay.find_predicate(pVar->GetKey(), VarDefCompare);
+	if ( (idx != SCONT_BADINDEX) && (_pFrozen->Overlay[idx] == pVar) )
+		_pFrozen->Overlay.erase(_pFrozen->Overlay.begin() + idx);
+}
+
 CVarDefContNum* CVarDefMap::SetNumNew( lpctstr pszName, int64 iVal )
 {
 	ADDTOCALLSTACK_INTENSIVE("CVarDefMap::SetNumNew");
-	CVarDefContNum * pVarNum = new CVarDefContNum( pszName, iVal );
+	CVarDefContNum * pVarNum = new CVarDefContNum( pszName, iVal, _fInternKeys );
 	if ( !pVarNum )
 		return nullptr;
 
 	iterator res = m_Container.emplace(static_cast<CVarDefCont*>(pVarNum));
 	if ( res != m_Container.end() )
+	{
+		if ( _pFrozen )
+			FrozenAdd(pVarNum);
 		return pVarNum;
+	}
 	else
     {
         delete pVarNum;
@@ -406,13 +465,17 @@ CVarDefContNum* CVarDefMap::SetNum( lpctstr pszName, int64 iVal, bool fDeleteZer
 CVarDefContStr* CVarDefMap::SetStrNew( lpctstr pszName, lpctstr pszVal )
 {
 	ADDTOCALLSTACK_INTENSIVE("CVarDefMap::SetStrNew");
-	CVarDefContStr * pVarStr = new CVarDefContStr( pszName, pszVal );
+	CVarDefContStr * pVarStr = new CVarDefContStr( pszName, pszVal, _fInternKeys );
 	if ( !pVarStr )
 		return nullptr;
 
     iterator res = m_Container.emplace(static_cast<CVarDefCont*>(pVarStr));
     if ( res != m_Container.end() )
+	{
+		if ( _pFrozen )
+			FrozenAdd(pVarStr);
 		return pVarStr;
+	}
 	else
     {
         delete pVarStr;
@@ -486,6 +549,9 @@ CVarDefCont * CVarDefMap::GetKey( lpctstr ptcKey ) const
 
 	if ( ptcKey )
 	{
+		if ( _pFrozen )
+			return FrozenFind(ptcKey);
+
         const size_t idx = m_Container.find_predicate(ptcKey, VarDefCompare);
 		
 		if ( idx != SCONT_BADINDEX )
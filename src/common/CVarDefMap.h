@@ -7,12 +7,62 @@
 #define _INC_CVARDEFMAP_H
 
 #include "sphere_library/CSString.h"
+#include "sphere_library/CSStringPool.h"
 #include "sphere_library/CSSortedVector.h"
+#include <memory>
 
 
 class CTextConsole;
 class CScript;
 
+/**
+* @brief Key of a var: an own copy (short keys are kept inside the CSString), or a CSStringPool copy for the maps
+*  interning their keys (long-lived maps, like the DEFs). The pool is locked, so it's kept out of the TAGs and LOCALs.
+*/
+class CVarDefKey
+{
+private:
+	CSString m_sKey;		// Own copy, when not interned.
+	lpctstr m_pszPooled;	// Pooled copy, or nullptr.
+
+public:
+	CVarDefKey( lpctstr ptcKey, bool fIntern ) :
+		m_pszPooled(fIntern ? CSStringPool::Get().Acquire(ptcKey) : nullptr)
+	{
+		if ( !fIntern )
+			m_sKey = ptcKey;
+	}
+	~CVarDefKey()
+	{
+		if ( m_pszPooled )
+			CSStringPool::Get().Release(m_pszPooled);
+	}
+private:
+	CVarDefKey(const CVarDefKey& copy);
+	CVarDefKey& operator=(const CVarDefKey& other);
+
+public:
+	inline lpctstr GetPtr() const noexcept
+	{
+		return (m_pszPooled ? m_pszPooled : m_sKey.GetPtr());
+	}
+	inline bool IsInterned() const noexcept
+	{
+		return (m_pszPooled != nullptr);
+	}
+	void Set( lpctstr ptcKey )
+	{
+		if ( m_pszPooled )
+		{
+			lpctstr pszOld = m_pszPooled;
+			m_pszPooled = CSStringPool::Get().Acquire(ptcKey);
+			CSStringPool::Get().Release(pszOld);
+		}
+		else
+			m_sKey = ptcKey;
+	}
+};
+
 class CVarDefCont
 {
 public:
@@ -31,19 +81,19 @@ public:
 
 	virtual lpctstr GetValStr() const       = 0;
 	virtual int64 GetValNum() const         = 0;
-	virtual CVarDefCont * CopySelf() const  = 0;
+	virtual CVarDefCont * CopySelf( bool fInternKey = false ) const = 0;
 };
 
 class CVarDefContNum : public CVarDefCont
 {
 private:
-    CSString m_sKey;    // reference to map key
+    CVarDefKey m_sKey;  // reference to map key
 	int64 m_iVal;       // the assigned value
 
 public:
 	static const char *m_sClassName;
 
-	CVarDefContNum( lpctstr ptcKey, int64 iVal );
+	CVarDefContNum( lpctstr ptcKey, int64 iVal, bool fInternKey = false );
 	CVarDefContNum( lpctstr ptcKey );
 	virtual ~CVarDefContNum() = default;
 
@@ -56,7 +106,7 @@ public:
         return m_sKey.GetPtr();
     }
     inline virtual void SetKey(lpctstr ptcKey) override {
-        m_sKey = ptcKey;
+        m_sKey.Set(ptcKey);
     }
 
     inline void SetValNum(int64 iVal) {
@@ -66,7 +116,7 @@ public:
         return m_iVal;
     }
     virtual lpctstr GetValStr() const override;
-    virtual CVarDefCont * CopySelf() const override;
+    virtual CVarDefCont * CopySelf( bool fInternKey = false ) const override;
 
 	bool r_LoadVal( CScript & s );
 	bool r_WriteVal( lpctstr pKey, CSString & sVal, CTextConsole * pSrc );
@@ -75,13 +125,13 @@ public:
 class CVarDefContStr : public CVarDefCont
 {
 private:
-    CSString m_sKey;    // map key
+    CVarDefKey m_sKey;  // reference to map key
 	CSString m_sVal;    // the assigned value
 
 public:
 	static const char *m_sClassName;
 
-	CVarDefContStr( lpctstr ptcKey, lpctstr pszVal );
+	CVarDefContStr( lpctstr ptcKey, lpctstr pszVal, bool fInternKey = false );
 	explicit CVarDefContStr( lpctstr ptcKey );
 	virtual ~CVarDefContStr() = default;
 
@@ -94,7 +144,7 @@ public:
         return m_sKey.GetPtr();
     }
     inline virtual void SetKey(lpctstr ptcKey) override {
-        m_sKey = ptcKey;
+        m_sKey.Set(ptcKey);
     }
 
     void SetValStr( lpctstr pszVal );
@@ -102,7 +152,7 @@ public:
         return m_sVal.GetPtr(); 
     }
     virtual int64 GetValNum() const override;
-    virtual CVarDefCont * CopySelf() const override;
+    virtual CVarDefCont * CopySelf( bool fInternKey = false ) const override;
 
 	bool r_LoadVal( CScript & s );
 	bool r_WriteVal( lpctstr pKey, CSString & sVal, CTextConsole * pSrc );
@@ -122,6 +172,19 @@ class CVarDefMap
 
 	DefCont m_Container;
 
+	// Perfect hash index of the vars there were when Freeze was called, for the big maps changing little after
+	//  the scripts are loaded (the DEFs). The vars added since are kept in a small sorted overlay.
+	struct FrozenIndex
+	{
+		std::vector<CSInternedString> vKeys;	// Copy of the keys (shared with the vars when interned), still valid when their var is deleted.
+		std::vector<lpctstr> vKeyPtrs;			// The table of the index.
+		std::vector<CVarDefCont *> vVars;		// nullptr when the var has been deleted.
+		std::unique_ptr<CKeyTableIndex> pIndex;
+		DefCont Overlay;						// Vars added since Freeze (owned by m_Container).
+	};
+	std::unique_ptr<FrozenIndex> _pFrozen;
+	bool _fInternKeys = false;	// Keys of the new vars are kept in the CSStringPool.
+
 public:
 	static const char *m_sClassName;
     using iterator          = DefCont::iterator;
@@ -135,6 +198,10 @@ private:
     CVarDefContNum* SetNumOverride( lpctstr ptcKey, int64 iVal );
     CVarDefContStr* SetStrOverride( lpctstr ptcKey, lpctstr pszVal );
 
+	CVarDefCont * FrozenFind( lpctstr ptcKey ) const;
+	void FrozenAdd( CVarDefCont * pVar );
+	void FrozenDelete( const CVarDefCont * pVar );
+
 public:
 	void Copy( const CVarDefMap * pArray );
 	bool Compare( const CVarDefMap * pArray );
@@ -142,6 +209,24 @@ public:
 	void Clear();
 	size_t GetCount() const;
 
+	/**
+	* @brief Index the current vars with a perfect hash, speeding up the lookups (call it again to rebuild the index).
+	*  The map can still be changed, but it's meant for maps getting few new vars afterwards.
+	*/
+	void Freeze();
+	inline bool IsFrozen() const noexcept
+	{
+		return (_pFrozen != nullptr);
+	}
+	/**
+	* @brief Keep the keys of the vars added from now on in the CSStringPool. Meant for the long-lived maps (DEFs, resource names),
+	*  not for the TAGs/LOCALs/ARGS created and deleted all the time (the pool is shared by all the threads, so it's locked).
+	*/
+	inline void SetInternKeys() noexcept
+	{
+		_fInternKeys = true;
+	}
+
 public:
 	CVarDefMap() = default;
 	~CVarDefMap();
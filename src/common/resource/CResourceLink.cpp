@@ -204,7 +204,7 @@ bool CResourceLink::ResourceLock( CResourceLock &s )
     ASSERT(m_pScript);
 
     //	Give several tryes to lock the script while multithreading
-    int iRet = s.OpenLock( m_pScript, m_Context );
+    int iRet = s.OpenLock( m_pScript, m_Context, this );
     if ( ! iRet )
         return true;
 
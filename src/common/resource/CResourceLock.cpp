@@ -94,7 +94,7 @@ bool CResourceLock::ReadTextLine( bool fRemoveBlanks ) // Read a line from the o
     THREAD_UNIQUE_LOCK_RETURN(_ReadTextLine(fRemoveBlanks));
 }
 
-int CResourceLock::OpenLock( CResourceScript * pLock, CScriptLineContext context )
+int CResourceLock::OpenLock( CResourceScript * pLock, CScriptLineContext context, const CResourceLink * pLink )
 {
     ADDTOCALLSTACK("CResourceLock::OpenLock");
     // ONLY called from CResourceLink
@@ -102,6 +102,7 @@ int CResourceLock::OpenLock( CResourceScript * pLock, CScriptLineContext context
 
     Close();
     m_pLock = pLock;
+    m_pLink = pLink;
 
     if ( ! Open() )	    // open my copy.
         return -2;
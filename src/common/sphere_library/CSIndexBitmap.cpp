@@ -0,0 +1,139 @@
+/**
+* @file CSIndexBitmap.cpp
+*/
+
+#include "CSIndexBitmap.h"
+#include "../assertion.h"
+#ifdef _MSC_VER
+	#include <intrin.h>
+#endif
+
+static inline uint BitScanLow( ullong uiWord )
+{
+	// Index of the lowest set bit (uiWord != 0).
+#ifdef _MSC_VER
+	unsigned long uiBit;
+	_BitScanForward64(&uiBit, uiWord);
+	return (uint)uiBit;
+#else
+	return (uint)__builtin_ctzll(uiWord);
+#endif
+}
+
+
+CSIndexBitmap::CSIndexBitmap() :
+	_uiSize(0), _uiSetCount(0)
+{
+	_vLevels.resize(1);
+}
+
+void CSIndexBitmap::Grow( size_t uiSize )
+{
+	ASSERT(uiSize >= _uiSize);
+	_uiSize = uiSize;
+
+	// The new bits are zero, and so are the summary bits of the new words: the levels just get longer.
+	size_t uiBits = uiSize;
+	for ( size_t uiLevel = 0; ; ++uiLevel )
+	{
+		const size_t uiWords = (uiBits + 63) / 64;
+		if ( uiLevel == _vLevels.size() )
+		{
+			// A new level on top: it summarizes the (already filled) level below.
+			const std::vector<ullong> & vBelow = _vLevels[uiLevel - 1];
+			std::vector<ullong> vLevel(uiWords, 0);
+			for ( size_t i = 0; i < vBelow.size(); ++i )
+			{
+				if ( vBelow[i] )
+					vLevel[i / 64] |= (1ull << (i % 64));
+			}
+			_vLevels.emplace_back(std::move(vLevel));
+		}
+		else
+		{
+			_vLevels[uiLevel].resize(uiWords, 0);
+		}
+		if ( uiWords <= 1 )
+			break;
+		uiBits = uiWords;
+	}
+}
+
+void CSIndexBitmap::Clear()
+{
+	_vLevels.clear();
+	_vLevels.resize(1);
+	_uiSize = 0;
+	_uiSetCount = 0;
+}
+
+void CSIndexBitmap::Set( size_t uiIndex )
+{
+	ASSERT(uiIndex < _uiSize);
+	for ( std::vector<ullong> & vLevel : _vLevels )
+	{
+		ullong & uiWord = vLevel[uiIndex / 64];
+		const bool fWasEmpty = (uiWord == 0);
+		const ullong uiBit = (1ull << (uiIndex % 64));
+		if ( uiWord & uiBit )
+			return;		// already set (so are the bits above)
+		if ( &vLevel == &_vLevels[0] )
+			++_uiSetCount;
+		uiWord |= uiBit;
+		if ( !fWasEmpty )
+			return;
+		uiIndex /= 64;
+	}
+}
+
+void CSIndexBitmap::Reset( size_t uiIndex )
+{
+	ASSERT(uiIndex < _uiSize);
+	for ( std::vector<ullong> & vLevel : _vLevels )
+	{
+		ullong & uiWord = vLevel[uiIndex / 64];
+		const ullong uiBit = (1ull << (uiIndex % 64));
+		if ( !(uiWord & uiBit) )
+			return;
+		if ( &vLevel == &_vLevels[0] )
+			--_uiSetCount;
+		uiWord &= ~uiBit;
+		if ( uiWord != 0 )
+			return;
+		uiIndex /= 64;
+	}
+}
+
+size_t CSIndexBitmap::_FindNext( size_t uiLevel, size_t uiFrom ) const
+{
+	const std::vector<ullong> & vLevel = _vLevels[uiLevel];
+	size_t uiWord = uiFrom / 64;
+	if ( uiWord >= vLevel.size() )
+		return npos;
+
+	const ullong uiMasked = vLevel[uiWord] & (~0ull << (uiFrom % 64));
+	if ( uiMasked )
+		return (uiWord * 64) + BitScanLow(uiMasked);
+
+	// Next non empty word, told by the level above.
+	if ( uiLevel + 1 < _vLevels.size() )
+	{
+		uiWord = _FindNext(uiLevel + 1, uiWord + 1);
+		if ( uiWord == npos )
+			return npos;
+	}
+	else
+	{
+		// The top level has a single word.
+		return npos;
+	}
+	return (uiWord * 64) + BitScanLow(vLevel[uiWord]);
+}
+
+size_t CSIndexBitmap::FindNext( size_t uiFrom ) const
+{
+	if ( uiFrom >= _uiSize )
+		return npos;
+	const size_t uiIndex = _FindNext(0, uiFrom);
+	return (uiIndex < _uiSize) ? uiIndex : npos;
+}
@@ -0,0 +1,67 @@
+/**
+* @file CSIndexBitmap.h
+* @brief Set of indexes stored as a bitmap, with a summary bitmap on top of it to find the next set bit quickly.
+*/
+
+#ifndef _INC_CSINDEXBITMAP_H
+#define _INC_CSINDEXBITMAP_H
+
+#include "../common.h"
+#include <vector>
+
+
+/**
+* @brief Bitmap of indexes with summary levels: each bit of a level tells if the matching 64 bits word of the level below has any bit set.
+*
+* Set, Reset and FindNext cost about one word access per level (a level is added every 64x), instead of a scan of the whole bitmap. Not thread safe.
+*/
+class CSIndexBitmap
+{
+public:
+	static constexpr size_t npos = SIZE_MAX;
+
+private:
+	std::vector<std::vector<ullong>> _vLevels;	// _vLevels[0] has a bit for each index, the last one fits in a single word.
+	size_t _uiSize;
+	size_t _uiSetCount;
+
+	size_t _FindNext( size_t uiLevel, size_t uiFrom ) const;
+
+public:
+	CSIndexBitmap();
+	~CSIndexBitmap() = default;
+private:
+	CSIndexBitmap(const CSIndexBitmap& copy);
+	CSIndexBitmap& operator=(const CSIndexBitmap& other);
+
+public:
+	/**
+	* @brief Grow the number of indexes. The new indexes are not set.
+	*/
+	void Grow( size_t uiSize );
+	void Clear();
+
+	inline size_t GetSize() const noexcept
+	{
+		return _uiSize;
+	}
+	inline size_t GetSetCount() const noexcept
+	{
+		return _uiSetCount;
+	}
+	inline bool Test( size_t uiIndex ) const
+	{
+		return ((_vLevels[0][uiIndex / 64] >> (uiIndex % 64)) & 1) != 0;
+	}
+	void Set( size_t uiIndex );
+	void Reset( size_t uiIndex );
+
+	/**
+	* @brief First set index >= uiFrom.
+	* @return npos if there isn't any.
+	*/
+	size_t FindNext( size_t uiFrom = 0 ) const;
+};
+
+
+#endif // _INC_CSINDEXBITMAP_H
@@ -0,0 +1,79 @@
+/**
+* @file CSSlabPool.cpp
+*/
+
+#include "CSSlabPool.h"
+#include <new>
+
+CSSlabPool::~CSSlabPool()
+{
+	for ( void * pSlab : _vSlabs )
+		::operator delete(pSlab, std::align_val_t(SLABPOOL_SLAB_SIZE));
+}
+
+void * CSSlabPool::Alloc( size_t uiSize )
+{
+	if ( uiSize > SLABPOOL_MAX_BLOCK )
+		return nullptr;
+	const size_t uiBlockSize = (maximum(uiSize, sizeof(FreeBlock)) + SLABPOOL_GRANULARITY - 1) & ~(size_t)(SLABPOOL_GRANULARITY - 1);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	std::map<size_t, SizeClass>::iterator it = _mapClasses.find(uiBlockSize);
+	if ( it == _mapClasses.end() )
+		it = _mapClasses.emplace(uiBlockSize, SizeClass{ uiBlockSize, nullptr, nullptr, nullptr, 0, 0, 0 }).first;
+	SizeClass & sizeClass = it->second;
+
+	void * pBlock;
+	if ( sizeClass.pFree != nullptr )
+	{
+		pBlock = sizeClass.pFree;
+		sizeClass.pFree = sizeClass.pFree->pNext;
+	}
+	else
+	{
+		if ( sizeClass.pBump + uiBlockSize > sizeClass.pBumpEnd )
+		{
+			byte * pSlab = static_cast<byte *>(::operator new(SLABPOOL_SLAB_SIZE, std::align_val_t(SLABPOOL_SLAB_SIZE)));
+			_vSlabs.push_back(pSlab);
+			_mapSlabs.emplace(reinterpret_cast<uintptr_t>(pSlab), &sizeClass);
+			sizeClass.pBump = pSlab;
+			sizeClass.pBumpEnd = pSlab + SLABPOOL_SLAB_SIZE;
+			++sizeClass.uiSlabs;
+			_fUsed.store(true, std::memory_order_release);
+		}
+		pBlock = sizeClass.pBump;
+		sizeClass.pBump += uiBlockSize;
+	}
+
+	++sizeClass.uiLive;
+	++sizeClass.uiAllocations;
+	return pBlock;
+}
+
+bool CSSlabPool::Free( void * pBlock )
+{
+	if ( !_fUsed.load(std::memory_order_acquire) )
+		return false;
+	const uintptr_t uiSlab = reinterpret_cast<uintptr_t>(pBlock) & ~(uintptr_t)(SLABPOOL_SLAB_SIZE - 1);
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	std::unordered_map<uintptr_t, SizeClass *>::iterator it = _mapSlabs.find(uiSlab);
+	if ( it == _mapSlabs.end() )
+		return false;
+
+	SizeClass * pSizeClass = it->second;
+	FreeBlock * pFree = static_cast<FreeBlock *>(pBlock);
+	pFree->pNext = pSizeClass->pFree;
+	pSizeClass->pFree = pFree;
+	--pSizeClass->uiLive;
+	return true;
+}
+
+void CSSlabPool::GetStats( std::vector<SizeClassStats> & vStats )
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	vStats.clear();
+	vStats.reserve(_mapClasses.size());
+	for ( const std::pair<const size_t, SizeClass> & sizeClass : _mapClasses )
+		vStats.push_back({ sizeClass.second.uiBlockSize, sizeClass.second.uiSlabs, sizeClass.second.uiLive, sizeClass.second.uiAllocations });
+}
@@ -0,0 +1,76 @@
+/**
+* @file CSSlabPool.h
+* @brief Pool allocator handing out fixed size blocks carved from big slabs, with a free list for each size.
+*/
+
+#ifndef _INC_CSSLABPOOL_H
+#define _INC_CSSLABPOOL_H
+
+#include "../common.h"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#define SLABPOOL_SLAB_SIZE		(256 * 1024)	// Slabs are aligned to their size, so a block finds its slab by masking its address.
+#define SLABPOOL_GRANULARITY	16				// Sizes are rounded up to this (it's also the blocks alignment).
+#define SLABPOOL_MAX_BLOCK		(SLABPOOL_SLAB_SIZE / 8)	// Bigger blocks are left to the system allocator.
+
+
+class CSSlabPool
+{
+	// Each object size gets its own size class: objects of the same type end up next to each other in the same slabs,
+	// instead of being scattered around the heap, and a freed block is reused by the next object of that size.
+	// The slabs are never given back to the system. Thread safe.
+public:
+	struct SizeClassStats
+	{
+		size_t uiBlockSize;
+		size_t uiSlabs;
+		size_t uiLive;			// Blocks in use.
+		ullong uiAllocations;	// Blocks handed out since the start.
+	};
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock * pNext;
+	};
+	struct SizeClass
+	{
+		size_t uiBlockSize;
+		FreeBlock * pFree;		// Freed blocks, reused first (the most recently freed is still in the cache).
+		byte * pBump;			// Never used part of the last slab.
+		byte * pBumpEnd;
+		size_t uiSlabs;
+		size_t uiLive;
+		ullong uiAllocations;
+	};
+
+	std::mutex _mutex;
+	std::map<size_t, SizeClass> _mapClasses;			// By block size.
+	std::unordered_map<uintptr_t, SizeClass *> _mapSlabs;	// Slab address -> its size class.
+	std::vector<void *> _vSlabs;
+	std::atomic_bool _fUsed;	// Set with the first slab: until then, Free doesn't need to look for the block.
+
+public:
+	CSSlabPool() : _fUsed(false)
+	{
+	}
+	~CSSlabPool();
+private:
+	CSSlabPool(const CSSlabPool& copy);
+	CSSlabPool& operator=(const CSSlabPool& other);
+
+public:
+	// Returns nullptr if the size is too big for the pool.
+	void * Alloc( size_t uiSize );
+	// Returns false if the block wasn't allocated by this pool (nothing is done).
+	bool Free( void * pBlock );
+
+	void GetStats( std::vector<SizeClassStats> & vStats );
+};
+
+
+#endif // _INC_CSSLABPOOL_H
@@ -28,14 +28,18 @@
 *  - 56 bytes : memory:  87,050,665 [Mem=273,108 K] [reallocations=141,507]
 *  - 64 bytes : memory:  99,278,582 [Mem=295,932 K] [reallocations=141,388]
 *  - 128 bytes : memory: 197,114,039 [Mem=392,056 K] [reallocations=141,234] <- was in [0.55R4.0.2 - 0.56a]
+*
+* Strings up to STRING_INLINE_SIZE chars are now kept in the object itself, so this is only the room left
+* for growing when a string moves to (or grows in) the heap.
 */
 #define	STRING_DEFAULT_SIZE	42
 
-//#define DEBUG_STRINGS
+//#define DEBUG_STRINGS	// Define it for the whole build: the counters are logged at the end of the startup.
 #ifdef DEBUG_STRINGS
 	uint	gAmount		= 0;		// Current amount of CSString.
 	size_t	gMemAmount	= 0;		// Total mem allocated by CGStrings.
 	uint	gReallocs	= 0;		// Total reallocs caused by CSString resizing.
+	uint	gAllocs		= 0;		// Total heap buffers allocated (strings longer than STRING_INLINE_SIZE).
 #endif
 
 
@@ -43,49 +47,50 @@
 
 void CSString::Empty(bool fTotal)
 {
-	if (fTotal)
+	if (fTotal && !IsInline())
 	{
-		if (m_iMaxLength && m_pchData)
-		{
 #ifdef DEBUG_STRINGS
-			gMemAmount -= m_iMaxLength;
+		gMemAmount -= m_iMaxLength;
 #endif
-			delete[] m_pchData;
-			m_pchData = nullptr;
-			m_iMaxLength = 0;
-		}
+		delete[] m_pchData;
+		m_pchData = m_szInline;
+		m_iMaxLength = STRING_INLINE_SIZE;
 	}
 	m_iLength = 0;
+	m_pchData[0] = '\0';
 }
 
 bool CSString::IsValid() const
 {
-	if (!m_iMaxLength)
-		return false;
 	return (m_pchData[m_iLength] == '\0');
 }
 
 int CSString::SetLength(int iNewLength)
 {
-	if (iNewLength >= m_iMaxLength)
+	if (iNewLength > m_iMaxLength)
 	{
+		const bool fWasInline = IsInline();
 #ifdef DEBUG_STRINGS
-		gMemAmount -= m_iMaxLength;
+		if (fWasInline)
+			++gAllocs;
+		else
+		{
+			gMemAmount -= m_iMaxLength;
+			++gReallocs;
+		}
 #endif
 		m_iMaxLength = iNewLength + (STRING_DEFAULT_SIZE >> 1);	// allow grow, and always expand only
 #ifdef DEBUG_STRINGS
 		gMemAmount += m_iMaxLength;
-		++gReallocs;
 #endif
 		tchar *pNewData = new tchar[m_iMaxLength + 1];
 		ASSERT(pNewData);
 
 		int iMinLength = minimum(iNewLength, m_iLength + 1);
-        ASSERT(m_pchData);
 		Str_CopyLimitNull(pNewData, m_pchData, iMinLength);
 		pNewData[m_iLength] = '\0';
 
-		if (m_pchData)
+		if (!fWasInline)
 			delete[] m_pchData;
 		m_pchData = pNewData;
 	}
@@ -421,16 +426,4 @@ int CSString::lastIndexOf(CSString str, int from)
 	return -1;
 }
 
-// CSString:: private
-
-void CSString::Init()
-{
-	m_iMaxLength = STRING_DEFAULT_SIZE;
-#ifdef DEBUG_STRINGS
-	gMemAmount += m_iMaxLength;
-#endif
-	m_iLength = 0;
-	m_pchData = new tchar[m_iMaxLength + 1];
-	m_pchData[m_iLength] = 0;
-}
 
@@ -13,6 +13,15 @@
 
 #include "sstring.h"
 
+#define STRING_INLINE_SIZE	23	// Strings up to this length are stored inside the CSString, without a heap allocation.
+
+#ifdef DEBUG_STRINGS
+	extern uint		gAmount;
+	extern size_t	gMemAmount;
+	extern uint		gReallocs;
+	extern uint		gAllocs;
+#endif
+
 /**
 * @brief Custom String implementation.
 */
@@ -59,6 +68,13 @@ public:
 	* @param pStr string to copy.
 	*/
     inline CSString(const CSString &s);
+	/**
+	* @brief Move constructor.
+	*
+	* Takes the heap buffer of s, if any (s is left empty).
+	* @param s CSString to move.
+	*/
+	inline CSString(CSString &&s) noexcept;
 	/**
 	* @brief Copy supplied string into the CSString.
 	* @param pStr string to copy.
@@ -71,6 +87,14 @@ public:
 	* @return the CSString.
 	*/
 	inline const CSString& operator=(const CSString &s);
+	/**
+	* @brief Move supplied CSString into the CSString.
+	*
+	* Takes the heap buffer of s, if any (s is left empty).
+	* @param s CSString to move.
+	* @return the CSString.
+	*/
+	inline CSString& operator=(CSString &&s) noexcept;
 	///@}
 
 	/** @name Capacity:
@@ -79,7 +103,7 @@ public:
 	/**
 	* @brief Sets length to zero.
 	*
-	* If fTotal is true, then free the memory allocated. If DEBUG_STRINGS setted, update statistical information (total memory allocated).
+	* If fTotal is true, then free the heap memory allocated (the string goes back to the inline buffer). If DEBUG_STRINGS setted, update statistical information (total memory allocated).
 	* @param fTotal true for free the allocated memory.
 	*/
 	void Empty(bool fTotal = false);
@@ -528,13 +552,18 @@ private:
 	/**
 	* @brief Initializes internal data.
 	*
-	* Allocs STRING_DEFAULT_SIZE by default. If DEBUG_STRINGS setted, updates statistical information (total memory allocated).
+	* The string starts in the inline buffer, the heap is used only when it grows longer than STRING_INLINE_SIZE.
 	*/
-	void Init();
+	inline void Init() noexcept;
+	inline bool IsInline() const noexcept
+	{
+		return (m_pchData == m_szInline);
+	}
 
-	tchar *m_pchData;	// Data pointer.
+	tchar *m_pchData;	// Data pointer: m_szInline or a heap buffer.
 	int	m_iLength;		// Length of string.
-	int	m_iMaxLength;	// Size of memory allocated pointed by m_pchData.
+	int	m_iMaxLength;	// Max length the buffer pointed by m_pchData can hold (without the terminator).
+	tchar m_szInline[STRING_INLINE_SIZE + 1];	// Buffer of the short strings.
 };
 
 
@@ -574,6 +603,26 @@ CSString::CSString(const CSString &s)
     Copy(s.GetPtr());
 }
 
+CSString::CSString(CSString &&s) noexcept
+{
+#ifdef DEBUG_STRINGS
+    ++gAmount;
+#endif
+    if (s.IsInline())
+    {
+        Init();
+        memcpy(m_szInline, s.m_szInline, s.m_iLength + 1);
+        m_iLength = s.m_iLength;
+    }
+    else
+    {
+        m_pchData = s.m_pchData;
+        m_iLength = s.m_iLength;
+        m_iMaxLength = s.m_iMaxLength;
+        s.Init();
+    }
+}
+
 const CSString& CSString::operator=(lpctstr pStr)
 {
     Copy(pStr);
@@ -586,5 +635,35 @@ const CSString& CSString::operator=(const CSString &s)
     return *this;
 }
 
+CSString& CSString::operator=(CSString &&s) noexcept
+{
+    if (this == &s)
+        return *this;
+
+    if (s.IsInline())
+    {
+        // Short string, nothing to take: a copy fits in our buffer, whatever it is.
+        memcpy(m_pchData, s.m_szInline, s.m_iLength + 1);
+        m_iLength = s.m_iLength;
+    }
+    else
+    {
+        Empty(true);
+        m_pchData = s.m_pchData;
+        m_iLength = s.m_iLength;
+        m_iMaxLength = s.m_iMaxLength;
+        s.Init();
+    }
+    return *this;
+}
+
+void CSString::Init() noexcept
+{
+    m_pchData = m_szInline;
+    m_iMaxLength = STRING_INLINE_SIZE;
+    m_iLength = 0;
+    m_szInline[0] = '\0';
+}
+
 
 #endif // _INC_CSSTRING_H
@@ -0,0 +1,62 @@
+/**
+* @file CSStringPool.cpp
+*/
+
+#include "CSStringPool.h"
+#include <cstring>
+
+tchar CSStringPool::sm_szEmpty[1] = "";
+
+CSStringPool & CSStringPool::Get()
+{
+	static CSStringPool * const sm_pPool = new CSStringPool();
+	return *sm_pPool;
+}
+
+lpctstr CSStringPool::Acquire( lpctstr pszStr )
+{
+	if ( (pszStr == nullptr) || (pszStr[0] == '\0') )
+		return sm_szEmpty;
+
+	const std::string_view svStr(pszStr);
+	std::unique_lock<std::mutex> lock(_mutex);
+	std::unordered_map<std::string_view, Entry *>::iterator it = _mapStrings.find(svStr);
+	if ( it != _mapStrings.end() )
+	{
+		++it->second->uiRefs;
+		return it->second->GetStr();
+	}
+
+	Entry * pEntry = reinterpret_cast<Entry *>(new byte[sizeof(Entry) + svStr.size() + 1]);
+	pEntry->uiRefs = 1;
+	memcpy(pEntry->GetStr(), pszStr, svStr.size() + 1);
+	_mapStrings.emplace(std::string_view(pEntry->GetStr(), svStr.size()), pEntry);
+	return pEntry->GetStr();
+}
+
+void CSStringPool::AddRef( lpctstr pszPooled )
+{
+	if ( pszPooled == sm_szEmpty )
+		return;
+	Entry * pEntry = reinterpret_cast<Entry *>(const_cast<tchar *>(pszPooled)) - 1;
+	std::unique_lock<std::mutex> lock(_mutex);
+	++pEntry->uiRefs;
+}
+
+void CSStringPool::Release( lpctstr pszPooled )
+{
+	if ( pszPooled == sm_szEmpty )
+		return;
+	Entry * pEntry = reinterpret_cast<Entry *>(const_cast<tchar *>(pszPooled)) - 1;
+	std::unique_lock<std::mutex> lock(_mutex);
+	if ( --pEntry->uiRefs != 0 )
+		return;
+	_mapStrings.erase(std::string_view(pszPooled));
+	delete[] reinterpret_cast<byte *>(pEntry);
+}
+
+size_t CSStringPool::GetCount()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	return _mapStrings.size();
+}
@@ -0,0 +1,127 @@
+/**
+* @file CSStringPool.h
+* @brief Interned immutable strings.
+*/
+
+#ifndef _INC_CSSTRINGPOOL_H
+#define _INC_CSSTRINGPOOL_H
+
+#include "sstring.h"
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+
+
+/**
+* @brief Pool of immutable strings, each one stored once and shared by all its users.
+*
+* Meant for names repeated on many objects (tag and variable names, defnames...). The strings are reference counted
+* and freed when the last user releases them, so names built at runtime don't pile up. Thread safe.
+*/
+class CSStringPool
+{
+private:
+	struct Entry
+	{
+		uint uiRefs;
+		// Followed by the string.
+		tchar * GetStr() noexcept
+		{
+			return reinterpret_cast<tchar *>(this + 1);
+		}
+	};
+
+	std::mutex _mutex;
+	std::unordered_map<std::string_view, Entry *> _mapStrings;	// Keyed by the string stored after the Entry.
+
+	static tchar sm_szEmpty[1];	// Shared by the empty strings, not counted.
+
+public:
+	CSStringPool() = default;
+	~CSStringPool() = default;
+private:
+	CSStringPool(const CSStringPool& copy);
+	CSStringPool& operator=(const CSStringPool& other);
+
+public:
+	/**
+	* @brief The pool used by CSInternedString. It's never destroyed, since interned strings can outlive the static objects.
+	*/
+	static CSStringPool & Get();
+
+	/**
+	* @brief Gets the pooled copy of the string, adding it if needed.
+	* @return Pointer valid until the matching Release.
+	*/
+	lpctstr Acquire( lpctstr pszStr );
+	/**
+	* @brief Adds a reference to a string returned by Acquire.
+	*/
+	void AddRef( lpctstr pszPooled );
+	/**
+	* @brief Drops a reference to a string returned by Acquire, freeing it when it was the last one.
+	*/
+	void Release( lpctstr pszPooled );
+
+	size_t GetCount();
+};
+
+
+/**
+* @brief Handle to a string of the CSStringPool, usable as an immutable CSString.
+*/
+class CSInternedString
+{
+private:
+	lpctstr m_pszStr;
+
+public:
+	CSInternedString() : m_pszStr(CSStringPool::Get().Acquire(""))
+	{
+	}
+	explicit CSInternedString( lpctstr pszStr ) : m_pszStr(CSStringPool::Get().Acquire(pszStr))
+	{
+	}
+	CSInternedString( const CSInternedString & other ) : m_pszStr(other.m_pszStr)
+	{
+		CSStringPool::Get().AddRef(m_pszStr);
+	}
+	~CSInternedString()
+	{
+		CSStringPool::Get().Release(m_pszStr);
+	}
+
+	CSInternedString & operator=( lpctstr pszStr )
+	{
+		lpctstr pszOld = m_pszStr;
+		m_pszStr = CSStringPool::Get().Acquire(pszStr);
+		CSStringPool::Get().Release(pszOld);
+		return *this;
+	}
+	CSInternedString & operator=( const CSInternedString & other )
+	{
+		if ( other.m_pszStr != m_pszStr )
+		{
+			CSStringPool::Get().AddRef(other.m_pszStr);
+			CSStringPool::Get().Release(m_pszStr);
+			m_pszStr = other.m_pszStr;
+		}
+		return *this;
+	}
+
+	inline lpctstr GetPtr() const noexcept
+	{
+		return m_pszStr;
+	}
+	inline operator lpctstr() const noexcept
+	{
+		return m_pszStr;
+	}
+	inline bool IsEmpty() const noexcept
+	{
+		return (m_pszStr[0] == '\0');
+	}
+};
+
+
+#endif // _INC_CSSTRINGPOOL_H
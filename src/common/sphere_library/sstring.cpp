@@ -3,6 +3,7 @@
 #include "../../sphere/ProfileTask.h"
 #include "../CExpression.h"
 #include "../CScript.h"
+#include <algorithm>
 
 
 #if defined(_MSC_VER)
@@ -718,6 +719,170 @@ int FindTableHeadSorted(const lpctstr ptcFind, lpctstr const * pptcTable, int iC
     */
 }
 
+// CKeyTableIndex: "hash and displace" perfect hashing. The keys are split in buckets by a first hash, then
+//  for each bucket (largest first) we look for a displacement value that sends all of its keys to free slots.
+
+// The keywords are plain ASCII: avoid the locale-aware isalnum/toupper calls.
+static inline bool KeyTable_IsIdentChar(tchar ch) noexcept
+{
+    return ((ch >= 'A') && (ch <= 'Z')) || ((ch >= 'a') && (ch <= 'z')) || ((ch >= '0') && (ch <= '9')) || (ch == '_');
+}
+
+static inline uchar KeyTable_Upper(tchar ch) noexcept
+{
+    return ((ch >= 'a') && (ch <= 'z')) ? uchar(ch - ('a' - 'A')) : uchar(ch);
+}
+
+static inline ullong KeyTable_Hash(lpctstr ptc, size_t uiLen) noexcept
+{
+    // FNV-1a, case-insensitive.
+    ullong h = 14695981039346656037ull;
+    for (size_t i = 0; i < uiLen; ++i)
+    {
+        h ^= (ullong)KeyTable_Upper(ptc[i]);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static inline uint KeyTable_Slot(ullong uiHash, uint uiDisplacement, uint uiSlotMask) noexcept
+{
+    uint x = (uint)uiHash + (uiDisplacement * 0x9E3779B9u);
+    x ^= x >> 16;
+    x *= 0x85EBCA6Bu;
+    x ^= x >> 13;
+    return (x & uiSlotMask);
+}
+
+CKeyTableIndex::CKeyTableIndex(lpctstr const * ppTable, int iCount) :
+    _ppTable(ppTable), _iCount(iCount), _uiBucketMask(0), _uiSlotMask(0)
+{
+    uint uiShift = 2;
+    while (((uint)1 << uiShift) < (uint)(maximum(iCount, 1) * 2))
+        ++uiShift;
+    while (!_Build(uiShift))
+        ++uiShift;
+}
+
+bool CKeyTableIndex::_Build(uint uiSlotsShift)
+{
+    const uint uiSlots = (uint)1 << uiSlotsShift;
+    _uiSlotMask = uiSlots - 1;
+    _uiBucketMask = (uiSlots >> 2) - 1;    // ~2 keys for each bucket.
+
+    _vSlots.assign(uiSlots, -1);
+    _vDisplacement.assign(_uiBucketMask + 1, 0);
+    _vNonIdentifiers.clear();
+
+    std::vector<std::vector<int>> vBuckets(_uiBucketMask + 1);
+    std::vector<ullong> vHashes(_iCount);
+    for (int i = 0; i < _iCount; ++i)
+    {
+        lpctstr ptcKey = _ppTable[i];
+        const size_t uiLen = strlen(ptcKey);
+        for (size_t j = 0; j < uiLen; ++j)
+        {
+            if (!KeyTable_IsIdentChar(ptcKey[j]))
+            {
+                _vNonIdentifiers.push_back(i);
+                break;
+            }
+        }
+
+        vHashes[i] = KeyTable_Hash(ptcKey, uiLen);
+        std::vector<int> & vBucket = vBuckets[(uint)(vHashes[i] >> 32) & _uiBucketMask];
+        bool fDuplicate = false;
+        for (int iOther : vBucket)
+        {
+            if (!strcmpi(_ppTable[iOther], ptcKey))
+            {
+                fDuplicate = true;  // The binary search would find one of them: keep the first.
+                break;
+            }
+        }
+        if (!fDuplicate)
+            vBucket.push_back(i);
+    }
+
+    std::vector<uint> vOrder(_uiBucketMask + 1);
+    for (uint i = 0; i <= _uiBucketMask; ++i)
+        vOrder[i] = i;
+    std::sort(vOrder.begin(), vOrder.end(),
+        [&vBuckets](uint a, uint b) { return vBuckets[a].size() > vBuckets[b].size(); });
+
+    std::vector<uint> vTaken;
+    for (uint uiBucket : vOrder)
+    {
+        const std::vector<int> & vBucket = vBuckets[uiBucket];
+        if (vBucket.empty())
+            break;
+
+        bool fPlaced = false;
+        for (uint uiDisp = 0; uiDisp < 0x10000; ++uiDisp)
+        {
+            vTaken.clear();
+            for (int iKey : vBucket)
+            {
+                const uint uiSlot = KeyTable_Slot(vHashes[iKey], uiDisp, _uiSlotMask);
+                if ((_vSlots[uiSlot] != -1) || (std::find(vTaken.begin(), vTaken.end(), uiSlot) != vTaken.end()))
+                    break;
+                vTaken.push_back(uiSlot);
+            }
+            if (vTaken.size() != vBucket.size())
+                continue;
+
+            for (size_t j = 0; j < vBucket.size(); ++j)
+                _vSlots[vTaken[j]] = vBucket[j];
+            _vDisplacement[uiBucket] = uiDisp;
+            fPlaced = true;
+            break;
+        }
+        if (!fPlaced)
+            return false;   // Try again with more slots.
+    }
+    return true;
+}
+
+int CKeyTableIndex::_Lookup(lpctstr ptcFind, size_t uiLen) const noexcept
+{
+    const ullong uiHash = KeyTable_Hash(ptcFind, uiLen);
+    const uint uiBucket = (uint)(uiHash >> 32) & _uiBucketMask;
+    const int iIndex = _vSlots[KeyTable_Slot(uiHash, _vDisplacement[uiBucket], _uiSlotMask)];
+    if (iIndex < 0)
+        return -1;
+    lpctstr ptcKey = _ppTable[iIndex];
+    for (size_t i = 0; i < uiLen; ++i)
+    {
+        if (KeyTable_Upper(ptcKey[i]) != KeyTable_Upper(ptcFind[i]))
+            return -1;
+    }
+    return (ptcKey[uiLen] == '\0') ? iIndex : -1;
+}
+
+int CKeyTableIndex::Find(lpctstr ptcFind) const noexcept
+{
+    return _Lookup(ptcFind, strlen(ptcFind));
+}
+
+int CKeyTableIndex::FindHead(lpctstr ptcFind) const noexcept
+{
+    // A table entry made only of identifier characters can match only the whole identifier at the start of ptcFind.
+    size_t uiLen = 0;
+    while (KeyTable_IsIdentChar(ptcFind[uiLen]))
+        ++uiLen;
+
+    const int iIndex = _Lookup(ptcFind, uiLen);
+    if (iIndex >= 0)
+        return iIndex;
+
+    for (int i : _vNonIdentifiers)
+    {
+        if (!Str_CmpHeadI_Table(ptcFind, _ppTable[i]))
+            return i;
+    }
+    return -1;
+}
+
 int FindCAssocRegTableHeadSorted(const lpctstr pszFind, lpctstr const* ppszTable, int iCount, size_t uiElemSize) noexcept // REQUIRES the table to be UPPERCASE, and sorted
 {
     // Do a binary search (un-cased) on a sorted table.
@@ -2,6 +2,7 @@
 #define _INC_SSTRING_H
 
 #include <cstring>
+#include <vector>
 #include "../common.h"
 
 #define STRING_NULL     "\0"
@@ -251,6 +252,45 @@ int FindTableHead(const lpctstr pFind, lpctstr const * ppTable, int iCount) noex
 */
 int FindTableHeadSorted(const lpctstr pFind, lpctstr const * ppTable, int iCount) noexcept;
 
+/**
+* @brief Perfect hash index of a constant keyword table (like the sm_szLoadKeys/sm_szVerbKeys ones).
+*
+* Built once, then a lookup costs a single hash of the key and a single comparison, instead of the
+*  log2(iCount) case-insensitive comparisons of the binary search. Returns the same indexes as
+*  FindTableSorted and FindTableHeadSorted. The table must not change after the index is built.
+* Usage (at file scope, after the table definition):
+*  static const CKeyTableIndex sm_LoadKeysIndex(CFoo::sm_szLoadKeys, CountOf(CFoo::sm_szLoadKeys)-1);
+*/
+class CKeyTableIndex
+{
+public:
+    CKeyTableIndex(lpctstr const * ppTable, int iCount);
+
+    /**
+    * @brief Same as FindTableSorted.
+    * @return the index of string if success, -1 otherwise.
+    */
+    int Find(lpctstr pFind) const noexcept;
+
+    /**
+    * @brief Same as FindTableHeadSorted: the table entry is followed by a non-alphanumeric character in pFind.
+    * @return the index of string if success, -1 otherwise.
+    */
+    int FindHead(lpctstr pFind) const noexcept;
+
+private:
+    int _Lookup(lpctstr pFind, size_t uiLen) const noexcept;
+    bool _Build(uint uiSlotsShift);
+
+    lpctstr const * _ppTable;
+    int _iCount;
+    uint _uiBucketMask;
+    uint _uiSlotMask;
+    std::vector<uint> _vDisplacement;   // Per bucket: the seed placing all its keys in free slots.
+    std::vector<int> _vSlots;           // Table index, or -1.
+    std::vector<int> _vNonIdentifiers;  // Entries with characters other than A-Z 0-9 _, which FindHead must check one by one.
+};
+
 /**
 * @param pszIn string to check.
 * @return true if string is empty or has '\c' or '\n' characters, false otherwise.
@@ -1,8 +1,12 @@
 #include "../../common/CLog.h"
+#include "../../sphere/asyncdb.h"
 #include "../../sphere/threads.h"
+#include "../../game/CServer.h"
+#include "../../game/CServerConfig.h"
 #include "../CExpression.h"
 #include "../CException.h"
 #include "../CScript.h"
+#include "../CScriptTriggerArgs.h"
 #include "SQLite.h"
 #include "sqlite3.h"
 
@@ -17,10 +21,17 @@ CSQLite::CSQLite()
 CSQLite::~CSQLite()
 {
 	Close();
+
+	while ( !m_QueryArgs.empty() )
+	{
+		delete m_QueryArgs.front().second;
+		m_QueryArgs.pop();
+	}
 }
 
 int CSQLite::Open( lpctstr strFileName )
 {
+	SimpleThreadLock lock(m_connectionMutex);
 	Close();
 
 	int iErr=sqlite3_open(UTF8MBSTR(strFileName), &m_sqlite3);
@@ -42,6 +53,8 @@ int CSQLite::Open( lpctstr strFileName )
 
 void CSQLite::Close()
 {
+	SimpleThreadLock lock(m_connectionMutex);
+	_ClearStatementCache();
     _sFileName.Empty();
     _fInMemory = false;
 	if (m_sqlite3)
@@ -58,6 +71,7 @@ bool CSQLite::IsOpen()
 
 int CSQLite::QuerySQL( lpctstr strSQL,  CVarDefMap & mapQueryResult )
 {
+	SimpleThreadLock lock(m_connectionMutex);
 	mapQueryResult.Clear();
 	mapQueryResult.SetNumNew("NUMROWS", 0);
 
@@ -94,6 +108,7 @@ err_and_ret:
 
 Table CSQLite::QuerySQL( lpctstr strSQL )
 {
+	SimpleThreadLock lock(m_connectionMutex);
 	if (!IsOpen()) {
 		m_iLastError=SQLITE_ERROR;
 		return Table();
@@ -160,6 +175,7 @@ Table CSQLite::QuerySQL( lpctstr strSQL )
 
 TablePtr CSQLite::QuerySQLPtr( lpctstr strSQL )
 {
+	SimpleThreadLock lock(m_connectionMutex);
 	if (!IsOpen())
     {
 		m_iLastError=SQLITE_ERROR;
@@ -235,6 +251,7 @@ void CSQLite::ConvertUTF8ToVString( const char * strInUTF8MB, stdvstring & strOu
 
 int CSQLite::ExecuteSQL( lpctstr strSQL )
 {
+	SimpleThreadLock lock(m_connectionMutex);
 	if (!IsOpen())
     {
 		m_iLastError=SQLITE_ERROR;
@@ -261,8 +278,173 @@ int CSQLite::IsSQLComplete( lpctstr strSQL )
 	return sqlite3_complete( UTF8MBSTR(strSQL) );
 }
 
+sqlite3_stmt * CSQLite::_GetCachedStatement( lpctstr strSQL )
+{
+	// The caller owns m_connectionMutex.
+	const std::string sKey(strSQL);
+	auto itFound = _mStmtCache.find(sKey);
+	if ( itFound != _mStmtCache.end() )
+	{
+		// Move it to the front of the LRU list.
+		_lStmtCache.splice(_lStmtCache.begin(), _lStmtCache, itFound->second);
+		sqlite3_stmt * pStmt = itFound->second->pStmt;
+		sqlite3_reset(pStmt);
+		sqlite3_clear_bindings(pStmt);
+		return pStmt;
+	}
+
+	sqlite3_stmt * pStmt = nullptr;
+	const char * pcTail = nullptr;
+	UTF8MBSTR sSQL(strSQL);
+	int iErr = sqlite3_prepare_v2(m_sqlite3, sSQL, -1, &pStmt, &pcTail);
+	if ( iErr != SQLITE_OK )
+	{
+		m_iLastError = iErr;
+		g_Log.Event(LOGM_NOCONTEXT|LOGL_ERROR, "SQLite statement \"%s\" failed to compile. Error: %d (%s)\n", strSQL, iErr, sqlite3_errmsg(m_sqlite3));
+		sqlite3_finalize(pStmt);
+		return nullptr;
+	}
+	if ( pStmt == nullptr )	// Empty statement.
+	{
+		m_iLastError = SQLITE_MISUSE;
+		return nullptr;
+	}
+	if ( pcTail )
+	{
+		GETNONWHITESPACE(pcTail);
+		if ( *pcTail != '\0' )
+		{
+			m_iLastError = SQLITE_MISUSE;
+			g_Log.Event(LOGM_NOCONTEXT|LOGL_ERROR, "SQLite statement \"%s\": only a single statement can be prepared.\n", strSQL);
+			sqlite3_finalize(pStmt);
+			return nullptr;
+		}
+	}
+
+	if ( _lStmtCache.size() >= SQLITE_STMT_CACHE_SIZE )
+	{
+		CachedStatement & oldest = _lStmtCache.back();
+		sqlite3_finalize(oldest.pStmt);
+		_mStmtCache.erase(oldest.sSQL);
+		_lStmtCache.pop_back();
+	}
+	_lStmtCache.push_front(CachedStatement{sKey, pStmt});
+	_mStmtCache.emplace(sKey, _lStmtCache.begin());
+	return pStmt;
+}
+
+void CSQLite::_ClearStatementCache()
+{
+	for ( CachedStatement & stmt : _lStmtCache )
+		sqlite3_finalize(stmt.pStmt);
+	_lStmtCache.clear();
+	_mStmtCache.clear();
+}
+
+int CSQLite::_StepPrepared( lpctstr strSQL, const std::vector<CSString> & vArgs, CVarDefMap * pMapQueryResult )
+{
+	SimpleThreadLock lock(m_connectionMutex);
+	if ( pMapQueryResult )
+	{
+		pMapQueryResult->Clear();
+		pMapQueryResult->SetNumNew("NUMROWS", 0);
+	}
+
+	if ( !IsOpen() )
+	{
+		m_iLastError = SQLITE_ERROR;
+		return SQLITE_ERROR;
+	}
+
+	sqlite3_stmt * pStmt = _GetCachedStatement(strSQL);
+	if ( pStmt == nullptr )
+		return m_iLastError;
+
+	const int iParams = sqlite3_bind_parameter_count(pStmt);
+	if ( iParams != (int)vArgs.size() )
+	{
+		m_iLastError = SQLITE_RANGE;
+		g_Log.Event(LOGM_NOCONTEXT|LOGL_ERROR, "SQLite statement \"%s\" needs %d parameters, %" PRIuSIZE_T " given.\n", strSQL, iParams, vArgs.size());
+		return m_iLastError;
+	}
+	for ( int i = 0; i < iParams; ++i )
+	{
+		// Bound as text: the column affinity converts the numbers.
+		UTF8MBSTR sArg(vArgs[i].GetPtr());
+		sqlite3_bind_text(pStmt, i + 1, sArg, -1, SQLITE_TRANSIENT);
+	}
+
+	const int iCols = sqlite3_column_count(pStmt);
+	row vsColNames;
+	if ( pMapQueryResult )
+	{
+		vsColNames.resize(iCols);
+		for ( int iCol = 0; iCol < iCols; ++iCol )
+		{
+			const char * pcName = sqlite3_column_name(pStmt, iCol);
+			if ( pcName )
+				ConvertUTF8ToVString(pcName, vsColNames[iCol]);
+			else
+				vsColNames[iCol].emplace_back('\0');
+		}
+	}
+
+	int iRow = 0;
+	int iErr;
+	char *pcStore = Str_GetTemp();
+	stdvstring vsValue;
+	while ( (iErr = sqlite3_step(pStmt)) == SQLITE_ROW )
+	{
+		if ( pMapQueryResult == nullptr )
+			continue;
+		for ( int iCol = 0; iCol < iCols; ++iCol )
+		{
+			const char * pcValue = reinterpret_cast<const char *>(sqlite3_column_text(pStmt, iCol));
+			vsValue.clear();
+			if ( pcValue )
+				ConvertUTF8ToVString(pcValue, vsValue);
+			else
+				vsValue.emplace_back('\0');
+
+			snprintf(pcStore, STR_TEMPLENGTH, "%d.%d", iRow, iCol);
+			pMapQueryResult->SetStr(pcStore, true, vsValue.data());
+			snprintf(pcStore, STR_TEMPLENGTH, "%d.%s", iRow, vsColNames[iCol].data());
+			pMapQueryResult->SetStr(pcStore, true, vsValue.data());
+		}
+		++iRow;
+	}
+
+	if ( pMapQueryResult && (iRow > 0) )
+	{
+		pMapQueryResult->SetNum("NUMROWS", iRow);
+		pMapQueryResult->SetNum("NUMCOLS", iCols);
+	}
+
+	// Release the read locks now instead of at the next use of the statement.
+	sqlite3_reset(pStmt);
+	if ( iErr != SQLITE_DONE )
+	{
+		m_iLastError = iErr;
+		g_Log.Event(LOGM_NOCONTEXT|LOGL_ERROR, "SQLite statement \"%s\" failed. Error: %d (%s)\n", strSQL, iErr, sqlite3_errmsg(m_sqlite3));
+		return iErr;
+	}
+	m_iLastError = SQLITE_OK;
+	return SQLITE_OK;
+}
+
+int CSQLite::QueryPrepared( lpctstr strSQL, const std::vector<CSString> & vArgs, CVarDefMap & mapQueryResult )
+{
+	return _StepPrepared(strSQL, vArgs, &mapQueryResult);
+}
+
+int CSQLite::ExecutePrepared( lpctstr strSQL, const std::vector<CSString> & vArgs )
+{
+	return _StepPrepared(strSQL, vArgs, nullptr);
+}
+
 int CSQLite::ImportDB(lpctstr strInFileName)
 {
+    SimpleThreadLock lock(m_connectionMutex);
     if (!CSFile::FileExists(strInFileName))
         return SQLITE_CANTOPEN;
     //if (IsStrEmpty(strTable))
@@ -327,6 +509,7 @@ clean_and_ret:
 
 int CSQLite::ExportDB(lpctstr strOutFileName)
 {
+    SimpleThreadLock lock(m_connectionMutex);
     int iErr;
 
     sqlite3 *out_db;
@@ -406,10 +589,76 @@ bool CSQLite::RollbackTransaction()
 	return m_iLastError==SQLITE_OK;
 }
 
+bool CSQLite::addQuery( bool fQuery, lpctstr ptcArgs )
+{
+	// "function, statement, arg1, arg2, ..."
+	tchar * ppArgs[2 + 32];
+	const int iQty = Str_ParseCmds(const_cast<tchar *>(ptcArgs), ppArgs, CountOf(ppArgs), ",");
+	if ( iQty < 2 )
+	{
+		DEBUG_ERR(("Not enough arguments for %s\n", fQuery ? "AQUERY" : "AEXECUTE"));
+		return false;
+	}
+
+	// The callback is optional for AEXECUTE: "" when the result doesn't matter.
+	lpctstr ptcFunction = Str_GetUnQuoted(ppArgs[0]);
+	if ( ((ptcFunction[0] != '\0') || fQuery) && !g_Cfg.m_Functions.ContainsKey(ptcFunction) )
+	{
+		DEBUG_ERR(("Invalid callback function (%s) for AEXECUTE/AQUERY.\n", ptcFunction));
+		return false;
+	}
+	if ( !IsOpen() )
+	{
+		DEBUG_ERR(("SQLite database is not open, can't queue the statement.\n"));
+		return false;
+	}
+
+	std::vector<CSString> vArgs;
+	vArgs.reserve(iQty - 2);
+	for ( int i = 2; i < iQty; ++i )
+		vArgs.emplace_back(Str_GetUnQuoted(ppArgs[i]));
+
+	if ( !g_asyncLdb.isActive() )
+		g_asyncLdb.start();
+
+	g_asyncLdb.addQuery(this, fQuery, ptcFunction, Str_GetUnQuoted(ppArgs[1]), std::move(vArgs));
+	return true;
+}
+
+void CSQLite::addQueryResult( CSString & sFunction, CScriptTriggerArgs * pResult )
+{
+	SimpleThreadLock lock(m_resultMutex);
+	m_QueryArgs.push(FunctionArgsPair_t(sFunction, pResult));
+}
+
+void CSQLite::OnTick()
+{
+	ADDTOCALLSTACK("CSQLite::OnTick");
+	QueueFunction_t queueResults;
+	{
+		// The worker thread pushes the results under this lock: the queue can't be looked at without it.
+		SimpleThreadLock lock(m_resultMutex);
+		if ( m_QueryArgs.empty() )
+			return;
+		queueResults.swap(m_QueryArgs);
+	}
+
+	while ( !queueResults.empty() )
+	{
+		FunctionArgsPair_t & currentPair = queueResults.front();
+		ASSERT(currentPair.second != nullptr);
+		g_Serv.r_Call(currentPair.first, &g_Serv, currentPair.second);
+		delete currentPair.second;
+		queueResults.pop();
+	}
+}
+
 // CScriptObj functions
 
 enum LDBO_TYPE
 {
+	LDBO_AEXECUTE,
+	LDBO_AQUERY,
 	LDBO_CONNECTED,
     LDBO_FILENAME,
 	LDBO_ROW,
@@ -418,6 +667,8 @@ enum LDBO_TYPE
 
 lpctstr const CSQLite::sm_szLoadKeys[LDBO_QTY+1] =
 {
+	"AEXECUTE",
+	"AQUERY",
 	"CONNECTED",
     "FILENAME",
 	"ROW",
@@ -429,9 +680,11 @@ enum LDBOV_TYPE
 	LDBOV_CLOSE,
 	LDBOV_CONNECT,
 	LDBOV_EXECUTE,
+	LDBOV_EXECUTEPREPARED,
     LDBOV_EXPORTDB,
     LDBOV_IMPORTDB,
 	LDBOV_QUERY,
+	LDBOV_QUERYPREPARED,
 	LDBOV_QTY
 };
 
@@ -440,9 +693,11 @@ lpctstr const CSQLite::sm_szVerbKeys[LDBOV_QTY+1] =
 	"CLOSE",
 	"CONNECT",
 	"EXECUTE",
+	"EXECUTEPREPARED",
     "EXPORTDB",
     "IMPORTDB",
 	"QUERY",
+	"QUERYPREPARED",
 	nullptr
 };
 
@@ -471,6 +726,13 @@ bool CSQLite::r_WriteVal(lpctstr ptcKey, CSString &sVal, CTextConsole *pSrc, boo
 	int index = FindTableHeadSorted(ptcKey, sm_szLoadKeys, CountOf(sm_szLoadKeys)-1);
 	switch ( index )
 	{
+		case LDBO_AEXECUTE:
+		case LDBO_AQUERY:
+			ptcKey += strlen(sm_szLoadKeys[index]);
+			GETNONWHITESPACE(ptcKey);
+			sVal.FormatVal(addQuery((index == LDBO_AQUERY), ptcKey));
+			break;
+
 		case LDBO_CONNECTED:
 			sVal.FormatVal(IsOpen());
 			break;
@@ -536,6 +798,24 @@ bool CSQLite::r_Verb(CScript & s, CTextConsole * pSrc)
 			QuerySQL(s.GetArgRaw(), m_QueryResult);
 			break;
 
+		case LDBOV_EXECUTEPREPARED:
+		case LDBOV_QUERYPREPARED:
+		{
+			// "statement, arg1, arg2, ..."
+			tchar * ppArgs[1 + 32];
+			const int iQty = Str_ParseCmds(s.GetArgRaw(), ppArgs, CountOf(ppArgs), ",");
+			if ( iQty < 1 )
+				return false;
+			std::vector<CSString> vArgs;
+			vArgs.reserve(iQty - 1);
+			for ( int i = 1; i < iQty; ++i )
+				vArgs.emplace_back(Str_GetUnQuoted(ppArgs[i]));
+			if ( index == LDBOV_QUERYPREPARED )
+				QueryPrepared(Str_GetUnQuoted(ppArgs[0]), vArgs, m_QueryResult);
+			else
+				ExecutePrepared(Str_GetUnQuoted(ppArgs[0]), vArgs);
+		} break;
+
 		default:
 			return false;
 	}
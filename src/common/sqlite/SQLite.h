@@ -7,11 +7,19 @@
 #define _INC_SQLITE_H
 
 #include "../sphere_library/CSString.h"
+#include "../sphere_library/smutex.h"
 #include "../CScriptObj.h"
 #include "../CVarDefMap.h"
+#include <list>
+#include <queue>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 
+#define SQLITE_STMT_CACHE_SIZE	32	// Prepared statements kept for reuse by each connection.
+
+
 //////////////////////////////////////////////////////////////////////////
 // Typedefs
 //////////////////////////////////////////////////////////////////////////
@@ -27,6 +35,7 @@ typedef vstrlist row;
 
 // Forward declarations
 struct sqlite3;
+struct sqlite3_stmt;
 class Table; 
 class TablePtr;
 
@@ -55,6 +64,10 @@ public:
 	int ExecuteSQL( lpctstr strSQL );
 	int IsSQLComplete( lpctstr strSQL );
 
+	// Single statement, with the ? parameters bound to vArgs (as text). The compiled statement is cached and reused.
+	int QueryPrepared( lpctstr strSQL, const std::vector<CSString> & vArgs, CVarDefMap & mapQueryResult );
+	int ExecutePrepared( lpctstr strSQL, const std::vector<CSString> & vArgs );
+
     int ImportDB(lpctstr strInFileName);
     int ExportDB(lpctstr strOutFileName);
 
@@ -66,6 +79,9 @@ public:
 	bool CommitTransaction();
 	bool RollbackTransaction();
 
+	void addQueryResult( CSString & sFunction, CScriptTriggerArgs * pResult );
+	void OnTick();
+
 
 	virtual bool r_GetRef( lpctstr & ptcKey, CScriptObj * & pRef ) override;
 	virtual bool r_LoadVal( CScript & s ) override;
@@ -82,12 +98,36 @@ public:
 	static lpctstr const sm_szVerbKeys[];
 
 private:
+	friend class CSQLiteAsyncHelper;
+
+	typedef std::pair<CSString, CScriptTriggerArgs *> FunctionArgsPair_t;
+	typedef std::queue<FunctionArgsPair_t> QueueFunction_t;
+
+	struct CachedStatement
+	{
+		std::string sSQL;
+		sqlite3_stmt * pStmt;
+	};
+	typedef std::list<CachedStatement> StmtList_t;
+
 	sqlite3 * m_sqlite3;
 	int m_iLastError;
 
     CSString _sFileName;
     bool _fInMemory;
 
+	SimpleMutex m_connectionMutex;	// The async helper uses the connection too.
+	SimpleMutex m_resultMutex;
+	QueueFunction_t m_QueryArgs;
+
+	StmtList_t _lStmtCache;		// Most recently used first.
+	std::unordered_map<std::string, StmtList_t::iterator> _mStmtCache;
+
+	bool addQuery( bool fQuery, lpctstr ptcArgs );
+	sqlite3_stmt * _GetCachedStatement( lpctstr strSQL );
+	void _ClearStatementCache();
+	int _StepPrepared( lpctstr strSQL, const std::vector<CSString> & vArgs, CVarDefMap * pMapQueryResult );
+
 	static void ConvertUTF8ToVString( const char * strInUTF8MB, stdvstring & strOut );
 };
 
@@ -1,2 +1,2 @@
-#define __GITHASH__ "c5c32b831977fb9b2fc8182b9cb1873f5abe3869"
-#define __GITREVISION__ 3283
+#define __GITHASH__ "58efe77bcffed8dc6c3f704460922251944b4604"
+#define __GITREVISION__ 35
@@ -22,6 +22,7 @@ lpctstr const CBaseBaseDef::sm_szLoadKeys[OBC_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CBaseBaseDef::sm_LoadKeysIndex(CBaseBaseDef::sm_szLoadKeys, CountOf(CBaseBaseDef::sm_szLoadKeys)-1);
 
 
 CFactionDef CBaseBaseDef::GetFaction()
@@ -113,7 +114,7 @@ bool CBaseBaseDef::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * p
 	EXC_TRY("WriteVal");
 
 	bool fZero = false;
-	int index = FindTableHeadSorted( ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 );
+	int index = sm_LoadKeysIndex.FindHead(ptcKey);
 	switch ( index )
 	{
 		//return as string or hex number or nullptr if not set
@@ -305,7 +306,7 @@ bool CBaseBaseDef::r_LoadVal( CScript & s )
         }
     }
 
-    int i = FindTableSorted(ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 );
+    int i = sm_LoadKeysIndex.Find(ptcKey);
 	switch (i)
 	{
 		//Set as Strings
@@ -21,6 +21,7 @@ struct CBaseBaseDef : public CResourceLink, public CEntityProps
 
 	// TAGS
 	static lpctstr const sm_szLoadKeys[];
+	static const CKeyTableIndex sm_LoadKeysIndex;
 	// Base type of both CItemBase and CCharBase
 protected:
 	dword       m_dwDispIndex;	// The base artwork id. (may be the same as GetResourceID() in base set.) but can also be "flipped"
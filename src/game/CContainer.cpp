@@ -34,6 +34,7 @@ void CContainer::ContentDelete(bool fForce)
     //	other objects are deleted and appended to this list, thus invalidating the iterators used by the for loop.
     const auto stateCopy = GetIterationSafeContReverse();
     _Contents.clear();
+    InvalidateResourceTotals();
 
     for (CSObjContRec* pRec : stateCopy)	// iterate the list.
     {
@@ -119,6 +120,7 @@ void CContainer::ContentAddPrivate( CItem *pItem )
 		return;
 
 	CSObjCont::InsertContentTail( pItem );
+	InvalidateResourceTotals();
 	OnWeightChange(pItem->GetWeight());
 }
 
@@ -134,9 +136,100 @@ void CContainer::OnRemoveObj( CSObjContRec *pObRec )	// Override this = called w
 	ASSERT(pItem->GetParent() == nullptr);
 
 	pItem->SetUIDContainerFlags(UID_O_DISCONNECT);		// It is no place for the moment.
+	InvalidateResourceTotals();
 	OnWeightChange(-pItem->GetWeight());
 }
 
+void CContainer::InvalidateResourceTotals()
+{
+	// A container whose totals aren't built isn't part of the totals of its parents either
+	//  (they are built together, or the parent is locked out), so we can stop there.
+	CContainer *pCont = this;
+	while ( pCont && pCont->_pResourceTotals )
+	{
+		pCont->_pResourceTotals.reset();
+		const CItemContainer *pItemCont = dynamic_cast<const CItemContainer *>(pCont);
+		pCont = pItemCont ? dynamic_cast<CContainer *>(pItemCont->GetParent()) : nullptr;
+	}
+}
+
+const CContainer::ResourceTotals & CContainer::GetResourceTotals() const
+{
+	ADDTOCALLSTACK("CContainer::GetResourceTotals");
+	if ( _pResourceTotals )
+		return *_pResourceTotals;
+
+	std::unique_ptr<ResourceTotals> pTotals = std::make_unique<ResourceTotals>();
+	pTotals->_iGold = 0;
+	for (const CSObjContRec* pObjRec : *this)
+	{
+		const CItem* pItem = static_cast<const CItem*>(pObjRec);
+		const int64 iAmount = pItem->GetAmount();
+		pTotals->_mapTotals[pItem->Item_GetDef()->GetResourceID().GetPrivateUID()] += iAmount;
+		pTotals->_mapTotals[CResourceID(RES_TYPEDEF, pItem->GetType()).GetPrivateUID()] += iAmount;
+		if ( pItem->IsType(IT_GOLD) )
+			pTotals->_iGold += iAmount;
+
+		const CItemContainer *pCont = dynamic_cast<const CItemContainer *>(pItem);
+		if ( !pCont )
+			continue;
+		if ( pCont->IsType(IT_CONTAINER_LOCKED) )
+			continue;	// neither searchable nor good for gold: not built, see InvalidateResourceTotals.
+		const ResourceTotals & contTotals = pCont->GetResourceTotals();
+		pTotals->_iGold += contTotals._iGold;
+		if ( !pCont->IsSearchable() )
+			continue;
+		for ( const std::pair<const dword, int64> & total : contTotals._mapTotals )
+			pTotals->_mapTotals[total.first] += total.second;
+	}
+
+	_pResourceTotals = std::move(pTotals);
+	return *_pResourceTotals;
+}
+
+int64 CContainer::GetResourceTotal( const CResourceID& rid, dword dwArg ) const
+{
+	ADDTOCALLSTACK("CContainer::GetResourceTotal");
+	if ( !IsSetEF(EF_ContainerTotals) )
+		return -1;
+	if ( rid.GetResPage() != 0 )
+		return -1;
+
+	const RES_TYPE restype = rid.GetResType();
+	if ( restype == RES_TYPEDEF )
+	{
+		if ( dwArg )
+			return -1;	// specific maps and keys.
+		if ( rid == CResourceID(RES_TYPEDEF, IT_GOLD) )
+			return GetResourceTotals()._iGold;
+	}
+	else if ( restype != RES_ITEMDEF )
+	{
+		return -1;
+	}
+
+	const ResourceTotals & totals = GetResourceTotals();
+	std::unordered_map<dword, int64>::const_iterator it = totals._mapTotals.find(rid.GetPrivateUID());
+	int64 iTotal = (it == totals._mapTotals.end()) ? 0 : it->second;
+
+	if ( (restype == RES_ITEMDEF) && !IsSetEF(EF_Item_Strict_Comparison) )
+	{
+		// Same special cases of CItem::IsResourceMatch.
+		ITEMID_TYPE idAlias = ITEMID_NOTHING;
+		if ( rid.GetResIndex() == ITEMID_LOG_1 )
+			idAlias = ITEMID_BOARD1;	// boards can be used as logs
+		else if ( rid.GetResIndex() == ITEMID_HIDES )
+			idAlias = ITEMID_LEATHER_1;	// leather can be used as hide
+		if ( idAlias != ITEMID_NOTHING )
+		{
+			it = totals._mapTotals.find(CResourceID(RES_ITEMDEF, idAlias).GetPrivateUID());
+			if ( it != totals._mapTotals.end() )
+				iTotal += it->second;
+		}
+	}
+	return iTotal;
+}
+
 void CContainer::r_WriteContent( CScript &s ) const
 {
 	ADDTOCALLSTACK("CContainer::r_WriteContent");
@@ -158,6 +251,8 @@ CItem *CContainer::ContentFind( CResourceID rid, dword dwArg, int iDecendLevels
 
 	if ( rid.GetResIndex() == 0 )
 		return nullptr;
+	if ( GetResourceTotal(rid, dwArg) == 0 )
+		return nullptr;
 
 	for (CSObjContRec* pObjRec : *this)
 	{
@@ -318,6 +413,10 @@ int CContainer::ContentConsumeTest( const CResourceID& rid, int amount, dword dw
     if ( rid.GetResIndex() == 0 )
         return amount;	// from skills menus.
 
+    const int64 iTotal = GetResourceTotal(rid, dwArg);
+    if ( iTotal >= 0 )
+        return (int)(amount - minimum(iTotal, (int64)amount));
+
 	for (const CSObjContRec* pObjRec : *this)
 	{
 		const CItem* pItem = static_cast<const CItem*>(pObjRec);
@@ -362,6 +461,8 @@ int CContainer::ContentConsume( const CResourceID& rid, int amount, dword dwArg
 
 	if ( rid.GetResIndex() == 0 )
 		return amount;	// from skills menus.
+	if ( GetResourceTotal(rid, dwArg) == 0 )
+		return amount;	// nothing here, don't look in every sub-container.
 
 	for (size_t i = 0; i < GetContentCount();)
 	{
@@ -10,6 +10,8 @@
 #include "../common/resource/CResourceBase.h"
 #include "../common/CUID.h"
 #include "../common/CRect.h"
+#include <memory>
+#include <unordered_map>
 
 
 class CItemContainer;
@@ -28,6 +30,31 @@ private:
 public:
     int	m_totalweight;      // weight of all the items it has. (1/WEIGHT_UNITS pound)
 
+private:
+    // Amounts of the items inside, sub containers included (EF_ContainerTotals).
+    struct ResourceTotals
+    {
+        std::unordered_map<dword, int64> _mapTotals;  // By item base id and by item type (private uid of the CResourceID), following the IsSearchable rules.
+        int64 _iGold;                                 // t_gold, searched also in the containers not searchable but unlocked (like ContentConsume does).
+    };
+    mutable std::unique_ptr<ResourceTotals> _pResourceTotals;  // Built when needed, dropped when something inside changes.
+
+    const ResourceTotals & GetResourceTotals() const;
+
+    /**
+     * @fn  int64 CContainer::GetResourceTotal( const CResourceID& rid, dword dwArg ) const;
+     * @brief   Total amount of the items matching the resource (like IsResourceMatch) in this container and the sub containers.
+     * @return  -1 if the totals can't be used for this resource (or they are disabled).
+     */
+    int64 GetResourceTotal( const CResourceID& rid, dword dwArg ) const;
+
+public:
+    /**
+     * @fn  void CContainer::InvalidateResourceTotals();
+     * @brief   Something inside changed (added, removed, amount/type/id changed): drop the totals of this and the parent containers.
+     */
+    void InvalidateResourceTotals();
+
 
 public:
     void ContentDelete(bool fForce);
@@ -3,6 +3,7 @@
 #include "../common/CException.h"
 #include "../common/sphereversion.h"
 #include "../common/CLog.h"
+#include "../common/sphere_library/CSSlabPool.h"
 #include "../network/CClientIterator.h"
 #include "../network/send.h"
 #include "../sphere/ProfileTask.h"
@@ -137,6 +138,30 @@ CObjBase::~CObjBase()
 	SetUID( UID_UNUSED, false );
 }
 
+CSSlabPool & CObjBase::GetObjPool()
+{
+	// Never destroyed: objects are still deleted after the static objects are gone.
+	static CSSlabPool * const sm_pPool = new CSSlabPool();
+	return *sm_pPool;
+}
+
+void * CObjBase::operator new( size_t uiSize )
+{
+	if ( IsSetEF(EF_ObjectPools) )
+	{
+		if ( void * pObj = GetObjPool().Alloc(uiSize) )
+			return pObj;
+	}
+	return ::operator new(uiSize);
+}
+
+void CObjBase::operator delete( void * pObj )
+{
+	// The flag may have changed since the allocation: the pool knows its own blocks.
+	if ( (pObj != nullptr) && !GetObjPool().Free(pObj) )
+		::operator delete(pObj);
+}
+
 bool CObjBase::IsDeleted() const
 {
 	return (!GetUID().IsValidUID() || (GetParent() == &g_World.m_ObjDelete));
@@ -764,11 +789,12 @@ lpctstr const CObjBase::sm_szRefKeys[OBR_QTY+1] =
 	"TYPEDEF",
 	nullptr
 };
+const CKeyTableIndex CObjBase::sm_RefKeysIndex(CObjBase::sm_szRefKeys, CountOf(CObjBase::sm_szRefKeys)-1);
 
 bool CObjBase::r_GetRef( lpctstr & ptcKey, CScriptObj * & pRef )
 {
 	ADDTOCALLSTACK("CObjBase::r_GetRef");
-	int i = FindTableHeadSorted( ptcKey, sm_szRefKeys, CountOf(sm_szRefKeys)-1 );
+	int i = sm_RefKeysIndex.FindHead(ptcKey);
 	if ( i >= 0 )
 	{
 		ptcKey += strlen( sm_szRefKeys[i] );
@@ -821,13 +847,14 @@ lpctstr const CObjBase::sm_szLoadKeys[OC_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CObjBase::sm_LoadKeysIndex(CObjBase::sm_szLoadKeys, CountOf(CObjBase::sm_szLoadKeys)-1);
 
 bool CObjBase::r_WriteVal( lpctstr ptcKey, CSString &sVal, CTextConsole * pSrc, bool fNoCallParent, bool fNoCallChildren )
 {
 	ADDTOCALLSTACK("CObjBase::r_WriteVal");
 	EXC_TRY("WriteVal");
 
-    int index = FindTableHeadSorted( ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 );
+    int index = sm_LoadKeysIndex.FindHead(ptcKey);
     if ( !fNoCallChildren && (index < 0) )
     {
         const size_t uiFunctionIndex = r_GetFunctionIndex(ptcKey);
@@ -1625,7 +1652,7 @@ bool CObjBase::r_LoadVal( CScript & s )
         }
     }
 
-	int index = FindTableSorted( ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 );
+	int index = sm_LoadKeysIndex.Find(ptcKey);
 	if ( index < 0 )
 	{
         return CScriptObj::r_LoadVal(s);
@@ -1903,6 +1930,7 @@ lpctstr const CObjBase::sm_szVerbKeys[OV_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CObjBase::sm_VerbKeysIndex(CObjBase::sm_szVerbKeys, CountOf(CObjBase::sm_szVerbKeys)-1);
 
 bool CObjBase::r_Verb( CScript & s, CTextConsole * pSrc ) // Execute command from script
 {
@@ -1923,7 +1951,7 @@ bool CObjBase::r_Verb( CScript & s, CTextConsole * pSrc ) // Execute command fro
 	if ( !strnicmp( ptcKey, "TARGET", 6 ) )
 		index = OV_TARGET;
 	else
-		index = FindTableSorted( ptcKey, sm_szVerbKeys, CountOf(sm_szVerbKeys)-1 );
+		index = sm_VerbKeysIndex.Find(ptcKey);
     if (index < 0)
     {
         const size_t uiFunctionIndex = r_GetFunctionIndex(ptcKey);
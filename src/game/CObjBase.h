@@ -20,12 +20,16 @@
 class PacketSend;
 class PacketPropertyList;
 class CCSpawn;
+class CSSlabPool;
 
 class CObjBase : public CObjBaseTemplate, public CScriptObj, public CEntity, public CEntityProps, public virtual CTimedObject
 {
 	static lpctstr const sm_szLoadKeys[];   // All Instances of CItem or CChar have these base attributes.
+	static const CKeyTableIndex sm_LoadKeysIndex;
 	static lpctstr const sm_szVerbKeys[];   // All Instances of CItem or CChar have these base attributes.
+	static const CKeyTableIndex sm_VerbKeysIndex;
 	static lpctstr const sm_szRefKeys[];    // All Instances of CItem or CChar have these base attributes.
+	static const CKeyTableIndex sm_RefKeysIndex;
 
 private:
 	int64 m_timestamp;          // TimeStamp
@@ -67,6 +71,12 @@ private:
     CObjBase(const CObjBase& copy);
     CObjBase& operator=(const CObjBase& other);
 
+public:
+    // With EF_ObjectPools, items and chars are allocated from GetObjPool(): each concrete class gets its own size class.
+    static void * operator new(size_t uiSize);
+    static void operator delete(void * pObj);
+    static CSSlabPool & GetObjPool();
+
 protected:
     /**
      * @fn  virtual void CObjBase::DeletePrepare();
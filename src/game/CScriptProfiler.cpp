@@ -0,0 +1,331 @@
+#include "../common/resource/CResourceBase.h"
+#include "../common/resource/CResourceLink.h"
+#include "../common/sphere_library/CSFileText.h"
+#include "../common/CLog.h"
+#include "../common/CScript.h"
+#include "../common/CTextConsole.h"
+#include "CScriptProfiler.h"
+#include "CServer.h"
+#include <algorithm>
+
+
+//*******************************************************
+// CScriptProfilerHistogram
+
+void CScriptProfilerHistogram::Clear()
+{
+	memset(_uiBuckets, 0, sizeof(_uiBuckets));
+}
+
+uint CScriptProfilerHistogram::GetBucket( llong iMicro ) // static
+{
+	// The first buckets are exact (0, 1, 2, 3 us), then each power of 2 is split in (1 << SCRIPTPROFILER_SUBBUCKETS_SHIFT) buckets.
+	if ( iMicro < (1 << SCRIPTPROFILER_SUBBUCKETS_SHIFT) )
+		return (iMicro > 0) ? (uint)iMicro : 0;
+
+	const ullong uiVal = (ullong)iMicro;
+	uint uiExp = 0;
+	while ( (uiVal >> uiExp) >= (2u << SCRIPTPROFILER_SUBBUCKETS_SHIFT) )
+		++uiExp;
+	const uint uiBucket = ((uiExp + 1) << SCRIPTPROFILER_SUBBUCKETS_SHIFT) + (uint)((uiVal >> uiExp) - (1u << SCRIPTPROFILER_SUBBUCKETS_SHIFT));
+	return std::min(uiBucket, (uint)(SCRIPTPROFILER_BUCKETS - 1));
+}
+
+llong CScriptProfilerHistogram::GetBucketUpperBound( uint uiBucket ) // static
+{
+	if ( uiBucket < (1 << SCRIPTPROFILER_SUBBUCKETS_SHIFT) )
+		return uiBucket;
+
+	const uint uiExp = (uiBucket >> SCRIPTPROFILER_SUBBUCKETS_SHIFT) - 1;
+	const ullong uiMantissa = (1u << SCRIPTPROFILER_SUBBUCKETS_SHIFT) + (uiBucket & ((1u << SCRIPTPROFILER_SUBBUCKETS_SHIFT) - 1));
+	return (llong)(((uiMantissa + 1) << uiExp) - 1);
+}
+
+void CScriptProfilerHistogram::Add( llong iMicro )
+{
+	++_uiBuckets[GetBucket(iMicro)];
+}
+
+llong CScriptProfilerHistogram::GetPercentile( uint uiPercent, dword dwCount ) const
+{
+	if ( dwCount == 0 )
+		return 0;
+
+	// Rank of the sample, rounding up: p50 of 3 samples is the 2nd one.
+	const ullong uiRank = std::max<ullong>(1, ((ullong)dwCount * uiPercent + 99) / 100);
+	ullong uiSeen = 0;
+	for ( uint i = 0; i < SCRIPTPROFILER_BUCKETS; ++i )
+	{
+		uiSeen += _uiBuckets[i];
+		if ( uiSeen >= uiRank )
+			return GetBucketUpperBound(i);
+	}
+	return GetBucketUpperBound(SCRIPTPROFILER_BUCKETS - 1);
+}
+
+
+//*******************************************************
+// CScriptProfilerEntry
+
+CScriptProfilerEntry::CScriptProfilerEntry( lpctstr pszName ) : m_sName(pszName)
+{
+	Clear();
+}
+
+void CScriptProfilerEntry::Clear()
+{
+	m_called = 0;
+	m_total = m_min = m_max = 0;
+	m_histogram.Clear();
+}
+
+void CScriptProfilerEntry::Add( llong iMicro )
+{
+	++m_called;
+	m_total += iMicro;
+	if ( m_max < iMicro )
+		m_max = iMicro;
+	if (( m_min > iMicro ) || ( m_called == 1 ))
+		m_min = iMicro;
+	m_histogram.Add(iMicro);
+}
+
+
+//*******************************************************
+// CScriptProfiler
+
+static inline bool ScriptProfiler_IsNameEnd( tchar ch )
+{
+	return (ch == '\0') || (ch == ' ');
+}
+
+static size_t ScriptProfiler_HashName( lpctstr pszName, bool fStopAtSpace )
+{
+	// FNV-1a, case insensitive.
+	size_t uiHash = (size_t)2166136261u;
+	for ( ; fStopAtSpace ? !ScriptProfiler_IsNameEnd(*pszName) : (*pszName != '\0'); ++pszName )
+	{
+		uiHash ^= (size_t)(uchar)tolower(*pszName);
+		uiHash *= (size_t)16777619u;
+	}
+	return uiHash;
+}
+
+size_t CScriptProfiler::NameKeyHash::operator()( const NameKey & key ) const
+{
+	return ScriptProfiler_HashName(key.m_pszName, true);
+}
+
+bool CScriptProfiler::NameKeyEqual::operator()( const NameKey & key1, const NameKey & key2 ) const
+{
+	lpctstr pszName1 = key1.m_pszName, pszName2 = key2.m_pszName;
+	for ( ; !ScriptProfiler_IsNameEnd(*pszName1); ++pszName1, ++pszName2 )
+	{
+		if ( tolower(*pszName1) != tolower(*pszName2) )
+			return false;
+	}
+	return ScriptProfiler_IsNameEnd(*pszName2);
+}
+
+CScriptProfiler::CScriptProfiler() : called(0), total(0)
+{
+}
+
+CScriptProfilerEntry * CScriptProfiler::_AddEntry( PROFILE_KIND kind, lpctstr pszName )
+{
+	_vEntries[kind].emplace_back(std::make_unique<CScriptProfilerEntry>(pszName));
+	return _vEntries[kind].back().get();
+}
+
+CScriptProfilerEntry * CScriptProfiler::GetFunction( lpctstr pszName )
+{
+	ADDTOCALLSTACK("CScriptProfiler::GetFunction");
+	NameMap::const_iterator it = _mapFunctions.find(NameKey{pszName});
+	if ( it != _mapFunctions.end() )
+		return it->second;
+
+	// first time function called. so create a record for it (lowercase, without the arguments).
+	// The whole name is kept, so that the next lookups match it.
+	size_t uiLength = 0;
+	while ( !ScriptProfiler_IsNameEnd(pszName[uiLength]) )
+		++uiLength;
+	CSString sName;
+	sName.CopyLen(pszName, (int)uiLength);
+	sName.MakeLower();
+
+	CScriptProfilerEntry * pEntry = _AddEntry(PK_FUNCTION, sName.GetPtr());
+	_mapFunctions.emplace(NameKey{pEntry->m_sName.GetPtr()}, pEntry);
+	return pEntry;
+}
+
+CScriptProfilerEntry * CScriptProfiler::GetTrigger( lpctstr pszName )
+{
+	ADDTOCALLSTACK("CScriptProfiler::GetTrigger");
+	NameMap::const_iterator it = _mapTriggers.find(NameKey{pszName});
+	if ( it != _mapTriggers.end() )
+		return it->second;
+
+	CSString sName(pszName);
+	sName.MakeLower();
+
+	CScriptProfilerEntry * pEntry = _AddEntry(PK_TRIGGER, sName.GetPtr());
+	_mapTriggers.emplace(NameKey{pEntry->m_sName.GetPtr()}, pEntry);
+	return pEntry;
+}
+
+CScriptProfilerEntry * CScriptProfiler::GetResource( const CResourceLink * pLink )
+{
+	ADDTOCALLSTACK("CScriptProfiler::GetResource");
+	if ( pLink == nullptr )
+		return nullptr;
+
+	const CResourceID& rid = pLink->GetResourceID();
+	const ullong uiKey = ((ullong)rid.GetPrivateUID() << 16) | rid.GetResPage();
+	IdMap::const_iterator it = _mapResources.find(uiKey);
+	if ( it != _mapResources.end() )
+		return it->second;
+
+	tchar szName[128];
+	snprintf(szName, sizeof(szName), "%s %s", CResourceBase::GetResourceBlockName(rid.GetResType()), pLink->GetResourceName());
+
+	CScriptProfilerEntry * pEntry = _AddEntry(PK_RESOURCE, szName);
+	_mapResources.emplace(uiKey, pEntry);
+	return pEntry;
+}
+
+CScriptProfilerEntry * CScriptProfiler::GetLine( const CScript & s )
+{
+	ADDTOCALLSTACK("CScriptProfiler::GetLine");
+	const int iLine = s.GetContext().m_iLineNum;
+	ullong uiFile = (uint)s.m_iResourceFileIndex;
+	if ( s.m_iResourceFileIndex < 0 )	// Not one of the resource files, tell them apart by name.
+		uiFile = (ScriptProfiler_HashName(s.GetFilePath(), false) & 0x7FFFFFFF) | 0x80000000u;
+	const ullong uiKey = (uiFile << 32) | (uint)iLine;
+	IdMap::const_iterator it = _mapLines.find(uiKey);
+	if ( it != _mapLines.end() )
+		return it->second;
+
+	tchar szName[_MAX_PATH + 16];
+	snprintf(szName, sizeof(szName), "%s:%d", s.GetFileTitle(), iLine);
+
+	CScriptProfilerEntry * pEntry = _AddEntry(PK_LINE, szName);
+	_mapLines.emplace(uiKey, pEntry);
+	return pEntry;
+}
+
+void CScriptProfiler::Clear()
+{
+	ADDTOCALLSTACK("CScriptProfiler::Clear");
+	for ( int i = 0; i < PK_QTY; ++i )
+	{
+		for ( std::unique_ptr<CScriptProfilerEntry>& pEntry : _vEntries[i] )
+			pEntry->Clear();
+	}
+	total = called = 0;
+}
+
+static void ScriptProfiler_Print( CTextConsole * pSrc, CSFileText * pFile, lpctstr pszMsg )
+{
+	if ( pSrc != &g_Serv )
+		pSrc->SysMessage(pszMsg);
+	else
+		g_Log.Event(LOGL_EVENT, "%s", pszMsg);
+	if ( pFile != nullptr )
+		pFile->Printf("%s", pszMsg);
+}
+
+void CScriptProfiler::Dump( CTextConsole * pSrc, CSFileText * pFile ) const
+{
+	ADDTOCALLSTACK("CScriptProfiler::Dump");
+	static lpctstr const sm_szKindNames[PK_QTY] = { "FUNCTION", "TRIGGER", "RESOURCE", "LINE" };
+
+	const long double average = called ? ((long double)total / called) : 0;
+	char tmpstring[512];
+	snprintf(tmpstring, sizeof(tmpstring), "Scripts: called %u times and took a total of %.4f seconds (%.3Lf ms average). Reporting with highest average.\n",
+		called,
+		(total   / 1000000.0),
+		(average / 1000.0));
+	ScriptProfiler_Print(pSrc, pFile, tmpstring);
+
+	std::vector<const CScriptProfilerEntry *> vReport;
+	for ( int i = 0; i < PK_QTY; ++i )
+	{
+		vReport.clear();
+		for ( const std::unique_ptr<CScriptProfilerEntry>& pEntry : _vEntries[i] )
+		{
+			if ( pEntry->m_called == 0 )
+				continue;
+			if ( (i <= PK_TRIGGER) && (pEntry->GetAverage() <= average) )
+				continue;
+			vReport.push_back(pEntry.get());
+		}
+		if ( i > PK_TRIGGER )
+		{
+			// Resources and lines are many more: show only the ones that took the most time.
+			std::sort(vReport.begin(), vReport.end(),
+				[](const CScriptProfilerEntry * pEntry1, const CScriptProfilerEntry * pEntry2) { return pEntry1->m_total > pEntry2->m_total; });
+			if ( vReport.size() > SCRIPTPROFILER_REPORT_TOP )
+				vReport.resize(SCRIPTPROFILER_REPORT_TOP);
+		}
+
+		for ( const CScriptProfilerEntry * pEntry : vReport )
+		{
+			snprintf(tmpstring, sizeof(tmpstring), "%s '%s' called %u times, took %.3f ms average (p50 %.3f, p95 %.3f, p99 %.3f, min %.3f, max %.3f ms), total: %.4f s.\n",
+				sm_szKindNames[i],
+				pEntry->m_sName.GetPtr(),
+				pEntry->m_called,
+				(pEntry->GetAverage()      / 1000.0),
+				(pEntry->GetPercentile(50) / 1000.0),
+				(pEntry->GetPercentile(95) / 1000.0),
+				(pEntry->GetPercentile(99) / 1000.0),
+				(pEntry->m_min             / 1000.0),
+				(pEntry->m_max             / 1000.0),
+				(pEntry->m_total           / 1000000.0));
+			ScriptProfiler_Print(pSrc, pFile, tmpstring);
+		}
+	}
+}
+
+bool CScriptProfiler::DumpCSV( lpctstr pszFilePath ) const
+{
+	ADDTOCALLSTACK("CScriptProfiler::DumpCSV");
+	static lpctstr const sm_szKindNames[PK_QTY] = { "function", "trigger", "resource", "line" };
+
+	CSFileText fileCSV;
+	if ( !fileCSV.Open(pszFilePath, OF_CREATE|OF_TEXT) )
+		return false;
+
+	// Times are in microseconds, the percentiles are the upper bounds of the histogram buckets.
+	fileCSV.Printf("kind,name,called,total_us,avg_us,min_us,p50_us,p95_us,p99_us,max_us\n");
+	CSString sName;
+	for ( int i = 0; i < PK_QTY; ++i )
+	{
+		for ( const std::unique_ptr<CScriptProfilerEntry>& pEntry : _vEntries[i] )
+		{
+			if ( pEntry->m_called == 0 )
+				continue;
+
+			// Quoted field: the quotes in the name (the lines have script text) are doubled.
+			sName.Empty();
+			for ( lpctstr pszName = pEntry->m_sName.GetPtr(); *pszName != '\0'; ++pszName )
+			{
+				if ( *pszName == '"' )
+					sName.Add('"');
+				sName.Add(*pszName);
+			}
+			fileCSV.Printf("%s,\"%s\",%u,%lld,%lld,%lld,%lld,%lld,%lld,%lld\n",
+				sm_szKindNames[i],
+				sName.GetPtr(),
+				pEntry->m_called,
+				pEntry->m_total,
+				pEntry->GetAverage(),
+				pEntry->m_min,
+				pEntry->GetPercentile(50),
+				pEntry->GetPercentile(95),
+				pEntry->GetPercentile(99),
+				pEntry->m_max);
+		}
+	}
+	fileCSV.Close();
+	return true;
+}
@@ -6,44 +6,167 @@
 #ifndef _INC_CSCRIPTPROFILER_H
 #define _INC_CSCRIPTPROFILER_H
 
+#include "../common/sphere_library/CSString.h"
 #include "../common/sphere_library/CSTime.h"
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
-extern struct CScriptProfiler
+class CResourceLink;
+class CScript;
+class CTextConsole;
+class CSFileText;
+
+
+#define SCRIPTPROFILER_SUBBUCKETS_SHIFT	2	// Each power of 2 is split in 4 buckets (max error 25%).
+#define SCRIPTPROFILER_BUCKETS			(40 << SCRIPTPROFILER_SUBBUCKETS_SHIFT)	// Up to 2^40 microseconds.
+#define SCRIPTPROFILER_REPORT_TOP		10	// Resources and lines shown in the console report.
+
+class CScriptProfilerHistogram
+{
+	// Log-bucketed execution times, in microseconds.
+	uint _uiBuckets[SCRIPTPROFILER_BUCKETS];
+
+public:
+	CScriptProfilerHistogram()
+	{
+		Clear();
+	}
+
+	void Clear();
+	void Add( llong iMicro );
+	// Upper bound of the bucket holding the given percentile (0-100) of dwCount samples.
+	llong GetPercentile( uint uiPercent, dword dwCount ) const;
+
+	static uint GetBucket( llong iMicro );
+	static llong GetBucketUpperBound( uint uiBucket );
+};
+
+struct CScriptProfilerEntry
+{
+	CSString	m_sName;	// name of the function/trigger, resource or script line
+	dword		m_called;	// how many times called
+	llong		m_total;	// total executions time (microseconds)
+	llong		m_min;		// minimal executions time
+	llong		m_max;		// maximal executions time
+	CScriptProfilerHistogram m_histogram;
+
+	explicit CScriptProfilerEntry( lpctstr pszName );
+
+	void Clear();
+	void Add( llong iMicro );
+	llong GetAverage() const
+	{
+		return m_called ? (m_total / m_called) : 0;
+	}
+	llong GetPercentile( uint uiPercent ) const
+	{
+		return m_histogram.GetPercentile(uiPercent, m_called);
+	}
+};
+
+class CScriptProfiler
+{
+	// Execution time statistics of the script functions and triggers (EF_Script_Profiler).
+	// Entries are created at the first call and never removed (only cleared), so the pointers can be kept by the callers.
+public:
+	enum PROFILE_KIND
+	{
+		PK_FUNCTION,
+		PK_TRIGGER,
+		PK_RESOURCE,	// Triggers time, by the resource (ITEMDEF, CHARDEF, EVENTS...) they are in.
+		PK_LINE,		// Functions and triggers time, by the script line where they begin.
+		PK_QTY
+	};
+
+private:
+	struct NameKey
+	{
+		// Points to the caller's string for lookups, to the entry's name when stored.
+		lpctstr m_pszName;
+	};
+	struct NameKeyHash
+	{
+		size_t operator()( const NameKey & key ) const;
+	};
+	struct NameKeyEqual
+	{
+		bool operator()( const NameKey & key1, const NameKey & key2 ) const;
+	};
+	typedef std::unordered_map<NameKey, CScriptProfilerEntry *, NameKeyHash, NameKeyEqual> NameMap;
+	typedef std::unordered_map<ullong, CScriptProfilerEntry *> IdMap;
+
+	NameMap _mapFunctions;
+	NameMap _mapTriggers;
+	IdMap _mapResources;	// CResourceID (uid and page)
+	IdMap _mapLines;		// Script file index and line number
+	std::vector<std::unique_ptr<CScriptProfilerEntry>> _vEntries[PK_QTY];
+
+public:
+	dword	called;
+	llong	total;
+
+public:
+	CScriptProfiler();
+	~CScriptProfiler() = default;
+private:
+	CScriptProfiler(const CScriptProfiler& copy);
+	CScriptProfiler& operator=(const CScriptProfiler& other);
+
+private:
+	CScriptProfilerEntry * _AddEntry( PROFILE_KIND kind, lpctstr pszName );
+
+public:
+	// Names are case insensitive and end at the first space (function arguments are ignored).
+	CScriptProfilerEntry * GetFunction( lpctstr pszName );
+	CScriptProfilerEntry * GetTrigger( lpctstr pszName );
+	CScriptProfilerEntry * GetResource( const CResourceLink * pLink );
+	CScriptProfilerEntry * GetLine( const CScript & s );
+
+	bool IsEmpty() const
+	{
+		return (called == 0);
+	}
+	void Clear();
+
+	// Console report: functions and triggers slower than the overall average, top resources and lines.
+	void Dump( CTextConsole * pSrc, CSFileText * pFile ) const;
+	// Every entry, with the percentiles.
+	bool DumpCSV( lpctstr pszFilePath ) const;
+};
+
+extern CScriptProfiler g_profiler;
+
+
+// Measures a script execution and adds it to the given profiler entries (the null ones are skipped).
+class CScriptProfilerSample
 {
-    uchar	initstate;
-    dword	called;
-    llong	total;
-    struct CScriptProfilerFunction
-    {
-        tchar	name[128];	// name of the function
-        dword	called;		// how many times called
-        llong	total;		// total executions time
-        llong	min;		// minimal executions time
-        llong	max;		// maximal executions time
-        llong	average;	// average executions time
-        CScriptProfilerFunction *next;
-    }		*FunctionsHead, *FunctionsTail;
-    struct CScriptProfilerTrigger
-    {
-        tchar	name[128];	// name of the trigger
-        dword	called;		// how many times called
-        llong	total;		// total executions time
-        llong	min;		// minimal executions time
-        llong	max;		// maximal executions time
-        llong	average;	// average executions time
-        CScriptProfilerTrigger *next;
-    }		*TriggersHead, *TriggersTail;
-} g_profiler;
-
-
-//	Time measurement macros for the profiler (use them only for the profiler!)
-#define	TIME_PROFILE_INIT	    llong llTicksStart = 0, llTicksEnd = 0
-
-#define	TIME_PROFILE_START	    llTicksStart = GetPreciseSysTimeMilli();
-#define TIME_PROFILE_END	    llTicksEnd = GetPreciseSysTimeMilli();
-
-#define TIME_PROFILE_GET_HI	    ((llTicksEnd - llTicksStart) / 1000)            // Get only the seconds
-#define	TIME_PROFILE_GET_LO	    (((llTicksEnd - llTicksStart) * 10) % 10000)    // Get milliseconds only, without the seconds part
+	CScriptProfilerEntry * _pEntries[3];
+	llong _iTimeStart;
+
+public:
+	CScriptProfilerSample( CScriptProfilerEntry * pEntry1, CScriptProfilerEntry * pEntry2, CScriptProfilerEntry * pEntry3 = nullptr ) :
+		_pEntries{ pEntry1, pEntry2, pEntry3 }
+	{
+		++g_profiler.called;
+		_iTimeStart = GetPreciseSysTimeMicro();
+	}
+	~CScriptProfilerSample()
+	{
+		const llong iTime = GetPreciseSysTimeMicro() - _iTimeStart;
+		for ( CScriptProfilerEntry * pEntry : _pEntries )
+		{
+			if ( pEntry )
+				pEntry->Add(iTime);
+		}
+		g_profiler.total += iTime;
+	}
+
+private:
+	CScriptProfilerSample(const CScriptProfilerSample& copy);
+	CScriptProfilerSample& operator=(const CScriptProfilerSample& other);
+};
 
 
 #endif //_INC_CSCRIPTPROFILER_H
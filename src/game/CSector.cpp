@@ -11,6 +11,7 @@
 #include "items/CItem.h"
 #include "CWorld.h"
 #include "CWorldGameTime.h"
+#include "CWorldTickingList.h"
 #include "CServer.h"
 #include "triggers.h"
 #include "CSector.h"
@@ -27,6 +28,10 @@ CSector::CSector() : CTimedObject(PROFILE_SECTORS)
 
 	m_dwFlags = 0;
 	m_fSaveParity = false;
+
+	_iClientsNear = 0;
+	_iTimeLastClientNear = 0;
+	_fAwakeQueued = false;
     GoSleep();    // Every sector is sleeping at start, they only awake when any player enter (this eases the load at startup).
 }
 
@@ -38,6 +43,7 @@ CSector::~CSector()
 void CSector::Init(int index, uchar map, short x, short y)
 {
 	CSectorBase::Init(index, map, x, y);
+	m_Chars_Active.SetSector(this);
 	SetDefaultWeatherChance();
 }
 
@@ -207,6 +213,12 @@ void CSector::GoSleep()
 void CSector::GoAwake()
 {
     ADDTOCALLSTACK("CSector::GoAwake");
+    _GoAwake(true);
+}
+
+void CSector::_GoAwake(bool fAwakeAdjacents)
+{
+    ADDTOCALLSTACK("CSector::_GoAwake");
     const ProfileTask charactersTask(PROFILE_TIMERS);
     CTimedObject::GoAwake();  // Awake it first, otherwise other things won't work.
 
@@ -240,24 +252,48 @@ void CSector::GoAwake()
     * Awake adjacent sectors when awaking this one to avoid the effect
     * of NPCs being stop until you enter the sector, or all the spawns
     * generating NPCs at once.
+    * They are queued and awaken a few per tick by the world ticker, so that a player entering
+    * a sleeping area (or teleporting) doesn't wake up to nine sectors in the same tick.
     */
-    static CSector *pCentral = nullptr;   // do this only for the awaken sector
-    if (!pCentral)
+    if (fAwakeAdjacents)
     {
-        pCentral = this;
         for (int i = 0; i < (int)DIR_QTY; ++i)
         {
             CSector *pSector = GetAdjacentSector((DIR_TYPE)i);
             if (pSector && pSector->IsSleeping())
             {
-                pSector->GoAwake();
+                pSector->QueueAwake();
             }
         }
-        pCentral = nullptr;
     }
     OnTick();   // Unknown time passed, make the sector tick now to reflect any possible environ changes.
 }
 
+void CSector::QueueAwake()
+{
+    ADDTOCALLSTACK("CSector::QueueAwake");
+    if (_fAwakeQueued)
+        return;
+    _fAwakeQueued = true;
+    CWorldTickingList::AddSectorAwake(this);
+}
+
+void CSector::AwakeFromQueue()
+{
+    ADDTOCALLSTACK("CSector::AwakeFromQueue");
+    _fAwakeQueued = false;
+    if (IsSleeping())
+    {
+        _GoAwake(false);   // Don't propagate: the adjacents with a client nearby have already been queued by UpdateClientsNear.
+    }
+}
+
+void CSector::DequeueAwake()
+{
+    ADDTOCALLSTACK("CSector::DequeueAwake");
+    _fAwakeQueued = false;  // Else it could never be queued again.
+}
+
 bool CSector::r_LoadVal( CScript &s )
 {
 	ADDTOCALLSTACK("CSector::r_LoadVal");
@@ -962,6 +998,9 @@ bool CSector::MoveCharToSector( CChar * pChar )
 	// Move a CChar into this CSector.
     ASSERT(pChar);
 
+	// The char has moved inside this sector or is entering it: the NPCs around should take a look again.
+	m_Chars_Active.SetTimeLastCharEvent(CWorldGameTime::GetCurrentTime().GetTimeRaw());
+
 	// Already here?
 	if (IsCharActiveIn(pChar))
 		return false;	
@@ -1014,6 +1053,23 @@ bool CSector::MoveCharToSector( CChar * pChar )
 	return true;
 }
 
+int64 CSector::GetLastCharEventTime(bool fCheckAdjacents) const
+{
+	ADDTOCALLSTACK_INTENSIVE("CSector::GetLastCharEventTime");
+	// Most recent time a char moved inside, entered or left this sector (and its adjacents, if requested).
+	int64 iTime = m_Chars_Active.GetTimeLastCharEvent();
+	if (fCheckAdjacents)
+	{
+		for (int i = 0; i < (int)DIR_QTY; ++i)
+		{
+			const CSector *pAdjacent = GetAdjacentSector((DIR_TYPE)i);
+			if (pAdjacent && (pAdjacent->m_Chars_Active.GetTimeLastCharEvent() > iTime))
+				iTime = pAdjacent->m_Chars_Active.GetTimeLastCharEvent();
+		}
+	}
+	return iTime;
+}
+
 bool CSector::CanSleep(bool fCheckAdjacents) const
 {
 	ADDTOCALLSTACK_INTENSIVE("CSector::CanSleep");
@@ -1024,28 +1080,24 @@ bool CSector::CanSleep(bool fCheckAdjacents) const
 	if ( IsFlagSet(SECF_InstaSleep) )
 		return true;	// no active client inside, instant sleep
 
+    int64 iTimeLastClient = GetLastClientTime();
     if (fCheckAdjacents)
     {
-        for (int i = 0; i < (int)DIR_QTY; ++i)// Check for adjacent's sectors sleeping allowance.
+        // The clients in the adjacent sectors are counted incrementally (see UpdateClientsNear), so we don't need to ask each adjacent.
+        if (_iClientsNear > 0)
+            return false;
+        for (int i = 0; i < (int)DIR_QTY; ++i)
         {
-            const CSector *pAdjacent = GetAdjacentSector((DIR_TYPE)i);    // set this as the last sector to avoid this code in the adjacent one and return if it can sleep or not instead of searching its adjacents.
-            /*
-            * Only check if this sector exist and it's not the last checked (sectors in the edges of the map doesn't have adjacent on those directions)
-            * && Only check if the sector isn't sleeping (IsSleeping()) and then check if CanSleep().
-            */
-            if (!pAdjacent)
-            {
-                continue;
-            }
-            if (!pAdjacent->CanSleep(false))
-            {
-                return false;   // assume the base sector can't sleep.
-            }
+            const CSector *pAdjacent = GetAdjacentSector((DIR_TYPE)i);
+            if (pAdjacent && pAdjacent->IsFlagSet(SECF_NoSleep))
+                return false;   // a never sleeping sector keeps awake its adjacents.
         }
+        if (_iTimeLastClientNear > iTimeLastClient)
+            iTimeLastClient = _iTimeLastClientNear;
     }
 
 	//default behaviour;
-	const int64 iTimeDiff = CWorldGameTime::GetCurrentTime().GetTimeRaw() - GetLastClientTime();
+	const int64 iTimeDiff = CWorldGameTime::GetCurrentTime().GetTimeRaw() - iTimeLastClient;
 	return (iTimeDiff > g_Cfg._iSectorSleepDelay); // Sector Sleep timeout.
 }
 
@@ -1053,13 +1105,48 @@ void CSector::SetSectorWakeStatus()
 {
 	ADDTOCALLSTACK("CSector::SetSectorWakeStatus");
 	// Ships may enter a sector before it's riders ! ships need working timers to move !
-	m_Chars_Active.SetTimeLastClient(CWorldGameTime::GetCurrentTime().GetTimeRaw());
+	const int64 iCurTime = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+	m_Chars_Active.SetTimeLastClient(iCurTime);
+	for (int i = 0; i < (int)DIR_QTY; ++i)
+	{
+		CSector *pAdjacent = GetAdjacentSector((DIR_TYPE)i);
+		if (pAdjacent)
+			pAdjacent->_iTimeLastClientNear = iCurTime;
+	}
     if (IsSleeping())
     {
         GoAwake();
     }
 }
 
+int CSector::GetClientsNear() const
+{
+	return _iClientsNear;
+}
+
+void CSector::UpdateClientsNear(int iDiff)
+{
+	ADDTOCALLSTACK("CSector::UpdateClientsNear");
+	// Keep track of the clients in this sector and in the adjacent ones, so that CanSleep doesn't need to ask
+	//  every adjacent sector and the sleeping sectors getting a client nearby are awaken without waiting for it to enter them.
+	const int64 iCurTime = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+	for (int i = -1; i < (int)DIR_QTY; ++i)
+	{
+		CSector *pSector = (i < 0) ? this : GetAdjacentSector((DIR_TYPE)i);
+		if (!pSector)
+			continue;
+		pSector->_iClientsNear += iDiff;
+		if (iDiff < 0)
+		{
+			pSector->_iTimeLastClientNear = iCurTime;
+		}
+		else if ((pSector != this) && pSector->IsSleeping())
+		{
+			pSector->QueueAwake();	// This sector is awaken right away by MoveCharToSector.
+		}
+	}
+}
+
 void CSector::Close()
 {
 	ADDTOCALLSTACK("CSector::Close");
@@ -1085,27 +1172,36 @@ void CSector::RespawnDeadNPCs()
 	for (size_t i = 0; i < sizeStart; )
 	{
 		CChar* pChar = static_cast <CChar*>(m_Chars_Active.GetContentIndex(i));
-		if (!pChar->m_pNPC || !pChar->m_ptHome.IsValidPoint() || !pChar->IsStatFlag(STATF_DEAD))
+		if (!RespawnDeadNPC(pChar))
 		{
 			++i;
 			continue;
 		}
 
-		// Restock them with npc stuff.
-		pChar->NPC_LoadScript(true);
-
-		// Res them back to their "home".
-		ushort uiDist = pChar->m_pNPC->m_Home_Dist_Wander;
-		pChar->MoveNear( pChar->m_ptHome, uiDist );
-		pChar->NPC_CreateTrigger(); //Removed from NPC_LoadScript() and triggered after char placement
-		pChar->Spell_Resurrection();
-
 		size_t sizeCur = m_Chars_Active.GetContentCount();
 		ASSERT(sizeCur != sizeStart);
 		sizeStart = sizeCur;
 	}
 }
 
+bool CSector::RespawnDeadNPC( CChar * pChar )
+{
+	ADDTOCALLSTACK("CSector::RespawnDeadNPC");
+	// RETURN: true if the char was a dead NPC (placed in the world) and it has been respawned at its home.
+	if (!pChar->m_pNPC || !pChar->m_ptHome.IsValidPoint() || !pChar->IsStatFlag(STATF_DEAD) || pChar->IsDisconnected())
+		return false;
+
+	// Restock them with npc stuff.
+	pChar->NPC_LoadScript(true);
+
+	// Res them back to their "home".
+	ushort uiDist = pChar->m_pNPC->m_Home_Dist_Wander;
+	pChar->MoveNear( pChar->m_ptHome, uiDist );
+	pChar->NPC_CreateTrigger(); //Removed from NPC_LoadScript() and triggered after char placement
+	pChar->Spell_Resurrection();
+	return true;
+}
+
 void CSector::Restock()
 {
     ADDTOCALLSTACK("CSector::Restock");
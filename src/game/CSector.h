@@ -33,6 +33,10 @@ private:
 	byte m_ColdChance;		// Will be snow if rain chance success.
 	byte m_ListenItems;		// Items on the ground that listen ?
 
+	int   _iClientsNear;			// Clients in this sector and in the adjacent ones (kept updated incrementally).
+	int64 _iTimeLastClientNear;		// Last time a client left this sector or an adjacent one.
+	bool  _fAwakeQueued;			// Waiting in the world ticker queue to be awaken.
+
 private:
 	WEATHER_TYPE GetWeatherCalc() const;
 	byte GetLightCalc( bool fQuickSet ) const;
@@ -98,14 +102,21 @@ public:
 	size_t GetInactiveChars() const;
 	size_t GetClientsNumber() const;
 	int64 GetLastClientTime() const;
+	int64 GetLastCharEventTime(bool fCheckAdjacents) const;
 	bool CanSleep(bool fCheckAdjacents) const;
 	void SetSectorWakeStatus();	// Ships may enter a sector before it's riders !
+	void UpdateClientsNear(int iDiff);	// A client entered (iDiff > 0) or left (iDiff < 0) this sector.
+	int GetClientsNear() const;
+	void QueueAwake();			// Awake this sector in one of the next ticks.
+	void AwakeFromQueue();		// Called by the world ticker.
+	void DequeueAwake();		// The world ticker queue was cleared without awaking it.
 	bool MoveCharToSector( CChar * pChar );
 
 	// CTimedObject
 private:
     virtual void GoSleep() override;
     virtual void GoAwake() override;
+    void _GoAwake(bool fAwakeAdjacents);
 
     // General.
 public:
@@ -123,6 +134,7 @@ public:
 	// Other resources.
 	void Restock();
 	void RespawnDeadNPCs();
+	static bool RespawnDeadNPC( CChar * pChar );
 
 	void Close();
 	lpctstr GetName() const { return "Sector"; }
@@ -27,7 +27,9 @@ void CCharsDisconnectList::AddCharDisconnected( CChar * pChar )
 CCharsActiveList::CCharsActiveList()
 {
 	m_iTimeLastClient = 0;
+	m_iTimeLastCharEvent = 0;
 	m_iClients = 0;
+	m_pSector = nullptr;
 }
 
 void CCharsActiveList::OnRemoveObj(CSObjContRec* pObjRec )
@@ -39,11 +41,15 @@ void CCharsActiveList::OnRemoveObj(CSObjContRec* pObjRec )
 	CSObjCont::OnRemoveObj(pObjRec);
 
 	CChar* pChar = static_cast<CChar*>(pObjRec);
+	const int64 iCurTime = CWorldGameTime::GetCurrentTime().GetTimeRaw();
 	if (pChar->IsClient())
 	{
 		--m_iClients;
-		m_iTimeLastClient = CWorldGameTime::GetCurrentTime().GetTimeRaw();	// mark time in case it's the last client
+		m_iTimeLastClient = iCurTime;	// mark time in case it's the last client
+		if (m_pSector)
+			m_pSector->UpdateClientsNear(-1);
 	}
+	m_iTimeLastCharEvent = iCurTime;	// a char left the sector, the NPCs around should notice it
 	pChar->SetUIDContainerFlags(UID_O_DISCONNECT);
 }
 
@@ -60,6 +66,8 @@ void CCharsActiveList::AddCharActive( CChar * pChar )
 		if (pChar->IsClient())
 		{
 			++m_iClients;
+			if (m_pSector)
+				m_pSector->UpdateClientsNear(1);
 		}
 	}
 
@@ -189,7 +197,7 @@ CSector *CSectorBase::GetAdjacentSector(DIR_TYPE dir) const
 }
 
 CSectorBase::CSectorBase() :
-    _ppAdjacentSectors{}
+    _ppAdjacentSectors{}, _iRegionCellSize(0)
 {
 	m_map = 0;
 	m_index = 0;
@@ -229,95 +237,148 @@ bool CSectorBase::IsInDungeon() const
 	return ( pRegion && pRegion->IsFlag(REGION_FLAG_UNDERGROUND) );
 }
 
-CRegion * CSectorBase::GetRegion( const CPointBase & pt, dword dwType ) const
+static dword GetRegionLinkType( const CRegion * pRegion )
 {
-	ADDTOCALLSTACK_INTENSIVE("CSectorBase::GetRegion");
-	// Does it match the mask of types we care about ?
-	// Assume sorted so that the smallest are first.
-	//
 	// REGION_TYPE_AREA => RES_AREA = World region area only = CRegionWorld
 	// REGION_TYPE_ROOM => RES_ROOM = NPC House areas only = CRegion.
 	// REGION_TYPE_MULTI => RES_WORLDITEM = UID linked types in general = CRegionWorld
+	// Returns 0 for a multi region whose item can't be found (yet).
+	const CResourceID& ridRegion = pRegion->GetResourceID();
+	ASSERT(ridRegion.IsValidUID());
+	if ( ridRegion.IsUIDItem() )
+	{
+		const CItem * pItem = ridRegion.ItemFindFromResource();
+		if ( !pItem )
+			return 0;
+		return ( dynamic_cast<const CItemShip *>(pItem) ? REGION_TYPE_SHIP : REGION_TYPE_HOUSE );
+	}
+	if ( ridRegion.GetResType() == RES_AREA )
+		return REGION_TYPE_AREA;
+	return REGION_TYPE_ROOM;
+}
 
-	size_t iQty = m_RegionLinks.size();
-	for ( size_t i = 0; i < iQty; ++i )
+ullong CSectorBase::GetRegionCells( const CRegion * pRegion ) const
+{
+	ADDTOCALLSTACK("CSectorBase::GetRegionCells");
+	const CRectMap rectSector = GetRect();
+	const int iCellSize = (rectSector.GetWidth() + SECTOR_REGION_GRID - 1) / SECTOR_REGION_GRID;
+
+	ullong uiCells = 0;
+	for ( size_t i = 0, iQty = pRegion->GetRegionRectCount(); i < iQty; ++i )
 	{
-		CRegion * pRegion = m_RegionLinks[i];
-		ASSERT(pRegion);
+		const CRectMap & rect = pRegion->GetRegionRect(i);
+		const int iLeft = maximum(rect.m_left, rectSector.m_left) - rectSector.m_left;
+		const int iTop = maximum(rect.m_top, rectSector.m_top) - rectSector.m_top;
+		const int iRight = minimum(rect.m_right, rectSector.m_right) - rectSector.m_left;
+		const int iBottom = minimum(rect.m_bottom, rectSector.m_bottom) - rectSector.m_top;
+		if ( (iLeft >= iRight) || (iTop >= iBottom) )
+			continue;
 
-        const CResourceID& ridRegion = pRegion->GetResourceID();
-		ASSERT( ridRegion.IsValidUID());
-		if ( ridRegion.IsUIDItem())
-		{
-			const CItemShip * pShipItem = dynamic_cast <CItemShip *>(ridRegion.ItemFindFromResource());
-			if (pShipItem)
-			{
-				if (!(dwType & REGION_TYPE_SHIP))
-					continue;
-			}
-			else if (!(dwType & REGION_TYPE_HOUSE))
-				continue;
-		}
-		else if ( ridRegion.GetResType() == RES_AREA )
+		for ( int y = iTop / iCellSize; y <= (iBottom - 1) / iCellSize; ++y )
 		{
-			if ( ! ( dwType & REGION_TYPE_AREA ))
-				continue;
-		}
-		else
-		{
-			if ( ! ( dwType & REGION_TYPE_ROOM ))
-				continue;
+			for ( int x = iLeft / iCellSize; x <= (iRight - 1) / iCellSize; ++x )
+				uiCells |= (1ull << ((y * SECTOR_REGION_GRID) + x));
 		}
-
-		if ( pRegion->m_pt.m_map != pt.m_map )
-			continue;
-		if ( ! pRegion->IsInside2d( pt ))
-			continue;
-		return pRegion;
 	}
-	return nullptr;
+	return uiCells;
 }
 
-// Balkon: get regions list (to cycle through intercepted house regions)
-size_t CSectorBase::GetRegions( const CPointBase & pt, dword dwType, CRegionLinks *pRLinks ) const
+void CSectorBase::RebuildRegionCells()
 {
-	ADDTOCALLSTACK_INTENSIVE("CSectorBase::GetRegions");
-	size_t iQty = m_RegionLinks.size();
-	for ( size_t i = 0; i < iQty; ++i )
+	ADDTOCALLSTACK("CSectorBase::RebuildRegionCells");
+	// Called when a region is linked or unlinked: with a few regions a plain scan is as fast.
+	_vRegionCellsStart.clear();
+	_vRegionCellsLinks.clear();
+	if ( m_RegionLinks.size() < SECTOR_REGION_INDEX_MIN )
+		return;
+
+	_iRegionCellSize = (GetRect().GetWidth() + SECTOR_REGION_GRID - 1) / SECTOR_REGION_GRID;
+
+	// Count the regions of each cell, then put them in place keeping the order of m_RegionLinks (smaller regions first).
+	static constexpr uint uiCellQty = SECTOR_REGION_GRID * SECTOR_REGION_GRID;
+	_vRegionCellsStart.resize(uiCellQty + 1, 0);
+	for ( const RegionLinkInfo & info : _vRegionLinksInfo )
 	{
-		CRegion * pRegion = m_RegionLinks[i];
-		ASSERT(pRegion);
-
-        const CResourceID& ridRegion = pRegion->GetResourceID();
-		ASSERT(ridRegion.IsValidUID());
-		if (ridRegion.IsUIDItem())
+		for ( uint uiCell = 0; uiCell < uiCellQty; ++uiCell )
 		{
-			const CItemShip * pShipItem = dynamic_cast <const CItemShip *>(ridRegion.ItemFindFromResource());
-			if (pShipItem)
-			{
-				if (!(dwType & REGION_TYPE_SHIP))
-					continue;
-			}
-			else if (!(dwType & REGION_TYPE_HOUSE))
-				continue;
+			if ( info.uiCells & (1ull << uiCell) )
+				++_vRegionCellsStart[uiCell + 1];
 		}
-		else if (ridRegion.GetResType() == RES_AREA )
+	}
+	for ( uint uiCell = 0; uiCell < uiCellQty; ++uiCell )
+		_vRegionCellsStart[uiCell + 1] += _vRegionCellsStart[uiCell];
+
+	_vRegionCellsLinks.resize(_vRegionCellsStart[uiCellQty]);
+	std::vector<uint> vCellsEnd(_vRegionCellsStart.begin(), _vRegionCellsStart.end() - 1);
+	for ( uint i = 0; i < (uint)_vRegionLinksInfo.size(); ++i )
+	{
+		for ( uint uiCell = 0; uiCell < uiCellQty; ++uiCell )
 		{
-			if ( ! ( dwType & REGION_TYPE_AREA ))
-				continue;
+			if ( _vRegionLinksInfo[i].uiCells & (1ull << uiCell) )
+				_vRegionCellsLinks[vCellsEnd[uiCell]++] = i;
 		}
-		else
+	}
+}
+
+CRegion * CSectorBase::FindRegions( const CPointBase & pt, dword dwType, CRegionLinks * pRLinks ) const
+{
+	ADDTOCALLSTACK_INTENSIVE("CSectorBase::FindRegions");
+	// Without pRLinks return the first region (the smallest) of the wanted types at pt, otherwise add all of them to pRLinks.
+
+	const uint * puiLinks = nullptr;	// Only the regions in the cell of pt, if the sector has the grid.
+	size_t uiQty = m_RegionLinks.size();
+	if ( !_vRegionCellsStart.empty() )
+	{
+		const CPointMap ptBase = GetBasePoint();
+		const int iCellX = (pt.m_x - ptBase.m_x) / _iRegionCellSize;
+		const int iCellY = (pt.m_y - ptBase.m_y) / _iRegionCellSize;
+		if ( (pt.m_x >= ptBase.m_x) && (pt.m_y >= ptBase.m_y) && (iCellX < SECTOR_REGION_GRID) && (iCellY < SECTOR_REGION_GRID) )
 		{
-			if ( ! ( dwType & REGION_TYPE_ROOM ))
-				continue;
+			const int iCell = (iCellY * SECTOR_REGION_GRID) + iCellX;
+			puiLinks = _vRegionCellsLinks.data() + _vRegionCellsStart[iCell];
+			uiQty = _vRegionCellsStart[iCell + 1] - _vRegionCellsStart[iCell];
 		}
+	}
+
+	for ( size_t i = 0; i < uiQty; ++i )
+	{
+		const size_t uiLink = puiLinks ? puiLinks[i] : i;
+		CRegion * pRegion = m_RegionLinks[uiLink];
+		ASSERT(pRegion);
+
+		dword dwRegionType = _vRegionLinksInfo[uiLink].dwType;
+		if ( dwRegionType == 0 )
+			dwRegionType = GetRegionLinkType(pRegion);
+		if ( dwRegionType == 0 )
+			dwRegionType = REGION_TYPE_HOUSE;	// multi item not found
+		if ( !(dwType & dwRegionType) )
+			continue;
 
 		if ( pRegion->m_pt.m_map != pt.m_map )
 			continue;
 		if ( ! pRegion->IsInside2d( pt ))
 			continue;
-        pRLinks->push_back(pRegion);
+		if ( !pRLinks )
+			return pRegion;
+		pRLinks->push_back(pRegion);
 	}
+	return nullptr;
+}
+
+CRegion * CSectorBase::GetRegion( const CPointBase & pt, dword dwType ) const
+{
+	ADDTOCALLSTACK_INTENSIVE("CSectorBase::GetRegion");
+	// Does it match the mask of types we care about ?
+	// Assume sorted so that the smallest are first.
+	return FindRegions(pt, dwType, nullptr);
+}
+
+// Balkon: get regions list (to cycle through intercepted house regions)
+size_t CSectorBase::GetRegions( const CPointBase & pt, dword dwType, CRegionLinks *pRLinks ) const
+{
+	ADDTOCALLSTACK_INTENSIVE("CSectorBase::GetRegions");
+	ASSERT(pRLinks);
+	FindRegions(pt, dwType, pRLinks);
 	return pRLinks->size();
 }
 
@@ -329,7 +390,9 @@ bool CSectorBase::UnLinkRegion( CRegion * pRegionOld )
     auto it = std::find(m_RegionLinks.begin(), m_RegionLinks.end(), pRegionOld);
     if (it == m_RegionLinks.end())
         return false;
+    _vRegionLinksInfo.erase(_vRegionLinksInfo.begin() + (it - m_RegionLinks.begin()));
     m_RegionLinks.erase(it);
+    RebuildRegionCells();
     return true;
 }
 
@@ -342,6 +405,7 @@ bool CSectorBase::LinkRegion( CRegion * pRegionNew )
 	//  according to the old rules.
 	ASSERT(pRegionNew);
 	ASSERT( pRegionNew->IsOverlapped(GetRect()) );
+	const RegionLinkInfo info = { GetRegionLinkType(pRegionNew), GetRegionCells(pRegionNew) };
 	size_t iQty = m_RegionLinks.size();
 
 	for ( size_t i = 0; i < iQty; ++i )
@@ -373,11 +437,15 @@ bool CSectorBase::LinkRegion( CRegion * pRegionNew )
 
 			// must insert before this.
 			m_RegionLinks.emplace(m_RegionLinks.begin() + i, pRegionNew);
+			_vRegionLinksInfo.emplace(_vRegionLinksInfo.begin() + i, info);
+			RebuildRegionCells();
 			return true;
 		}
 	}
 
 	m_RegionLinks.push_back(pRegionNew);
+	_vRegionLinksInfo.push_back(info);
+	RebuildRegionCells();
 	return true;
 }
 
@@ -15,6 +15,9 @@ class CItem;
 class CSector;
 class CTeleport;
 
+#define SECTOR_REGION_GRID		8	// The regions of a sector are indexed in a grid of SECTOR_REGION_GRID x SECTOR_REGION_GRID cells (one bit each in a ullong).
+#define SECTOR_REGION_INDEX_MIN	8	// With less regions than this the sector just scans all of them.
+
 struct CCharsDisconnectList : public CSObjCont
 {
 	CCharsDisconnectList() = default;
@@ -30,6 +33,8 @@ struct CCharsActiveList : public CSObjCont
 private:
 	int m_iClients;				// How many clients in this sector now?
 	int64 m_iTimeLastClient;	// age the sector based on last client here.
+	int64 m_iTimeLastCharEvent;	// last time a char moved inside, entered or left this sector (used by the NPCs perception).
+	CSector* m_pSector;			// sector owning this list, notified when the clients number changes.
     
 protected:
 	void OnRemoveObj(CSObjContRec* pObjRec );	// Override this = called when removed from list.
@@ -37,6 +42,9 @@ protected:
 public:
 	CCharsActiveList();
 	void AddCharActive(CChar* pChar);
+	inline void SetSector(CSector* pSector) {
+		m_pSector = pSector;
+	}
 	int GetClientsNumber() const {
 		return m_iClients;
 	}
@@ -46,6 +54,12 @@ public:
 	inline void SetTimeLastClient(int64 iTime) {
 		m_iTimeLastClient = iTime;
 	}
+	int64 GetTimeLastCharEvent() const {
+		return m_iTimeLastCharEvent;
+	}
+	inline void SetTimeLastCharEvent(int64 iTime) {
+		m_iTimeLastCharEvent = iTime;
+	}
 
 private:
 	CCharsActiveList(const CCharsActiveList& copy);
@@ -102,6 +116,20 @@ public:
 private:
     CSector* _ppAdjacentSectors[DIR_QTY];
 
+	struct RegionLinkInfo
+	{
+		dword dwType;	// REGION_TYPE_* of the region, or 0 if it still has to be found (multi not found when linking).
+		ullong uiCells;	// Cells of the sector grid touched by the region rects.
+	};
+	std::vector<RegionLinkInfo> _vRegionLinksInfo;	// Same order of m_RegionLinks.
+	std::vector<uint> _vRegionCellsStart;			// For each cell, where its regions start in _vRegionCellsLinks (the last one is the end).
+	std::vector<uint> _vRegionCellsLinks;			// Indexes in m_RegionLinks of the regions of each cell, in the same order.
+	int _iRegionCellSize;
+
+	ullong GetRegionCells( const CRegion * pRegion ) const;
+	void RebuildRegionCells();
+	CRegion * FindRegions( const CPointBase & pt, dword dwType, CRegionLinks * pRLinks ) const;
+
 public:
     /*
     * @brief Asign it's adjacent's sectors
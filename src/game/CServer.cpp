@@ -13,6 +13,7 @@
 #include "../common/sphere_library/CSAssoc.h"
 #include "../common/CException.h"
 #include "../common/sphere_library/CSFileList.h"
+#include "../common/sphere_library/CSSlabPool.h"
 #include "../common/CTextConsole.h"
 #include "../common/CLog.h"
 #include "../common/sphereversion.h"	// sphere version
@@ -20,13 +21,23 @@
 #include "../network/CIPHistoryManager.h"
 #include "../network/CNetworkManager.h"
 #include "../sphere/ProfileTask.h"
+#include "../sphere/TickWatchdog.h"
 #include "../sphere/ntwindow.h"
 #include "chars/CChar.h"
 #include "clients/CAccount.h"
 #include "clients/CClient.h"
+#include "items/CItemCommCrystal.h"
+#include "items/CItemCorpse.h"
+#include "items/CItemMap.h"
+#include "items/CItemMemory.h"
+#include "items/CItemMessage.h"
+#include "items/CItemMultiCustom.h"
+#include "items/CItemScript.h"
 #include "items/CItemShip.h"
+#include "items/CItemStone.h"
 #include "CScriptProfiler.h"
 #include "CServer.h"
+#include "CServerBench.h"
 #include "CWorld.h"
 #include "CWorldComm.h"
 #include "CWorldGameTime.h"
@@ -446,6 +457,7 @@ bool CServer::OnConsoleCmd( CSString & sText, CTextConsole * pSrc )
 				"#         Immediate save world (## to save both world and statics)\n"
 				"A         Update pending changes on Accounts file\n"
 				"B [msg]   Broadcast message to all clients\n"
+				"BENCH [file] Run the micro-benchmarks on the loaded world and dump them to a CSV file in the log folder (default bench.csv)\n"
 				"C         List of online Clients (%lu)\n"
 				"DA        Dump Areas to external file\n"
 				"DUI       Dump Unscripted Items to external file\n"
@@ -455,10 +467,13 @@ bool CServer::OnConsoleCmd( CSString & sText, CTextConsole * pSrc )
 				"I         View server Information\n"
 				"L         Toggle log file (%s)\n"
 				"P         Profile Info (%s) (P# to dump to profiler_dump.txt)\n"
+				"POOLSTATS Show the items and chars allocated from the object pools (EF_ObjectPools)\n"
+				"PROFILECSV [file] Dump the script profiler to a CSV file in the log folder (default profiler_scripts.csv)\n"
 				"R         Resync Pause\n"
 				"S         Secure mode toggle (%s)\n"
 				"STRIP     Dump all script templates to external file, formatted for Axis\n"
 				"STRIPTNG  Dump all script templates to external file, formatted for TNG\n"
+				"STACKSAMPLES [file] Dump the main thread call stack samples (TickStackSampling) for flame graphs\n"
 				"T         List of active Threads\n"
 				"U         List used triggers\n"
 				"X         Immediate exit the server (X# to save world and statics before exit)\n"
@@ -569,23 +584,8 @@ bool CServer::OnConsoleCmd( CSString & sText, CTextConsole * pSrc )
 			{
 				if ( IsSetEF(EF_Script_Profiler) )
 				{
-					if ( g_profiler.initstate == 0xf1 )
-					{
-						CScriptProfiler::CScriptProfilerFunction	*pFun;
-						CScriptProfiler::CScriptProfilerTrigger		*pTrig;
-
-						for ( pFun = g_profiler.FunctionsHead; pFun != nullptr; pFun = pFun->next )
-						{
-							pFun->average = pFun->max = pFun->min = pFun->total = pFun->called = 0;
-						}
-						for ( pTrig = g_profiler.TriggersHead; pTrig != nullptr; pTrig = pTrig->next )
-						{
-							pTrig->average = pTrig->max = pTrig->min = pTrig->total = pTrig->called = 0;
-						}
-
-						g_profiler.total = g_profiler.called = 0;
-                        g_Log.Event(LOGL_EVENT, "Scripts profiler info cleared\n");
-					}
+					g_profiler.Clear();
+					g_Log.Event(LOGL_EVENT, "Scripts profiler info cleared\n");
 				}
                 else
                 {
@@ -1102,18 +1102,7 @@ void CServer::ProfileDump( CTextConsole * pSrc, bool bDump )
 
 	if ( IsSetEF(EF_Script_Profiler) )
 	{
-        if (g_profiler.initstate != 0xf1)
-        {
-            if (pSrc != this)
-            {
-                pSrc->SysMessage("Scripts profiler is not initialized\n");
-            }
-            else
-            {
-                g_Log.Event(LOGL_EVENT, "Scripts profiler is not initialized\n");
-            }
-        }
-        else if (!g_profiler.called)
+        if (g_profiler.IsEmpty())
         {
             if (pSrc != this)
             {
@@ -1126,79 +1115,7 @@ void CServer::ProfileDump( CTextConsole * pSrc, bool bDump )
         }
 		else
 		{
-			CScriptProfiler::CScriptProfilerFunction * pFun;
-			CScriptProfiler::CScriptProfilerTrigger * pTrig;
-            const long double average = (long double)g_profiler.total / g_profiler.called;
-
-            char tmpstring[255];
-            sprintf(tmpstring, "Scripts: called %u times and took a total of %.4f seconds (%.4Lfs average). Reporting with highest average.\n",
-                g_profiler.called,
-                (g_profiler.total   / 1000.0),
-                (average            / 1000.0));
-            if (pSrc != this)
-            {
-                pSrc->SysMessage(tmpstring);
-            }
-            else
-            {
-                g_Log.Event(LOGL_EVENT, tmpstring);
-            }
-            if (ftDump != nullptr)
-            {
-                ftDump->Printf(tmpstring);
-            }
-
-			for ( pFun = g_profiler.FunctionsHead; pFun != nullptr; pFun = pFun->next )
-			{
-				if ( pFun->average > average )
-				{
-                    sprintf(tmpstring, "FUNCTION '%s' called %u times, took %.4f seconds average (%.4f min, %.4f max), total: %.4f s.\n",
-                        pFun->name,
-                        pFun->called,
-                        (pFun->average / 1000.0),
-                        (pFun->min     / 1000.0),
-                        (pFun->max     / 1000.0),
-                        (pFun->total   / 1000.0));
-
-                    if (pSrc != this)
-                    {
-                        pSrc->SysMessage(tmpstring);
-                    }
-                    else
-                    {
-                        g_Log.Event(LOGL_EVENT, tmpstring);
-                    }
-                    if (ftDump != nullptr)
-                    {
-                        ftDump->Printf(tmpstring);
-                    }
-				}
-			}
-			for ( pTrig = g_profiler.TriggersHead; pTrig != nullptr; pTrig = pTrig->next )
-			{
-				if ( pTrig->average > average )
-				{
-					sprintf(tmpstring, "TRIGGER '%s' called %u times, took %.4f seconds average (%.4f min, %.4f max), total: %.4f s.\n",
-						pTrig->name,
-						pTrig->called,
-						(pTrig->average / 1000.0),
-						(pTrig->min     / 1000.0),
-						(pTrig->max     / 1000.0),
-						(pTrig->total   / 1000.0));
-                    if (pSrc != this)
-                    {
-                        pSrc->SysMessage(tmpstring);
-                    }
-                    else
-                    {
-                        g_Log.Event(LOGL_EVENT, tmpstring);
-                    }
-                    if (ftDump != nullptr)
-                    {
-                        ftDump->Printf(tmpstring);
-                    }
-				}
-			}
+			g_profiler.Dump(pSrc, ftDump);
 
             if (pSrc != this)
             {
@@ -1350,6 +1267,7 @@ enum SV_TYPE
 	SV_ACCOUNTS, //read only
 	SV_ALLCLIENTS,
 	SV_B,
+	SV_BENCH,
 	SV_BLOCKIP,
 	SV_CHARS, //read only
 	SV_CLEARLISTS,
@@ -1366,7 +1284,9 @@ enum SV_TYPE
 	SV_ITEMS, //read only
 	SV_LOAD,
 	SV_LOG,
+	SV_POOLSTATS,
 	SV_PRINTLISTS,
+	SV_PROFILECSV,
 	SV_RESPAWN,
 	SV_RESTOCK,
 	SV_RESTORE,
@@ -1377,6 +1297,7 @@ enum SV_TYPE
 	SV_SECURE,
 	SV_SHRINKMEM,
 	SV_SHUTDOWN,
+	SV_STACKSAMPLES,
 	SV_TIME, // read only
 	SV_UNBLOCKIP,
 	SV_VARLIST,
@@ -1389,6 +1310,7 @@ lpctstr const CServer::sm_szVerbKeys[SV_QTY+1] =
 	"ACCOUNTS", // read only
 	"ALLCLIENTS",
 	"B",
+	"BENCH",
 	"BLOCKIP",
 	"CHARS", // read only
 	"CLEARLISTS",
@@ -1405,7 +1327,9 @@ lpctstr const CServer::sm_szVerbKeys[SV_QTY+1] =
 	"ITEMS", // read only
 	"LOAD",
 	"LOG",
+	"POOLSTATS",
 	"PRINTLISTS",
+	"PROFILECSV",
 	"RESPAWN",
 	"RESTOCK",
 	"RESTORE",
@@ -1416,6 +1340,7 @@ lpctstr const CServer::sm_szVerbKeys[SV_QTY+1] =
 	"SECURE",
 	"SHRINKMEM",
 	"SHUTDOWN",
+	"STACKSAMPLES",
 	"TIME", // read only
 	"UNBLOCKIP",
 	"VARLIST",
@@ -1529,6 +1454,28 @@ bool CServer::r_Verb( CScript &s, CTextConsole * pSrc )
 			CWorldComm::Broadcast( s.GetArgStr());
 			break;
 
+		case SV_BENCH:	// "BENCH" [file]
+			if ( pSrc->GetPrivLevel() < PLEVEL_Admin )
+				return false;
+			{
+				CServerBench bench;
+				bench.Run(pSrc);
+				bench.Report(pSrc);
+
+				// Only the file name is used: the file is always written to the log folder.
+				lpctstr ptcFileName = s.HasArgs() ? CSFile::GetFilesTitle(s.GetArgStr()) : "";
+				if ( ptcFileName[0] == '\0' )
+					ptcFileName = "bench.csv";
+				CSString sFilePath;
+				sFilePath.Format("%s%s", g_Log.GetLogDir(), ptcFileName);
+				pszMsg = Str_GetTemp();
+				if ( bench.DumpCSV(sFilePath.GetPtr()) )
+					snprintf(pszMsg, STR_TEMPLENGTH, "Benchmark results dumped to '%s'.\n", sFilePath.GetPtr());
+				else
+					snprintf(pszMsg, STR_TEMPLENGTH, "Can't write the benchmark results to '%s'.\n", sFilePath.GetPtr());
+			}
+			break;
+
 		case SV_BLOCKIP:
 			if ( pSrc->GetPrivLevel() >= PLEVEL_Admin )
 			{
@@ -1851,6 +1798,100 @@ bool CServer::r_Verb( CScript &s, CTextConsole * pSrc )
 		case SV_CLEARLISTS:
 			g_Exp.m_ListGlobals.ClearKeys( s.GetArgStr()) ;
 			break;
+		case SV_STACKSAMPLES:	// "STACKSAMPLES" [file]
+			if ( pSrc->GetPrivLevel() < PLEVEL_Admin )
+				return false;
+			pszMsg = Str_GetTemp();
+			if ( !g_StackSampler.isActive() )
+			{
+				strcpy(pszMsg, "Call stack sampling is not enabled (TickStackSampling in Sphere.ini).\n");
+			}
+			else
+			{
+				// Only the file name is used: the file is always written to the log folder.
+				lpctstr ptcFileName = s.HasArgs() ? CSFile::GetFilesTitle(s.GetArgStr()) : "";
+				if ( ptcFileName[0] == '\0' )
+					ptcFileName = "callstack.folded";
+				CSString sFilePath;
+				sFilePath.Format("%s%s", g_Log.GetLogDir(), ptcFileName);
+				if ( g_StackSampler.Dump(sFilePath.GetPtr()) )
+					snprintf(pszMsg, STR_TEMPLENGTH, "%u call stack samples dumped to '%s'.\n", g_StackSampler.GetSampleCount(), sFilePath.GetPtr());
+				else
+					snprintf(pszMsg, STR_TEMPLENGTH, "Can't write the call stack samples to '%s'.\n", sFilePath.GetPtr());
+			}
+			break;
+		case SV_POOLSTATS:	// "POOLSTATS"
+			{
+				if ( pSrc->GetPrivLevel() < PLEVEL_Admin )
+					return false;
+
+				// The size classes don't know their type: name them after the classes having that size.
+				struct ObjPoolClass
+				{
+					size_t uiSize;
+					lpctstr pszName;
+				};
+				static const ObjPoolClass sm_ObjPoolClasses[] =
+				{
+					{ sizeof(CItem), "CItem" },
+					{ sizeof(CItemVendable), "CItemVendable" },
+					{ sizeof(CItemContainer), "CItemContainer" },
+					{ sizeof(CItemCorpse), "CItemCorpse" },
+					{ sizeof(CItemMulti), "CItemMulti" },
+					{ sizeof(CItemMultiCustom), "CItemMultiCustom" },
+					{ sizeof(CItemShip), "CItemShip" },
+					{ sizeof(CItemMap), "CItemMap" },
+					{ sizeof(CItemMemory), "CItemMemory" },
+					{ sizeof(CItemMessage), "CItemMessage" },
+					{ sizeof(CItemScript), "CItemScript" },
+					{ sizeof(CItemStone), "CItemStone" },
+					{ sizeof(CItemCommCrystal), "CItemCommCrystal" },
+					{ sizeof(CChar), "CChar" }
+				};
+
+				std::vector<CSSlabPool::SizeClassStats> vStats;
+				CObjBase::GetObjPool().GetStats(vStats);
+				pSrc->SysMessagef("Object pools are %s, %" PRIuSIZE_T " size classes.\n", IsSetEF(EF_ObjectPools) ? "enabled" : "disabled", vStats.size());
+				for ( const CSSlabPool::SizeClassStats & stats : vStats )
+				{
+					tchar szNames[128];
+					szNames[0] = '\0';
+					for ( const ObjPoolClass & objClass : sm_ObjPoolClasses )
+					{
+						const size_t uiBlockSize = (objClass.uiSize + SLABPOOL_GRANULARITY - 1) & ~(size_t)(SLABPOOL_GRANULARITY - 1);
+						if ( uiBlockSize != stats.uiBlockSize )
+							continue;
+						if ( szNames[0] != '\0' )
+							Str_ConcatLimitNull(szNames, "/", sizeof(szNames));
+						Str_ConcatLimitNull(szNames, objClass.pszName, sizeof(szNames));
+					}
+					pSrc->SysMessagef("%6" PRIuSIZE_T " bytes %-28s live %8" PRIuSIZE_T ", slabs %5" PRIuSIZE_T " (%" PRIuSIZE_T " KB), allocations %" PRIu64 "\n",
+						stats.uiBlockSize, szNames[0] ? szNames : "?", stats.uiLive, stats.uiSlabs, (stats.uiSlabs * SLABPOOL_SLAB_SIZE) / 1024, (uint64)stats.uiAllocations);
+				}
+			}
+			break;
+		case SV_PROFILECSV:	// "PROFILECSV" [file]
+			if ( pSrc->GetPrivLevel() < PLEVEL_Admin )
+				return false;
+			pszMsg = Str_GetTemp();
+			if ( !IsSetEF(EF_Script_Profiler) )
+			{
+				strcpy(pszMsg, "Script profiler feature is not enabled on Sphere.ini.\n");
+			}
+			else
+			{
+				// Only the file name is used: the file is always written to the log folder.
+				lpctstr ptcFileName = s.HasArgs() ? CSFile::GetFilesTitle(s.GetArgStr()) : "";
+				if ( ptcFileName[0] == '\0' )
+					ptcFileName = "profiler_scripts.csv";
+				CSString sFilePath;
+				sFilePath.Format("%s%s", g_Log.GetLogDir(), ptcFileName);
+				if ( g_profiler.DumpCSV(sFilePath.GetPtr()) )
+					snprintf(pszMsg, STR_TEMPLENGTH, "Script profiler dumped to '%s'.\n", sFilePath.GetPtr());
+				else
+					snprintf(pszMsg, STR_TEMPLENGTH, "Can't write the script profiler dump to '%s'.\n", sFilePath.GetPtr());
+			}
+			break;
 		default:
 			return CScriptObj::r_Verb(s, pSrc);
 	}
@@ -2198,6 +2239,8 @@ void CServer::OnTick()
 	EXC_SET_BLOCK("generic");
 	g_Cfg.OnTick(false);
 	_hDb.OnTick();
+	_hLdb.OnTick();
+	_hMdb.OnTick();
 	EXC_CATCH;
 }
 
@@ -0,0 +1,625 @@
+#include "../common/crypto/CCrypto.h"
+#include "../common/resource/CResourceDef.h"
+#include "../common/sphere_library/CSFileText.h"
+#include "../common/sphere_library/CSObjCont.h"
+#include "../common/sphere_library/CSRand.h"
+#include "../common/sphere_library/CSSlabPool.h"
+#include "../common/sphere_library/CSSortedVector.h"
+#include "../common/sphere_library/CSTime.h"
+#include "../common/CExpression.h"
+#include "../common/CLog.h"
+#include "../common/CTextConsole.h"
+#include "chars/CChar.h"
+#include "items/CItem.h"
+#include "items/CItemContainer.h"
+#include "CPathFinder.h"
+#include "CServer.h"
+#include "CServerBench.h"
+#include "CWorld.h"
+#include "CWorldMap.h"
+#include <algorithm>
+#include <memory>
+
+
+void CServerBench::AddResult( lpctstr pszName, ullong uiOps, llong iMicro )
+{
+	Result result;
+	Str_CopyLimitNull(result.szName, pszName, sizeof(result.szName));
+	result.uiOps = uiOps;
+	result.iMicro = iMicro;
+	_vResults.emplace_back(result);
+}
+
+void CServerBench::Run( CTextConsole * pSrc )
+{
+	ADDTOCALLSTACK("CServerBench::Run");
+	_vResults.clear();
+	ullong uiSink = 0;	// Results of the operations, so that they aren't optimized away.
+	llong iTimeStart;
+
+	// CSSortedVector: lookups in 64k random values.
+	{
+		CSSortedVector<dword> vValues;
+		std::vector<dword> vFind(4096);
+		vValues.reserve(0x10000);
+		for ( uint i = 0; i < 0x10000; ++i )
+			vValues.insert((dword)CSRand::genRandInt32(0, INT32_MAX));
+		for ( dword & dwFind : vFind )
+			dwFind = vValues[(size_t)CSRand::genRandInt32(0, 0xFFFF)];
+
+		const uint uiOps = 1000000;
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiOps; ++i )
+			uiSink += vValues.find(vFind[i & 0xFFF]);
+		AddResult("CSSortedVector::find", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+	}
+
+	// CSObjCont: records moved between two containers, like items moved from a container to another.
+	{
+		CSObjCont contA, contB;	// They delete the records.
+		std::vector<CSObjContRec *> vRecs(1024);
+		std::vector<ushort> vMove(4096);
+		for ( CSObjContRec *& pRec : vRecs )
+		{
+			pRec = new CSObjContRec();
+			contA.InsertContentTail(pRec);
+		}
+		for ( ushort & uiMove : vMove )
+			uiMove = (ushort)CSRand::genRandInt32(0, 1023);
+
+		const uint uiOps = 200000;
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiOps; ++i )
+		{
+			CSObjContRec * pRec = vRecs[vMove[i & 0xFFF]];
+			CSObjCont * pContTo = (pRec->GetParent() == &contA) ? &contB : &contA;
+			pContTo->InsertContentTail(pRec);
+		}
+		AddResult("CSObjCont move (1024 records)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+		uiSink += contA.GetContentCount();
+	}
+
+	// CVarDefMap: the DEFs (and resource defnames) looked up by name, like the scripts do. In a copy of them, searched in the
+	// sorted vector, then after indexing the copy with the perfect hash, as the DEFs are once the scripts are loaded (Freeze).
+	{
+		std::vector<CSString> vKeys;
+		const size_t uiDefs = g_Exp.m_VarDefs.GetCount();
+		for ( size_t i = 0; (i < uiDefs) && (vKeys.size() < 4096); i += maximum((size_t)1, uiDefs / 4096) )
+			vKeys.emplace_back(g_Exp.m_VarDefs.GetAt(i)->GetKey());
+		if ( !vKeys.empty() )
+		{
+			const uint uiOps = 1000000;
+			iTimeStart = GetPreciseSysTimeMicro();
+			for ( uint i = 0; i < uiOps; ++i )
+				uiSink += (ullong)(size_t)g_Exp.m_VarDefs.GetKey(vKeys[i % vKeys.size()]);
+			AddResult("CVarDefMap::GetKey (DEFs)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+
+			CVarDefMap mapDefs;
+			mapDefs.Copy(&g_Exp.m_VarDefs);
+			for ( int iFrozen = 0; iFrozen < 2; ++iFrozen )
+			{
+				if ( iFrozen )
+					mapDefs.Freeze();
+				iTimeStart = GetPreciseSysTimeMicro();
+				for ( uint i = 0; i < uiOps; ++i )
+					uiSink += (ullong)(size_t)mapDefs.GetKey(vKeys[i % vKeys.size()]);
+				AddResult(iFrozen ? "CVarDefMap::GetKey (copy, frozen)" : "CVarDefMap::GetKey (copy, sorted)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+			}
+		}
+	}
+
+	// CResourceHash: item and char definitions by id.
+	{
+		std::vector<CResourceID> vRids;
+		for ( size_t i = 0; i < CountOf(g_Cfg.m_ResHash.m_Array); ++i )
+		{
+			for ( const CResourceDef * pResDef : g_Cfg.m_ResHash.m_Array[i] )
+			{
+				if ( (pResDef != nullptr) && (vRids.size() < 4096) )
+					vRids.emplace_back(pResDef->GetResourceID());
+			}
+		}
+		if ( !vRids.empty() )
+		{
+			const uint uiOps = 1000000;
+			iTimeStart = GetPreciseSysTimeMicro();
+			for ( uint i = 0; i < uiOps; ++i )
+				uiSink += (ullong)(size_t)g_Cfg.ResourceGetDef(vRids[i % vRids.size()]);
+			AddResult("CResourceHash (ResourceGetDef)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+		}
+	}
+
+	// CSSlabPool: items, containers and chars (their sizes) freed and allocated at random with 4096 of them alive,
+	// then reading them all, with the system allocator and with a pool (EF_ObjectPools).
+	{
+		const size_t pSizes[] = { sizeof(CItem), sizeof(CItemContainer), sizeof(CChar) };
+		std::vector<void *> vBlocks(4096);
+		std::vector<ushort> vRealloc(4096);
+		for ( ushort & uiRealloc : vRealloc )
+			uiRealloc = (ushort)CSRand::genRandInt32(0, 4095);
+
+		for ( int iPool = 0; iPool < 2; ++iPool )
+		{
+			CSSlabPool pool;	// Its own: the objects of the world aren't involved.
+			auto Alloc = [&pool, iPool]( size_t uiSize ) -> void *
+			{
+				return iPool ? pool.Alloc(uiSize) : ::operator new(uiSize);
+			};
+			auto Free = [&pool, iPool]( void * pBlock )
+			{
+				if ( iPool )
+					pool.Free(pBlock);
+				else
+					::operator delete(pBlock);
+			};
+
+			for ( size_t i = 0; i < vBlocks.size(); ++i )
+			{
+				vBlocks[i] = Alloc(pSizes[i % CountOf(pSizes)]);
+				*static_cast<dword *>(vBlocks[i]) = (dword)i;
+			}
+
+			const uint uiOps = 1000000;
+			iTimeStart = GetPreciseSysTimeMicro();
+			for ( uint i = 0; i < uiOps; ++i )
+			{
+				const size_t uiBlock = vRealloc[i & 0xFFF];
+				Free(vBlocks[uiBlock]);
+				vBlocks[uiBlock] = Alloc(pSizes[uiBlock % CountOf(pSizes)]);
+				*static_cast<dword *>(vBlocks[uiBlock]) = i;
+			}
+			AddResult(iPool ? "CSSlabPool free+alloc" : "operator delete+new", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+
+			const uint uiPasses = 256;
+			iTimeStart = GetPreciseSysTimeMicro();
+			for ( uint uiPass = 0; uiPass < uiPasses; ++uiPass )
+			{
+				for ( const void * pBlock : vBlocks )
+					uiSink += *static_cast<const dword *>(pBlock);
+			}
+			AddResult(iPool ? "CSSlabPool read 4096 blocks" : "operator new read 4096 blocks", (ullong)uiPasses * vBlocks.size(), GetPreciseSysTimeMicro() - iTimeStart);
+
+			for ( void * pBlock : vBlocks )
+				Free(pBlock);
+		}
+	}
+
+	// CExpression::GetVal: an arithmetic expression, as found in the script lines.
+	{
+		const uint uiOps = 200000;
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiOps; ++i )
+		{
+			lpctstr pszExpr = "((12 + 0x20) * 3 / 2) - (7 % 4) + 100";
+			uiSink += (ullong)g_Exp.GetVal(pszExpr);
+		}
+		AddResult("CExpression::GetVal", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+	}
+
+	// CScriptObj::ParseText: lines with nested substitutions, scanned every time and then with their template (EF_ParseTextCache).
+	{
+		static const struct
+		{
+			lpctstr pszName[2];		// Scanned, template.
+			lpctstr pszLine;
+		} sm_Lines[] =
+		{
+			{ { "ParseText short line (scan)", "ParseText short line (template)" },
+				"Shard <NAME> has <ITEMS> items and <CHARS> chars, <EVAL <CLIENTS> + 1> with me." },
+			{ { "ParseText gump line (scan)", "ParseText gump line (template)" },
+				"htmlgump 20 40 300 200 \"<NAME>: welcome, traveller. The roads to the north are unsafe since the last storm, "
+				"and the guards ask everybody to travel in groups.\" 1 1 <EVAL <CLIENTS> + 1>" }
+		};
+		tchar szLine[512];
+		const uint uiFlagsPrev = g_Cfg.m_iExperimentalFlags;
+		const uint uiOps = 100000;
+		for ( const auto & line : sm_Lines )
+		{
+			for ( int iCache = 0; iCache < 2; ++iCache )
+			{
+				if ( iCache )
+					g_Cfg.m_iExperimentalFlags |= EF_ParseTextCache;
+				else
+					g_Cfg.m_iExperimentalFlags &= ~EF_ParseTextCache;
+
+				iTimeStart = GetPreciseSysTimeMicro();
+				for ( uint i = 0; i < uiOps; ++i )
+				{
+					Str_CopyLimitNull(szLine, line.pszLine, sizeof(szLine));	// The line is parsed in place.
+					uiSink += g_Serv.ParseText(szLine, &g_Serv);
+				}
+				AddResult(line.pszName[iCache], uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+			}
+		}
+		g_Cfg.m_iExperimentalFlags = uiFlagsPrev;
+	}
+
+	// CPointBase::GetDist: random points of the same map.
+	{
+		std::vector<CPointMap> vPoints(1024);
+		for ( CPointMap & pt : vPoints )
+			pt = CPointMap((short)CSRand::genRandInt32(0, 6000), (short)CSRand::genRandInt32(0, 4000), (char)CSRand::genRandInt32(-20, 60), 0);
+
+		const uint uiOps = 4000000;
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiOps; ++i )
+			uiSink += (ullong)vPoints[i & 0x3FF].GetDist(vPoints[(i >> 10) & 0x3FF]);
+		AddResult("CPointBase::GetDist", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiOps; ++i )
+			uiSink += (ullong)vPoints[i & 0x3FF].GetDist3D(vPoints[(i >> 10) & 0x3FF]);
+		AddResult("CPointBase::GetDist3D", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+	}
+
+	// Where random chars of the world are: the world searches and region lookups are done there.
+	std::vector<CPointMap> vPoints;
+	const dword dwUIDs = g_World.GetUIDCount();
+	for ( uint uiTry = 0; (uiTry < 8192) && (vPoints.size() < 256) && (dwUIDs > 1); ++uiTry )
+	{
+		const CObjBase * pObj = g_World.FindUID((dword)CSRand::genRandInt32(1, (int32)(dwUIDs - 1)));
+		if ( (pObj != nullptr) && pObj->IsChar() && !pObj->IsDisconnected() )
+			vPoints.emplace_back(pObj->GetTopPoint());
+	}
+
+	// CWorldSearch: items and chars in sight of the chars.
+	if ( !vPoints.empty() )
+	{
+		const uint uiSearches = 20000;
+		ullong uiFound = 0;
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiSearches; ++i )
+		{
+			CWorldSearch AreaItems(vPoints[i % vPoints.size()], UO_MAP_VIEW_SIGHT);
+			while ( AreaItems.GetItem() != nullptr )
+				++uiFound;
+		}
+		AddResult("CWorldSearch items (sight)", uiSearches, GetPreciseSysTimeMicro() - iTimeStart);
+
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiSearches; ++i )
+		{
+			CWorldSearch AreaChars(vPoints[i % vPoints.size()], UO_MAP_VIEW_SIGHT);
+			while ( AreaChars.GetChar() != nullptr )
+				++uiFound;
+		}
+		AddResult("CWorldSearch chars (sight)", uiSearches, GetPreciseSysTimeMicro() - iTimeStart);
+		uiSink += uiFound;
+	}
+
+	// CContainer::ContentCount: resources in the containers of the world (sub containers included), walking their content
+	// and then from the totals (EF_ContainerTotals), both kept and rebuilt at each count as if the content had changed.
+	{
+		std::vector<CItemContainer *> vConts;
+		for ( uint uiTry = 0; (uiTry < 65536) && (vConts.size() < 256) && (dwUIDs > 1); ++uiTry )
+		{
+			CItemContainer * pCont = dynamic_cast<CItemContainer *>(g_World.FindUID((dword)CSRand::genRandInt32(1, (int32)(dwUIDs - 1))));
+			if ( (pCont != nullptr) && (pCont->ContentCountAll() >= 8) )
+				vConts.emplace_back(pCont);
+		}
+		if ( !vConts.empty() )
+		{
+			const CResourceID pRids[] =
+			{
+				CResourceID(RES_TYPEDEF, IT_GOLD), CResourceID(RES_TYPEDEF, IT_REAGENT),
+				CResourceID(RES_ITEMDEF, ITEMID_LOG_1), CResourceID(RES_ITEMDEF, ITEMID_INGOT_IRON)
+			};
+			const uint uiFlagsPrev = g_Cfg.m_iExperimentalFlags;
+			const uint uiOps = 200000;
+
+			g_Cfg.m_iExperimentalFlags &= ~EF_ContainerTotals;
+			iTimeStart = GetPreciseSysTimeMicro();
+			for ( uint i = 0; i < uiOps; ++i )
+				uiSink += (ullong)vConts[(i >> 2) % vConts.size()]->ContentCount(pRids[i & 3]);
+			AddResult("CContainer::ContentCount (walk)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+
+			g_Cfg.m_iExperimentalFlags |= EF_ContainerTotals;
+			iTimeStart = GetPreciseSysTimeMicro();
+			for ( uint i = 0; i < uiOps; ++i )
+				uiSink += (ullong)vConts[(i >> 2) % vConts.size()]->ContentCount(pRids[i & 3]);
+			AddResult("CContainer::ContentCount (totals)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+
+			iTimeStart = GetPreciseSysTimeMicro();
+			for ( uint i = 0; i < uiOps; ++i )
+			{
+				CItemContainer * pCont = vConts[(i >> 2) % vConts.size()];
+				pCont->InvalidateResourceTotals();
+				uiSink += (ullong)pCont->ContentCount(pRids[i & 3]);
+			}
+			AddResult("CContainer::ContentCount (rebuilt)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+
+			for ( CItemContainer * pCont : vConts )
+				pCont->InvalidateResourceTotals();	// Don't leave them around if the flag is cleared.
+			g_Cfg.m_iExperimentalFlags = uiFlagsPrev;
+		}
+	}
+
+	// CSectorBase::GetRegion: the area and the room or multi of the chars, as looked up when they move.
+	if ( !vPoints.empty() )
+	{
+		const uint uiOps = 1000000;
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiOps; ++i )
+			uiSink += (ullong)(size_t)vPoints[i % vPoints.size()].GetRegion(REGION_TYPE_AREA);
+		AddResult("CSectorBase::GetRegion (area)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiOps; ++i )
+			uiSink += (ullong)(size_t)vPoints[i % vPoints.size()].GetRegion(REGION_TYPE_MULTI|REGION_TYPE_ROOM);
+		AddResult("CSectorBase::GetRegion (room, multi)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+	}
+
+	// CPathFinder: from the char running the benchmark to random points around it.
+	CChar * pChar = (pSrc != nullptr) ? pSrc->GetChar() : nullptr;
+	if ( (pChar != nullptr) && !pChar->IsDisconnected() )
+	{
+		const uint uiOps = 200;
+		const CPointMap ptChar(pChar->GetTopPoint());
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiOps; ++i )
+		{
+			CPointMap ptTarget(ptChar);
+			ptTarget.m_x += (short)CSRand::genRandInt32(-10, 10);
+			ptTarget.m_y += (short)CSRand::genRandInt32(-10, 10);
+			std::unique_ptr<CPathFinder> pPath = std::make_unique<CPathFinder>(pChar, ptTarget);
+			uiSink += pPath->FindPath() ? pPath->LastPathSize() : 0;
+		}
+		AddResult("CPathFinder::FindPath (10 tiles)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+	}
+
+	// CHuffman::Compress: 4 KB of outgoing data.
+	{
+		std::unique_ptr<byte[]> pInput = std::make_unique<byte[]>(4096);
+		std::unique_ptr<byte[]> pOutput = std::make_unique<byte[]>(4096 * 2);
+		for ( uint i = 0; i < 4096; ++i )
+			pInput[i] = (i % 7) ? (byte)(i & 0x1F) : (byte)CSRand::genRandInt32(0, 0xFF);	// Mostly small values, like the packets.
+
+		const uint uiOps = 5000;
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiOps; ++i )
+			uiSink += CHuffman::Compress(pOutput.get(), pInput.get(), 4096 * 2, 4096);
+		AddResult("CHuffman::Compress (4 KB)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+	}
+
+	// CCrypto: 4 KB of incoming game data, with the first client key of each encryption (SphereCrypt.ini).
+	{
+		std::unique_ptr<byte[]> pInput = std::make_unique<byte[]>(4096);
+		std::unique_ptr<byte[]> pOutput = std::make_unique<byte[]>(4096);
+		for ( uint i = 0; i < 4096; ++i )
+			pInput[i] = (byte)CSRand::genRandInt32(0, 0xFF);
+
+		const ENCRYPTION_TYPE pEncTypes[] = { ENC_TFISH, ENC_BFISH };
+		for ( const ENCRYPTION_TYPE enc : pEncTypes )
+		{
+			size_t iKey = 0;
+			while ( (iKey < CCrypto::client_keys.size()) && (CCrypto::client_keys[iKey].m_EncType != enc) )
+				++iKey;
+			if ( iKey >= CCrypto::client_keys.size() )
+				continue;
+
+			CCrypto crypt;
+			crypt.SetClientVerIndex(iKey);
+			crypt.InitFast(0x7F000001, CONNECT_GAME, false);
+
+			const uint uiOps = 5000;
+			iTimeStart = GetPreciseSysTimeMicro();
+			for ( uint i = 0; i < uiOps; ++i )
+				uiSink += crypt.Decrypt(pOutput.get(), pInput.get(), 4096, 4096) ? pOutput[i & 0xFFF] : 0;
+			AddResult((enc == ENC_TFISH) ? "CCrypto::Decrypt Twofish (4 KB)" : "CCrypto::Decrypt Blowfish (4 KB)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+
+			if ( enc == ENC_TFISH )	// Outgoing data is only encrypted for the Twofish clients (MD5 mask).
+			{
+				iTimeStart = GetPreciseSysTimeMicro();
+				for ( uint i = 0; i < uiOps; ++i )
+					uiSink += crypt.Encrypt(pOutput.get(), pInput.get(), 4096, 4096) ? pOutput[i & 0xFFF] : 0;
+				AddResult("CCrypto::Encrypt Twofish (4 KB)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+			}
+		}
+	}
+
+	if ( uiSink == 0 )
+		g_Log.EventDebug("Benchmark: nothing found.\n");
+}
+
+void CServerBench::RunWorldChanges( CTextConsole * pSrc )
+{
+	ADDTOCALLSTACK("CServerBench::RunWorldChanges");
+	UNREFERENCED_PARAMETER(pSrc);
+	ullong uiSink = 0;
+	llong iTimeStart;
+
+	// CWorldThread::AllocUID: UIDs reserved (place holders) after the ones of the world, then a few freed at random and
+	// taken again, with the table almost full. The free slots are found with the bitmap, then scanning the table from
+	// the last UID allocated, as the allocation did once the free UIDs of the garbage collection were used up.
+	{
+		std::vector<dword> vHeld(0x10000);
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( dword & dwUID : vHeld )
+			dwUID = g_World.AllocUID(0, UID_PLACE_HOLDER);
+		AddResult("CWorldThread::AllocUID (new slots)", vHeld.size(), GetPreciseSysTimeMicro() - iTimeStart);
+
+		std::vector<ushort> vFree(4096);
+		for ( ushort & uiFree : vFree )
+			uiFree = (ushort)CSRand::genRandInt32(0, 0xFFFF);
+		for ( size_t i = 0; i < 64; ++i )
+		{
+			g_World.FreeUID(vHeld[vFree[i]]);
+			vHeld[vFree[i]] = 0;
+		}
+
+		dword dwScanLast = vHeld.back();
+		for ( int iScan = 0; iScan < 2; ++iScan )
+		{
+			const uint uiOps = 100000;
+			iTimeStart = GetPreciseSysTimeMicro();
+			for ( uint i = 0; i < uiOps; ++i )
+			{
+				dword & dwUID = vHeld[vFree[i & 0xFFF]];
+				if ( dwUID != 0 )
+					g_World.FreeUID(dwUID);
+
+				dword dwIndex = 0;
+				if ( iScan )
+				{
+					const dword dwCount = g_World.GetUIDCount();
+					dwIndex = dwScanLast;
+					for ( dword dwLeft = dwCount - 1; g_World._ppUIDObjArray[dwIndex] != nullptr; )
+					{
+						if ( !--dwIndex )
+							dwIndex = dwCount - 1;
+						if ( !--dwLeft )
+						{
+							dwIndex = dwCount;
+							break;
+						}
+					}
+				}
+				dwUID = dwScanLast = g_World.AllocUID(dwIndex, UID_PLACE_HOLDER);
+			}
+			AddResult(iScan ? "FreeUID+AllocUID (slot scan)" : "FreeUID+AllocUID (bitmap)", uiOps, GetPreciseSysTimeMicro() - iTimeStart);
+		}
+
+		for ( const dword dwUID : vHeld )
+		{
+			if ( dwUID != 0 )
+				g_World.FreeUID(dwUID);
+		}
+		uiSink += g_World.GetUIDCount();
+	}
+
+	// CWorldThread::GarbageCollection_UIDs: every object of the world checked (and fixed) as at startup, time per object.
+	// The log tells the time of the check and fix passes, and the number of threads the check was split over.
+	{
+		const uint uiPasses = 4;
+		const ullong uiObjs = CObjBase::sm_iCount;
+		iTimeStart = GetPreciseSysTimeMicro();
+		for ( uint i = 0; i < uiPasses; ++i )
+			g_World.GarbageCollection_UIDs();
+		AddResult("GarbageCollection_UIDs (per object)", uiPasses * uiObjs, GetPreciseSysTimeMicro() - iTimeStart);
+		uiSink += CObjBase::sm_iCount;
+	}
+
+	// CWorld::RespawnDeadNPCs: a thousand dead NPCs respawned at their home, all in one tick (RespawnPerTick=0), then a few
+	// per tick: the ticks are timed one by one, and the longest one is reported too. The NPCs are only flagged dead, no corpse.
+	{
+		std::vector<CChar *> vNPCs;
+		const dword dwUIDs = g_World.GetUIDCount();
+		for ( uint uiTry = 0; (uiTry < 65536) && (vNPCs.size() < 1000) && (dwUIDs > 1); ++uiTry )
+		{
+			CChar * pChar = dynamic_cast<CChar *>(g_World.FindUID((dword)CSRand::genRandInt32(1, (int32)(dwUIDs - 1))));
+			if ( (pChar != nullptr) && pChar->m_pNPC && pChar->m_ptHome.IsValidPoint() && (std::find(vNPCs.begin(), vNPCs.end(), pChar) == vNPCs.end()) )
+				vNPCs.emplace_back(pChar);
+		}
+		auto SetDead = [&vNPCs]()
+		{
+			for ( CChar * pChar : vNPCs )
+			{
+				pChar->m_prev_id = pChar->GetID();
+				pChar->m_prev_Hue = pChar->GetHue();
+				pChar->StatFlag_Set(STATF_DEAD);
+			}
+		};
+
+		if ( !vNPCs.empty() )
+		{
+			const int iRespawnPerTickPrev = g_Cfg._iRespawnPerTick;
+			g_Cfg._iRespawnPerTick = 0;
+			SetDead();
+			iTimeStart = GetPreciseSysTimeMicro();
+			g_World.RespawnDeadNPCs();
+			AddResult("RespawnDeadNPCs (one tick)", vNPCs.size(), GetPreciseSysTimeMicro() - iTimeStart);
+
+			g_Cfg._iRespawnPerTick = 10;
+			g_World.RespawnDeadNPCs();	// The first round looks for the dead NPCs in the whole world, then they are added as they die.
+			SetDead();
+			llong iTickMax = 0;
+			uint uiTicks = 0;
+			const llong iTimeRound = GetPreciseSysTimeMicro();
+			g_World.RespawnDeadNPCs();
+			while ( !g_World._vRespawnQueue.empty() )
+			{
+				iTimeStart = GetPreciseSysTimeMicro();
+				g_World.OnTickRespawnRestock();
+				iTickMax = maximum(iTickMax, GetPreciseSysTimeMicro() - iTimeStart);
+				++uiTicks;
+			}
+			AddResult("RespawnDeadNPCs (sliced, all)", vNPCs.size(), GetPreciseSysTimeMicro() - iTimeRound);
+			AddResult("RespawnDeadNPCs (sliced, longest)", 1, iTickMax);
+			g_Cfg._iRespawnPerTick = iRespawnPerTickPrev;
+
+			for ( const CChar * pChar : vNPCs )
+				uiSink += pChar->IsStatFlag(STATF_DEAD) ? 0 : 1;
+			uiSink += uiTicks;
+		}
+	}
+
+	// CChar::OnTick of the NPCs, with the full AI (as near a player): each NPC ticked once per pass, the game clock moving on
+	// between the passes. The NPCs look for chars around them at every tick, then only when a char moved near them since
+	// their last look (EF_NPCEventPerception). The AI is most of the time, the one PROFILE_NPC_AI shows on a server.
+	{
+		std::vector<CChar *> vNPCs;
+		for ( dword dwUID = 1, dwCount = g_World.GetUIDCount(); dwUID < dwCount; ++dwUID )
+		{
+			CChar * pChar = dynamic_cast<CChar *>(g_World.FindUID(dwUID));
+			if ( (pChar != nullptr) && pChar->m_pNPC && !pChar->IsStatFlag(STATF_DEAD) && !pChar->IsDisconnected() )
+				vNPCs.emplace_back(pChar);
+		}
+		for ( int s = 0, qty = g_World._Sectors.GetSectorQty(0); s < qty; ++s )
+			g_World._Sectors.GetSector(0, s)->SetSectorWakeStatus();	// They sleep until a player comes.
+
+		const uint uiFlagsPrev = g_Cfg.m_iExperimentalFlags;
+		const uint uiPasses = 20;
+		for ( int iEvents = 0; iEvents < 2; ++iEvents )
+		{
+			if ( iEvents )
+				g_Cfg.m_iExperimentalFlags |= EF_NPCEventPerception;
+			else
+				g_Cfg.m_iExperimentalFlags &= ~EF_NPCEventPerception;
+
+			llong iMicro = 0;
+			for ( uint uiPass = 0; uiPass < uiPasses; ++uiPass )
+			{
+				g_World._GameClock.Advance();
+				iTimeStart = GetPreciseSysTimeMicro();
+				for ( CChar * pChar : vNPCs )
+				{
+					if ( !pChar->IsDeleted() )
+						uiSink += pChar->OnTick() ? 1 : 0;
+				}
+				iMicro += GetPreciseSysTimeMicro() - iTimeStart;
+			}
+			AddResult(iEvents ? "NPC OnTick (perception: events)" : "NPC OnTick (perception: search)", (ullong)uiPasses * vNPCs.size(), iMicro);
+		}
+		g_Cfg.m_iExperimentalFlags = uiFlagsPrev;
+	}
+
+	if ( uiSink == 0 )
+		g_Log.EventDebug("Benchmark: nothing found.\n");
+}
+
+void CServerBench::Report( CTextConsole * pSrc ) const
+{
+	ADDTOCALLSTACK("CServerBench::Report");
+	for ( const Result & result : _vResults )
+	{
+		const double dNanoPerOp = (result.uiOps > 0) ? ((double)result.iMicro * 1000.0 / (double)result.uiOps) : 0.0;
+		pSrc->SysMessagef("%-36s %10" PRIu64 " ops %10lld us %12.1f ns/op\n", result.szName, (uint64)result.uiOps, result.iMicro, dNanoPerOp);
+	}
+}
+
+bool CServerBench::DumpCSV( lpctstr pszFilePath ) const
+{
+	ADDTOCALLSTACK("CServerBench::DumpCSV");
+	CSFileText fileCSV;
+	if ( !fileCSV.Open(pszFilePath, OF_CREATE|OF_TEXT) )
+		return false;
+
+	fileCSV.Printf("benchmark,ops,total_us,ns_per_op\n");
+	for ( const Result & result : _vResults )
+	{
+		const double dNanoPerOp = (result.uiOps > 0) ? ((double)result.iMicro * 1000.0 / (double)result.uiOps) : 0.0;
+		fileCSV.Printf("\"%s\",%" PRIu64 ",%lld,%.1f\n", result.szName, (uint64)result.uiOps, result.iMicro, dNanoPerOp);
+	}
+	fileCSV.Close();
+	return true;
+}
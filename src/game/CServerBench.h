@@ -0,0 +1,57 @@
+/**
+* @file CServerBench.h
+* @brief Timing of the core containers and hot functions, run on the loaded world.
+*/
+
+#ifndef _INC_CSERVERBENCH_H
+#define _INC_CSERVERBENCH_H
+
+#include "../common/common.h"
+#include <vector>
+
+class CTextConsole;
+
+
+#define SERVERBENCH_NAME_LENGTH	48
+
+class CServerBench
+{
+	// Each benchmark repeats an operation on the world data (defs, resources, sectors...) or on synthetic data,
+	// and reports the time per operation. Run from the console (BENCH), it blocks the server meanwhile.
+public:
+	struct Result
+	{
+		tchar szName[SERVERBENCH_NAME_LENGTH];
+		ullong uiOps;		// Operations timed.
+		llong iMicro;		// Total time.
+	};
+
+private:
+	std::vector<Result> _vResults;
+
+	void AddResult( lpctstr pszName, ullong uiOps, llong iMicro );
+
+public:
+	CServerBench() = default;
+	~CServerBench() = default;
+private:
+	CServerBench(const CServerBench& copy);
+	CServerBench& operator=(const CServerBench& other);
+
+public:
+	/**
+	* @brief Run all the benchmarks. If pSrc is a char, the path finding and world search are done around it.
+	*/
+	void Run( CTextConsole * pSrc );
+	/**
+	* @brief Run the benchmarks creating and deleting objects, or changing the world. Their results are added to the ones of Run.
+	*  Not for a live server: they are run by sphere_bench only, on its synthetic world.
+	*/
+	void RunWorldChanges( CTextConsole * pSrc );
+	void Report( CTextConsole * pSrc ) const;
+	// CSV file: benchmark,ops,total_us,ns_per_op
+	bool DumpCSV( lpctstr pszFilePath ) const;
+};
+
+
+#endif // _INC_CSERVERBENCH_H
@@ -12,6 +12,7 @@
 #include "../network/CNetworkManager.h"
 #include "../network/CSocket.h"
 #include "../sphere/ProfileTask.h"
+#include "../sphere/TickWatchdog.h"
 #include "../sphere/ntwindow.h"
 #include "clients/CAccount.h"
 #include "clients/CClient.h"
@@ -42,11 +43,26 @@ CServerConfig::CServerConfig()
 	m_fUseAuthID		= true;
 	_iMapCacheTime		= 2  * 60 * MSECS_PER_SEC;
 	_iSectorSleepDelay  = 10 * 60 * MSECS_PER_SEC;
+	_iSectorAwakePerTick = 2;
+	_iRespawnPerTick = 10;
+	_iRestockSectorsPerTick = 64;
+	_iMainLoopRate = 100;
+	_iAcctCompactSaves	= 10;
+	_fLogAsync			= false;
 	m_fUseMapDiffs		= false;
 
+	_fNPCAILod				= false;
+	_iNPCAILodFrozenDist	= 2;
+	_iNPCAILodReducedDelay	= 2 * MSECS_PER_SEC;
+	_iNPCPerceptionRefresh	= 5 * MSECS_PER_SEC;
+
 	m_iDebugFlags			= 0;	//DEBUGF_NPC_EMOTE
 	m_fSecure				= true;
 	m_iFreezeRestartTime	= 60;
+	_iTickBudget			= 0;
+	_iTickBudgetTopN		= 10;
+	_fTickStackSampling		= false;
+	_iMetricsInterval		= 0;
 	m_bAgree				= false;
 	m_fMd5Passwords			= false;
 
@@ -406,6 +422,7 @@ bool CServerConfig::r_GetRef( lpctstr & ptcKey, CScriptObj * & pRef )
 
 enum RC_TYPE
 {
+	RC_ACCTCOMPACTSAVES,		// _iAcctCompactSaves
 	RC_ACCTFILES,				// m_sAcctBaseDir
 	RC_ADVANCEDLOS,				// m_iAdvancedLos
 	RC_AGREE,
@@ -524,11 +541,13 @@ enum RC_TYPE
 	RC_LIGHTNIGHT,				// m_iLightNight
 	RC_LOCALIPADMIN,			// m_fLocalIPAdmin
 	RC_LOG,
+	RC_LOGASYNC,				// _fLogAsync
 	RC_LOGMASK,					// GetLogMask
 	RC_LOOTINGISACRIME,			// m_fLootingIsACrime
 	RC_LOSTNPCTELEPORT,			// m_fLostNPCTeleport
 	RC_MAGICFLAGS,
 	RC_MAGICUNLOCKDOOR,			// m_iMagicUnlockDoor
+	RC_MAINLOOPRATE,			// _iMainLoopRate
     RC_MANALOSSFAIL,			// m_fManaLossFail
 	RC_MAPCACHETIME,
 	RC_MAXBASESKILL,			// m_iMaxBaseSkill
@@ -553,6 +572,7 @@ enum RC_TYPE
 	RC_MAXSIZEPERTICK,			// m_iNetMaxLengthPerTick
 	RC_MD5PASSWORDS,			// m_fMd5Passwords
 	RC_MEDIUMCANHEARGHOSTS,		// m_iMediumCanHearGhosts
+	RC_METRICSINTERVAL,			// _iMetricsInterval
 	RC_MINCHARDELETETIME,
 	RC_MINKARMA,				// m_iMinKarma
 	RC_MONSTERFEAR,				// m_fMonsterFear
@@ -575,8 +595,12 @@ enum RC_TYPE
 	RC_NOTOTIMEOUT,
 	RC_NOWEATHER,				// m_fNoWeather
 	RC_NPCAI,					// m_iNpcAi
+	RC_NPCAILOD,				// _fNPCAILod
+	RC_NPCAILODFROZENDIST,		// _iNPCAILodFrozenDist
+	RC_NPCAILODREDUCEDDELAY,	// _iNPCAILodReducedDelay
 	RC_NPCCANFIZZLEONHIT,		// m_fNPCCanFizzle
 	RC_NPCNOFAMETITLE,			// m_NPCNoFameTitle
+	RC_NPCPERCEPTIONREFRESH,	// _iNPCPerceptionRefresh
 	RC_NPCSKILLSAVE,			// m_iSaveNPCSkills
 	RC_NPCTRAINCOST,			// m_iTrainSkillCost
 	RC_NPCTRAINMAX,				// m_iTrainSkillMax
@@ -593,6 +617,8 @@ enum RC_TYPE
 	RC_RACIALFLAGS,				// m_iRacialFlags
 	RC_REAGENTLOSSFAIL,			// m_fReagentLossFail
 	RC_REAGENTSREQUIRED,
+	RC_RESPAWNPERTICK,			// _iRespawnPerTick
+	RC_RESTOCKSECTORSPERTICK,	// _iRestockSectorsPerTick
 	RC_REVEALFLAGS,				// m_iRevealFlags
 	RC_RTICKS,
 	RC_RTIME,
@@ -602,6 +628,7 @@ enum RC_TYPE
 	RC_SAVESECTORSPERTICK,		// m_iSaveSectorsPerTick
     RC_SAVESTEPMAXCOMPLEXITY,	// m_iSaveStepMaxComplexity
 	RC_SCPFILES,
+	RC_SECTORAWAKEPERTICK,		// _iSectorAwakePerTick
 	RC_SECTORSLEEP,				// _iSectorSleepDelay
 	RC_SECURE,
 	RC_SKILLPRACTICEMAX,		// m_iSkillPracticeMax
@@ -622,7 +649,10 @@ enum RC_TYPE
 	RC_TELEPORTSOUNDPLAYERS,	// m_iSpell_Teleport_Sound_Players
 	RC_TELEPORTSOUNDSTAFF,		// m_iSpell_Teleport_Sound_Staff
 	RC_TELNETLOG,				// m_fTelnetLog
+	RC_TICKBUDGET,				// _iTickBudget
+	RC_TICKBUDGETTOPN,			// _iTickBudgetTopN
     RC_TICKPERIOD,
+	RC_TICKSTACKSAMPLING,		// _fTickStackSampling
 	RC_TIMERCALL,				// m_iTimerCall
 	RC_TIMEUP,
 	RC_TOOLTIPCACHE,			// m_iTooltipCache
@@ -654,6 +684,7 @@ enum RC_TYPE
 
 const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1] =
 {
+	{ "ACCTCOMPACTSAVES",		{ ELEM_INT,		OFFSETOF(CServerConfig,_iAcctCompactSaves),		0 }},
 	{ "ACCTFILES",				{ ELEM_CSTRING,	OFFSETOF(CServerConfig,m_sAcctBaseDir),			0 }},
 	{ "ADVANCEDLOS",			{ ELEM_INT,		OFFSETOF(CServerConfig,m_iAdvancedLos),			0 }},
 	{ "AGREE",					{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_bAgree),				0 }},
@@ -772,11 +803,13 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1] =
 	{ "LIGHTNIGHT",				{ ELEM_INT,		OFFSETOF(CServerConfig,m_iLightNight),			0 }},
 	{ "LOCALIPADMIN",			{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_fLocalIPAdmin),		0 }}, // The local ip is assumed to be the admin.
 	{ "LOG",					{ ELEM_VOID,	0,											0 }},
+	{ "LOGASYNC",				{ ELEM_BOOL,	OFFSETOF(CServerConfig,_fLogAsync),				0 }},
 	{ "LOGMASK",				{ ELEM_VOID,	0,											0 }}, // GetLogMask
 	{ "LOOTINGISACRIME",		{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_fLootingIsACrime),		0 }},
 	{ "LOSTNPCTELEPORT",		{ ELEM_INT,		OFFSETOF(CServerConfig,m_iLostNPCTeleport),		0 }},
 	{ "MAGICFLAGS",				{ ELEM_MASK_INT,OFFSETOF(CServerConfig,m_iMagicFlags),			0 }},
 	{ "MAGICUNLOCKDOOR",		{ ELEM_INT,		OFFSETOF(CServerConfig,m_iMagicUnlockDoor),		0 }},
+	{ "MAINLOOPRATE",			{ ELEM_INT,		OFFSETOF(CServerConfig,_iMainLoopRate),			0 }},
     { "MANALOSSFAIL",		    { ELEM_BOOL,	OFFSETOF(CServerConfig,m_fManaLossFail),		0 }},
 	{ "MAPCACHETIME",			{ ELEM_INT,		OFFSETOF(CServerConfig,_iMapCacheTime),		0 }},
 	{ "MAXBASESKILL",			{ ELEM_INT,		OFFSETOF(CServerConfig,m_iMaxBaseSkill),		0 }},
@@ -801,6 +834,7 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1] =
 	{ "MAXSIZEPERTICK",			{ ELEM_INT,		OFFSETOF(CServerConfig,m_iNetMaxLengthPerTick),	0 }},
 	{ "MD5PASSWORDS",			{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_fMd5Passwords),		0 }},
 	{ "MEDIUMCANHEARGHOSTS",	{ ELEM_INT,		OFFSETOF(CServerConfig,m_iMediumCanHearGhosts),	0 }},
+	{ "METRICSINTERVAL",		{ ELEM_INT,		OFFSETOF(CServerConfig,_iMetricsInterval),		0 }},
 	{ "MINCHARDELETETIME",		{ ELEM_INT,		OFFSETOF(CServerConfig,m_iMinCharDeleteTime),	0 }},
 	{ "MINKARMA",				{ ELEM_INT,		OFFSETOF(CServerConfig,m_iMinKarma),			0 }},
 	{ "MONSTERFEAR",			{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_fMonsterFear),			0 }},
@@ -823,8 +857,12 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1] =
 	{ "NOTOTIMEOUT",			{ ELEM_INT,		OFFSETOF(CServerConfig,m_iNotoTimeout),			0 }},
 	{ "NOWEATHER",				{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_fNoWeather),			0 }},
 	{ "NPCAI",					{ ELEM_INT,		OFFSETOF(CServerConfig,m_iNpcAi),				0 }},
+	{ "NPCAILOD",				{ ELEM_BOOL,	OFFSETOF(CServerConfig,_fNPCAILod),				0 }},
+	{ "NPCAILODFROZENDIST",		{ ELEM_INT,		OFFSETOF(CServerConfig,_iNPCAILodFrozenDist),	0 }},
+	{ "NPCAILODREDUCEDDELAY",	{ ELEM_VOID,	0,											0 }},
 	{ "NPCCANFIZZLEONHIT",		{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_fNPCCanFizzleOnHit),		0 }},
 	{ "NPCNOFAMETITLE",			{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_NPCNoFameTitle),		0 }},
+	{ "NPCPERCEPTIONREFRESH",	{ ELEM_VOID,	0,											0 }},
 	{ "NPCSKILLSAVE",			{ ELEM_INT,		OFFSETOF(CServerConfig,m_iSaveNPCSkills),		0 }},
 	{ "NPCTRAINCOST",			{ ELEM_INT,		OFFSETOF(CServerConfig,m_iTrainSkillCost),		0 }},
 	{ "NPCTRAINMAX",			{ ELEM_INT,		OFFSETOF(CServerConfig,m_iTrainSkillMax),		0 }},
@@ -841,6 +879,8 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1] =
 	{ "RACIALFLAGS",			{ ELEM_MASK_INT,OFFSETOF(CServerConfig,m_iRacialFlags),			0 }},
 	{ "REAGENTLOSSFAIL",		{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_fReagentLossFail),		0 }},
 	{ "REAGENTSREQUIRED",		{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_fReagentsRequired),	0 }},
+	{ "RESPAWNPERTICK",			{ ELEM_INT,		OFFSETOF(CServerConfig,_iRespawnPerTick),		0 }},
+	{ "RESTOCKSECTORSPERTICK",	{ ELEM_INT,		OFFSETOF(CServerConfig,_iRestockSectorsPerTick),	0 }},
 	{ "REVEALFLAGS",			{ ELEM_MASK_INT,OFFSETOF(CServerConfig,m_iRevealFlags),			0 }},
 	{ "RTICKS",					{ ELEM_VOID,	0,											0 }},
 	{ "RTIME",					{ ELEM_VOID,	0,											0 }},
@@ -850,6 +890,7 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1] =
 	{ "SAVESECTORSPERTICK",		{ ELEM_INT,		OFFSETOF(CServerConfig,m_iSaveSectorsPerTick),	0 }},
 	{ "SAVESTEPMAXCOMPLEXITY",	{ ELEM_INT,		OFFSETOF(CServerConfig,m_iSaveStepMaxComplexity),	0 }},
 	{ "SCPFILES",				{ ELEM_CSTRING,	OFFSETOF(CServerConfig,m_sSCPBaseDir),			0 }},
+	{ "SECTORAWAKEPERTICK",		{ ELEM_INT,		OFFSETOF(CServerConfig,_iSectorAwakePerTick),	0 }},
 	{ "SECTORSLEEP",			{ ELEM_INT,		OFFSETOF(CServerConfig,_iSectorSleepDelay),		0 }},
 	{ "SECURE",					{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_fSecure),				0 }},
 	{ "SKILLPRACTICEMAX",		{ ELEM_INT,		OFFSETOF(CServerConfig,m_iSkillPracticeMax),	0 }},
@@ -870,7 +911,10 @@ const CAssocReg CServerConfig::sm_szLoadKeys[RC_QTY+1] =
 	{ "TELEPORTSOUNDPLAYERS",	{ ELEM_INT,		OFFSETOF(CServerConfig,m_iSpell_Teleport_Sound_Players),	0 }},
 	{ "TELEPORTSOUNDSTAFF",		{ ELEM_INT,		OFFSETOF(CServerConfig,m_iSpell_Teleport_Sound_Staff),		0 }},
 	{ "TELNETLOG",				{ ELEM_BOOL,	OFFSETOF(CServerConfig,m_fTelnetLog),			0 }},
+	{ "TICKBUDGET",				{ ELEM_INT,		OFFSETOF(CServerConfig,_iTickBudget),			0 }},
+	{ "TICKBUDGETTOPN",			{ ELEM_INT,		OFFSETOF(CServerConfig,_iTickBudgetTopN),		0 }},
     { "TICKPERIOD",				{ ELEM_INT,	    0,			                                    0 }},
+	{ "TICKSTACKSAMPLING",		{ ELEM_BOOL,	OFFSETOF(CServerConfig,_fTickStackSampling),	0 }},
 	{ "TIMERCALL",				{ ELEM_INT,		OFFSETOF(CServerConfig,_iTimerCall),			0 }},
 	{ "TIMEUP",					{ ELEM_VOID,	0,											0 }},
 	{ "TOOLTIPCACHE",			{ ELEM_INT,		OFFSETOF(CServerConfig,m_iTooltipCache),		0 }},
@@ -1187,6 +1231,15 @@ bool CServerConfig::r_LoadVal( CScript &s )
 		case RC_NOTOTIMEOUT:
 			m_iNotoTimeout = s.GetArgVal();
 			break;
+		case RC_NPCAILODFROZENDIST:
+			_iNPCAILodFrozenDist = maximum(1, s.GetArgVal());
+			break;
+		case RC_NPCAILODREDUCEDDELAY:
+			_iNPCAILodReducedDelay = s.GetArgLLVal() * MSECS_PER_TENTH;
+			break;
+		case RC_NPCPERCEPTIONREFRESH:
+			_iNPCPerceptionRefresh = maximum(1, s.GetArgLLVal()) * MSECS_PER_TENTH;
+			break;
 		case RC_WOOLGROWTHTIME:
 			m_iWoolGrowthTime = s.GetArgLLVal() * 60 * MSECS_PER_SEC;
 			break;
@@ -1256,6 +1309,12 @@ bool CServerConfig::r_LoadVal( CScript &s )
 			m_iSpellTimeout = s.GetArgLLVal() * MSECS_PER_SEC;
 			break;
 
+		case RC_SECTORAWAKEPERTICK:
+			_iSectorAwakePerTick = maximum(1, s.GetArgVal());
+			break;
+		case RC_TICKBUDGETTOPN:
+			_iTickBudgetTopN = minimum(maximum(1, s.GetArgVal()), TICKWATCHDOG_MAX_UNITS);
+			break;
 		case RC_SECTORSLEEP:
 			_iSectorSleepDelay = s.GetArgLLVal() * 60 * MSECS_PER_SEC;
 			break;
@@ -1868,6 +1927,12 @@ bool CServerConfig::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole *
 		case RC_NOTOTIMEOUT:
 			sVal.FormatVal(m_iNotoTimeout);
 			break;
+		case RC_NPCAILODREDUCEDDELAY:
+			sVal.FormatLLVal(_iNPCAILodReducedDelay / MSECS_PER_TENTH);
+			break;
+		case RC_NPCPERCEPTIONREFRESH:
+			sVal.FormatLLVal(_iNPCPerceptionRefresh / MSECS_PER_TENTH);
+			break;
         case RC_MAXHOUSESACCOUNT:
             sVal.FormatUCVal(_iMaxHousesAccount);
             break;
@@ -4192,6 +4257,11 @@ void CServerConfig::PrintEFOFFlags(bool bEF, bool bOF, CTextConsole *pSrc)
 		if ( IsSetEF(EF_UsePingServer) )			catresname(zExperimentalFlags, "UsePingServer");
 		if ( IsSetEF(EF_FixCanSeeInClosedConts) )	catresname(zExperimentalFlags, "FixCanSeeInClosedConts");
         if ( IsSetEF(EF_WalkCheckHeightMounted) )	catresname(zExperimentalFlags, "WalkCheckHeightMounted");
+        if ( IsSetEF(EF_NPCEventPerception) )		catresname(zExperimentalFlags, "NPCEventPerception");
+        if ( IsSetEF(EF_TempBufferScopes) )			catresname(zExperimentalFlags, "TempBufferScopes");
+        if ( IsSetEF(EF_ParseTextCache) )			catresname(zExperimentalFlags, "ParseTextCache");
+        if ( IsSetEF(EF_ObjectPools) )				catresname(zExperimentalFlags, "ObjectPools");
+        if ( IsSetEF(EF_ContainerTotals) )			catresname(zExperimentalFlags, "ContainerTotals");
 
 		if ( zExperimentalFlags[0] != '\0' )
 		{
@@ -4439,6 +4509,10 @@ bool CServerConfig::Load( bool fResync )
         pRegion->MakeRegionDefname();
     }
 
+	// The DEFs (and the defnames of the resources) are all there: index them for the lookups, the few defined later
+	//  by the scripts go in the overlay of the index. Rebuilt on every resync.
+	g_Exp.m_VarDefs.Freeze();
+
 	// parse eventsitem
 	m_iEventsItemLink.clear();
 	if ( ! m_sEventsItem.IsEmpty() )
@@ -80,6 +80,11 @@ enum EF_TYPE
 	EF_UsePingServer				= 0x0008000,    // Enable the experimental Ping Server (for showing pings on the server list, uses UDP port 12000)
 	EF_FixCanSeeInClosedConts		= 0x0020000,    // Change CANSEE to return 0 for items inside containers that a client hasn't opened
     EF_WalkCheckHeightMounted       = 0x0040000,    // Unlike the client does, assume an height increased by 4 in walkchecks if the char is mounted. Enabling this may prevent mounted characters to walk under places they could before.
+    EF_NPCEventPerception           = 0x0080000,    // NPCs look around for other chars only when a char moved in, entered or left the sectors around them (plus a periodic refresh), instead of searching at every think.
+    EF_TempBufferScopes             = 0x0100000,    // Recycle the temporary string buffers used by a trigger (or a server tick) when it ends.
+    EF_ParseTextCache               = 0x0200000,    // Keep the position of the <...> substitutions of the parsed script lines, instead of scanning them at every execution.
+    EF_ObjectPools                  = 0x0400000,    // Allocate items and chars from slabs with a size class for each object type.
+    EF_ContainerTotals              = 0x0800000,    // Containers keep the total amount of each item id/type inside, for resource counts and consumption.
 };
 
 /**
@@ -207,13 +212,27 @@ public:
 	bool m_fUseAuthID;          // Use the OSI AuthID to avoid possible hijack to game server.
 	int64  _iMapCacheTime;     // Time in sec to keep unused map data..
 	int64  _iSectorSleepDelay;    // The mask for how long sectors will sleep.
+	int    _iSectorAwakePerTick;  // Max sleeping sectors awaken per tick because a client got near them.
+	int    _iRespawnPerTick;      // Max dead NPCs respawned per tick by the periodic respawn (0 = all of them at once).
+	int    _iRestockSectorsPerTick;	// Max sectors restocked per tick by a world RESTOCK (0 = all of them at once).
+	int    _iMainLoopRate;        // Min main loop iterations per second when it sleeps waiting for timers and packets (0 = never sleep).
 	bool m_fUseMapDiffs;        // Whether or not to use map diff files.
 
+	bool  _fNPCAILod;               // Scale NPC AI ticking by the distance from the nearest player.
+	int   _iNPCAILodFrozenDist;     // NPCs farther than this many sectors from any player don't think.
+	int64 _iNPCAILodReducedDelay;   // Minimum delay (in msecs) between two AI ticks for NPCs out of any player's view.
+	int64 _iNPCPerceptionRefresh;   // With EF_NPCEventPerception, NPCs look around after this long (in msecs) even if nothing moved.
+
 	CSString m_sWorldBaseDir;   // save\" = world files go here.
 	CSString m_sAcctBaseDir;    // Where do the account files go/come from ?
+	int  _iAcctCompactSaves;    // Incremental accounts saves (journal only) between two full saves of the accounts file.
 
 	bool m_fSecure;             // Secure mode. (will trap exceptions)
 	int64  m_iFreezeRestartTime;  // # seconds before restarting.
+	int    _iTickBudget;          // Ticks longer than this (msecs) are logged with their most expensive units of work. 0 = disabled.
+	int    _iTickBudgetTopN;      // How many units of work are logged for each slow tick.
+	bool   _fTickStackSampling;   // A thread samples the main thread call stack, for flame graphs.
+	int    _iMetricsInterval;     // Seconds between two exports of the metrics to metrics.prom. 0 = disabled.
 #define DEBUGF_NPC_EMOTE		0x0001  // NPCs emote their actions.
 #define DEBUGF_ADVANCE_STATS	0x0002  // prints stat % skill changes (only for _DEBUG builds).
 #define DEBUGF_EXP				0x0200  // experience gain/loss.
@@ -400,6 +419,7 @@ public:
 
 	int m_iCommandLog;		// Only commands issued by this plevel and higher will be logged
 	bool m_fTelnetLog;		// Set to 1 to enable logging of commands issued via telnet
+	bool _fLogAsync;		// Console output and log file writes are done by a dedicated thread.
 
 	bool m_fUsecrypt;		// Set this to 1 to allow login to encrypted clients
 	bool m_fUsenocrypt;		// Set this to 1 to allow login to unencrypted clients
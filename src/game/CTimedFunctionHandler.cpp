@@ -37,9 +37,17 @@ void CTimedFunctionHandler::OnTick()
 				break;
 			}
 			TimedFunction* tf = *it;
+			if ( !tf->uid.IsValidUID() )
+			{
+				// Removed by Erase or Stop, it was only waiting to be pulled out of its bucket.
+				m_tfRecycled.emplace_back( tf );
+				it = m_timedFunctions[tick].erase( it );
+				continue;
+			}
 			tf->elapsed -= 1;
 			if ( tf->elapsed <= 1 )
 			{
+				_IndexRemove( tf );
 				CObjBase * obj = tf->uid.ObjFind();
 
 				if ( obj != nullptr ) //just in case
@@ -83,36 +91,55 @@ void CTimedFunctionHandler::OnTick()
 	}
 }
 
+void CTimedFunctionHandler::_IndexAdd( TimedFunction* tf )
+{
+	m_tfIndex[tf->uid.GetObjUID()].emplace_back( tf );
+}
+
+void CTimedFunctionHandler::_IndexRemove( TimedFunction* tf )
+{
+	auto itIndex = m_tfIndex.find( tf->uid.GetObjUID() );
+	if ( itIndex == m_tfIndex.end() )
+		return;
+
+	std::vector<TimedFunction *>& vecUID = itIndex->second;
+	auto it = std::find( vecUID.begin(), vecUID.end(), tf );
+	if ( it != vecUID.end() )
+	{
+		// Order doesn't matter here, so avoid shifting the whole vector.
+		*it = vecUID.back();
+		vecUID.pop_back();
+	}
+	if ( vecUID.empty() )
+		m_tfIndex.erase( itIndex );
+}
+
 void CTimedFunctionHandler::Erase( CUID uid )
 {
 	ADDTOCALLSTACK("CTimedFunctionHandler::Erase");
-	for ( int tick = 0; tick < TICKS_PER_SEC; ++tick )
+	auto itIndex = m_tfIndex.find( uid.GetObjUID() );
+	if ( itIndex == m_tfIndex.end() )
+		return;
+
+	for ( TimedFunction* tf : itIndex->second )
 	{
-		for ( auto it = m_timedFunctions[tick].begin(); it != m_timedFunctions[tick].end(); )	// the end iterator changes at each stl container erase call
-		{
-			TimedFunction* tf = *it;
-			if ( tf->uid == uid)
-			{
-				m_tfRecycled.emplace_back( tf );
-				it = m_timedFunctions[tick].erase( it );
-			}
-			else
-				++it;
-		}
+		// Mark it as dead: OnTick will remove and recycle it.
+		tf->uid.InitUID();
 	}
+	m_tfIndex.erase( itIndex );
 }
 
 int CTimedFunctionHandler::IsTimer( CUID uid, lpctstr funcname )
 {
 	ADDTOCALLSTACK("CTimedFunctionHandler::IsTimer");
-	for ( int tick = 0; tick < TICKS_PER_SEC; ++tick )
+	auto itIndex = m_tfIndex.find( uid.GetObjUID() );
+	if ( itIndex == m_tfIndex.end() )
+		return 0;
+
+	for ( const TimedFunction* tf : itIndex->second )
 	{
-		for ( auto it = m_timedFunctions[tick].begin(), end = m_timedFunctions[tick].end(); it != end; ++it)
-		{
-			TimedFunction* tf = *it;
-			if ( (tf->uid == uid) && (!strcmpi( tf->funcname, funcname)) )
-				return tf->elapsed;
-		}
+		if ( !strcmpi( tf->funcname, funcname) )
+			return tf->elapsed;
 	}
 	return 0;
 }
@@ -120,20 +147,25 @@ int CTimedFunctionHandler::IsTimer( CUID uid, lpctstr funcname )
 void CTimedFunctionHandler::Stop( CUID uid, lpctstr funcname )
 {
 	ADDTOCALLSTACK("CTimedFunctionHandler::Stop");
-	for ( int tick = 0; tick < TICKS_PER_SEC; ++tick )
+	auto itIndex = m_tfIndex.find( uid.GetObjUID() );
+	if ( itIndex == m_tfIndex.end() )
+		return;
+
+	std::vector<TimedFunction *>& vecUID = itIndex->second;
+	for ( auto it = vecUID.begin(); it != vecUID.end(); )
 	{
-		for ( auto it = m_timedFunctions[tick].begin(); it != m_timedFunctions[tick].end(); )	// the end iterator changes at each erase call
+		TimedFunction* tf = *it;
+		if ( !strcmpi( tf->funcname, funcname) )
 		{
-			TimedFunction* tf = *it;
-			if (( tf->uid == uid) && (!strcmpi( tf->funcname, funcname)))
-			{
-				m_tfRecycled.emplace_back( tf );
-				it = m_timedFunctions[tick].erase( it );
-			}
-			else
-				++it;
+			// Mark it as dead: OnTick will remove and recycle it.
+			tf->uid.InitUID();
+			it = vecUID.erase( it );
 		}
+		else
+			++it;
 	}
+	if ( vecUID.empty() )
+		m_tfIndex.erase( itIndex );
 }
 
 void CTimedFunctionHandler::Clear()
@@ -149,6 +181,7 @@ void CTimedFunctionHandler::Clear()
     }
     m_tfQueuedToBeAdded.clear();
     m_tfRecycled.clear();
+    m_tfIndex.clear();
 }
 
 TRIGRET_TYPE CTimedFunctionHandler::Loop(lpctstr funcname, int LoopsMade, CScriptLineContext StartContext,
@@ -168,7 +201,7 @@ TRIGRET_TYPE CTimedFunctionHandler::Loop(lpctstr funcname, int LoopsMade, CScrip
 			}
 
 			TimedFunction* tf = *it;
-			if (!strcmpi(tf->funcname, funcname))
+			if (tf->uid.IsValidUID() && !strcmpi(tf->funcname, funcname))
 			{
 				CObjBase * pObj = tf->uid.ObjFind();
                 if (!pObj)
@@ -212,6 +245,7 @@ void CTimedFunctionHandler::Add( CUID uid, int numSeconds, lpctstr funcname )
 	tf->uid = uid;
 	tf->elapsed = numSeconds;
 	Str_CopyLimitNull( tf->funcname, funcname, sizeof(tf->funcname) );
+	_IndexAdd( tf );
 	if ( m_isBeingProcessed )
 		m_tfQueuedToBeAdded.emplace_back( tf );
 	else
@@ -302,6 +336,7 @@ int CTimedFunctionHandler::Load( const char *pszName, bool fQuoted, const char *
         tf->elapsed = elapsed;
         tf->uid.SetPrivateUID(uid);
         m_timedFunctions[tick].emplace_back(tf);
+        _IndexAdd(tf);
         tf = nullptr;
 	}
 	else if ( !strnicmp( pszName, "TimerFCall", 11 ) )
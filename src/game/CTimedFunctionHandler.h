@@ -9,6 +9,7 @@
 #include "../common/CScriptContexts.h"
 #include "../common/CScriptObj.h"
 #include "../common/CUID.h"
+#include "../common/parallel_hashmap/phmap.h"
 #include "CServerTime.h"
 #include <vector>
 
@@ -33,6 +34,12 @@ private:
     std::vector<TimedFunction *> m_tfQueuedToBeAdded;
     bool m_isBeingProcessed;
 
+    // Secondary index: UID -> its pending TimedFunctions, so that Erase/Stop/IsTimer don't have to scan every tick bucket.
+    //  Entries removed through the index are only marked as dead (invalid UID) and are pulled out of their tick bucket
+    //  (and recycled) the next time OnTick processes that bucket.
+    using TimedFunctionsIndex = phmap::flat_hash_map<dword, std::vector<TimedFunction *>>;
+    TimedFunctionsIndex m_tfIndex;
+
 public:
     static const char *m_sClassName;
     CTimedFunctionHandler();
@@ -41,6 +48,9 @@ private:
     CTimedFunctionHandler(const CTimedFunctionHandler& copy);
     CTimedFunctionHandler& operator=(const CTimedFunctionHandler& other);
 
+    void _IndexAdd(TimedFunction* tf);
+    void _IndexRemove(TimedFunction* tf);
+
 public:
     void OnTick();
     void r_Write(CScript & s);
@@ -3,6 +3,7 @@
 #include "../common/sphereversion.h"
 #include "../network/CClientIterator.h"
 #include "../network/CNetworkManager.h"
+#include "../sphere/ProfileMetrics.h"
 #include "../sphere/ProfileTask.h"
 #include "../common/CLog.h"
 #include "chars/CChar.h"
@@ -15,11 +16,13 @@
 #include "CWorldMap.h"
 #include "CWorldTickingList.h"
 #include "CWorld.h"
+#include "spheresvr.h"
 
 #ifndef _WIN32
     #include <sys/statvfs.h>
 #endif
 #include <sys/stat.h>
+#include <thread>
 
 
 lpctstr GetReasonForGarbageCode(int iCode = -1)
@@ -217,9 +220,7 @@ CWorldThread::CWorldThread()
 	_ppUIDObjArray = nullptr;
 	_uiUIDObjArraySize = 0;
 	_dwUIDIndexLast = 0;
-
-	_pdwFreeUIDs = nullptr;
-	_dwFreeUIDOffset = 0;
+	_pGCCheckedObj = nullptr;
 }
 
 CWorldThread::~CWorldThread()
@@ -233,8 +234,10 @@ void CWorldThread::InitUIDs()
 	_ppUIDObjArray = (CObjBase**)calloc(_uiUIDObjArraySize, sizeof(CObjBase*));
 	_dwUIDIndexLast = 1;
 
-	_dwFreeUIDOffset = FREE_UIDS_SIZE;
-	_pdwFreeUIDs = (dword*)calloc(_dwFreeUIDOffset, sizeof(dword));
+	_FreeUIDs.Clear();
+	_FreeUIDs.Grow(_uiUIDObjArraySize);
+	for ( size_t i = 1; i < _uiUIDObjArraySize; ++i )	// UID 0 is never used.
+		_FreeUIDs.Set(i);
 }
 
 void CWorldThread::CloseAllUIDs()
@@ -251,13 +254,7 @@ void CWorldThread::CloseAllUIDs()
 		_uiUIDObjArraySize = 0;
 	}
 
-	if ( _pdwFreeUIDs != nullptr )
-	{
-		free(_pdwFreeUIDs);
-		_pdwFreeUIDs = nullptr;
-	}
-
-	_dwFreeUIDOffset = 0;
+	_FreeUIDs.Clear();
 	_dwUIDIndexLast = 0;
 }
 
@@ -284,75 +281,55 @@ CObjBase *CWorldThread::FindUID(dword dwIndex) const
 void CWorldThread::FreeUID(dword dwIndex)
 {
 	// Can't free up the UID til after the save !
-	_ppUIDObjArray[dwIndex] = IsSaving() ? UID_PLACE_HOLDER : nullptr;
+	if ( IsSaving() )
+	{
+		_ppUIDObjArray[dwIndex] = UID_PLACE_HOLDER;
+		return;
+	}
+	_ppUIDObjArray[dwIndex] = nullptr;
+	_FreeUIDs.Set(dwIndex);
 }
 
-dword CWorldThread::AllocUID( dword dwIndex, CObjBase * pObj )
+void CWorldThread::GrowUIDs( dword dwIndex )
 {
-	ADDTOCALLSTACK("CWorldThread::AllocUID");
-	dword dwCountTotal = GetUIDCount();
+	ADDTOCALLSTACK("CWorldThread::GrowUIDs");
+	// We have run out of free UID's !!! Grow the array
+	const size_t uiOldArraySize = _uiUIDObjArraySize;
+	_uiUIDObjArraySize = ((dwIndex + 0x1000) & ~0xFFF);
 
-	if ( !dwIndex )					// auto-select tbe suitable hole
+	CObjBase** pNewBlock = (CObjBase**)realloc(_ppUIDObjArray, _uiUIDObjArraySize * sizeof(CObjBase*));
+	if (pNewBlock == nullptr)
 	{
-		if ( !dwCountTotal )		// if the uids array is empty - increase it.
-		{
-			dwIndex = 1;
-			goto setcount;
-		}
-
-		if ( _dwFreeUIDOffset < FREE_UIDS_SIZE && _pdwFreeUIDs != nullptr )
-		{
-			//	We do have a free uid's array. Use it if possible to determine the first free element
-			for ( ; _dwFreeUIDOffset < FREE_UIDS_SIZE && _pdwFreeUIDs[_dwFreeUIDOffset] != 0; _dwFreeUIDOffset++ )
-			{
-				//	yes, that's a free slot
-				if ( !_ppUIDObjArray[_pdwFreeUIDs[_dwFreeUIDOffset]] )
-				{
-					dwIndex = _pdwFreeUIDs[_dwFreeUIDOffset++];
-					goto successalloc;
-				}
-			}
-		}
-		_dwFreeUIDOffset = FREE_UIDS_SIZE;	// mark array invalid, since it does not contain any empty slots
-										// use default allocation for a while, till the next garbage collection
-		dword dwCount = dwCountTotal - 1;
-		dwIndex = _dwUIDIndexLast;
-		while ( _ppUIDObjArray[dwIndex] != nullptr )
-		{
-			if ( ! -- dwIndex )
-			{
-				dwIndex = dwCountTotal - 1;
-			}
-			if ( ! -- dwCount )
-			{
-				dwIndex = dwCountTotal;
-				goto setcount;
-			}
-		}
+		throw CSError(LOGL_FATAL, 0, "Not enough memory to store new UIDs!.\n");
 	}
-	else if ( dwIndex >= dwCountTotal )
-	{
-setcount:
-		// We have run out of free UID's !!! Grow the array
-		const size_t uiOldArraySize = _uiUIDObjArraySize;
-		_uiUIDObjArraySize = ((dwIndex + 0x1000) & ~0xFFF);
 
-		CObjBase** pNewBlock = (CObjBase**)realloc(_ppUIDObjArray, _uiUIDObjArraySize * sizeof(CObjBase*));
-		if (pNewBlock == nullptr)
-		{
-			throw CSError(LOGL_FATAL, 0, "Not enough memory to store new UIDs!.\n");
-		}
+	// zero initialize the expanded part of the memory, leave untouched the original one
+	memset(pNewBlock + uiOldArraySize, 0, (_uiUIDObjArraySize - uiOldArraySize) * sizeof(CObjBase*));
 
-		// zero initialize the expanded part of the memory, leave untouched the original one
-		memset(pNewBlock + uiOldArraySize, 0, (_uiUIDObjArraySize - uiOldArraySize) * sizeof(CObjBase*));
+	_ppUIDObjArray = (CObjBase**)pNewBlock;
 
-		_ppUIDObjArray = (CObjBase**)pNewBlock;
+	_FreeUIDs.Grow(_uiUIDObjArraySize);
+	for ( size_t i = maximum(uiOldArraySize, (size_t)1); i < _uiUIDObjArraySize; ++i )
+		_FreeUIDs.Set(i);
+}
+
+dword CWorldThread::AllocUID( dword dwIndex, CObjBase * pObj )
+{
+	ADDTOCALLSTACK("CWorldThread::AllocUID");
+	if ( !dwIndex )					// auto-select tbe suitable hole
+	{
+		// Take the first free slot after the last one allocated, so a freed UID isn't reused right away.
+		size_t uiFree = _FreeUIDs.FindNext(_dwUIDIndexLast);
+		if ( uiFree == CSIndexBitmap::npos )
+			uiFree = _FreeUIDs.FindNext(1);
+		dwIndex = (uiFree == CSIndexBitmap::npos) ? maximum(GetUIDCount(), (dword)1) : (dword)uiFree;
 	}
+	if ( dwIndex >= GetUIDCount() )
+		GrowUIDs(dwIndex);
 
-successalloc:
 	_dwUIDIndexLast = dwIndex; // start from here next time so we have even distribution of allocation.
 	CObjBase *pObjPrv = _ppUIDObjArray[dwIndex];
-	if ( pObjPrv )
+	if ( pObjPrv && (pObjPrv != UID_PLACE_HOLDER) )
 	{
 		//NOTE: We cannot use Delete() in here because the UID will
 		//	still be assigned til the async cleanup time. Delete() will not work here!
@@ -360,6 +337,7 @@ successalloc:
 		delete pObjPrv;
 	}
 	_ppUIDObjArray[dwIndex] = pObj;
+	_FreeUIDs.Reset(dwIndex);
 	return dwIndex;
 }
 
@@ -369,7 +347,10 @@ void CWorldThread::SaveThreadClose()
 	for ( size_t i = 1; i < GetUIDCount(); ++i )
 	{
 		if ( _ppUIDObjArray[i] == UID_PLACE_HOLDER )
+		{
 			_ppUIDObjArray[i] = nullptr;
+			_FreeUIDs.Set(i);
+		}
 	}
 
 	m_FileData.Close();
@@ -512,6 +493,101 @@ void CWorldThread::GarbageCollection_New()
 	EXC_CATCH;
 }
 
+// Slots checked by each thread of the check pass: under it, there's not enough work to be worth a thread.
+#define GC_CHECK_MIN_UIDS_PER_THREAD	0x8000
+#define GC_CHECK_MAX_THREADS			8
+
+// Context for the call stack and the temp buffers of a thread of the check pass.
+// It's never started: the thread is a std::thread, which just makes this the current sphere thread.
+class CGarbageCheckThread : public AbstractSphereThread
+{
+public:
+	CGarbageCheckThread() : AbstractSphereThread("T_GarbageCheck", IThread::Normal)
+	{
+	}
+protected:
+	virtual void tick() override
+	{
+	}
+};
+
+static CGarbageCheckThread * GarbageCheckThreadContext( uint uiThread )
+{
+	// The contexts are created once, by the main thread (the threads count of AbstractThread isn't thread safe),
+	// and never destroyed: destroying an AbstractThread updates that count too (and on Windows may uninitialize COM).
+	static CGarbageCheckThread * s_pContexts[GC_CHECK_MAX_THREADS] = {};
+	ASSERT(uiThread < GC_CHECK_MAX_THREADS);
+	if ( s_pContexts[uiThread] == nullptr )
+		s_pContexts[uiThread] = new CGarbageCheckThread();
+	return s_pContexts[uiThread];
+}
+
+uint CWorldThread::GarbageCollection_CheckUIDs( std::vector<dword> & vWeirdUIDs ) const
+{
+	ADDTOCALLSTACK("CWorldThread::GarbageCollection_CheckUIDs");
+	// Read-only pass of the garbage collection: look for the weird objects, without changing anything.
+	// Split over a few threads, each one checking a range of UIDs. Nothing else runs on the world meanwhile.
+	// RETURN: the number of threads used, 0 if the check wasn't done.
+
+	const dword dwCount = GetUIDCount();
+	uint uiThreads = std::thread::hardware_concurrency();
+	uiThreads = minimum(uiThreads, (uint)GC_CHECK_MAX_THREADS);
+	uiThreads = minimum(uiThreads, (uint)(dwCount / GC_CHECK_MIN_UIDS_PER_THREAD));
+	if ( uiThreads <= 1 )
+		return 0;	// On a single thread it would only be one more walk over the objects: the fix pass checks them all.
+
+	std::vector<std::vector<dword>> vThreadWeirdUIDs(uiThreads);
+	auto CheckRange = [this, &vThreadWeirdUIDs](uint uiThread, dword dwStart, dword dwEnd)
+	{
+		std::vector<dword> & vWeird = vThreadWeirdUIDs[uiThread];
+		for ( dword i = dwStart; i < dwEnd; ++i )
+		{
+			const CObjBase * pObj = _ppUIDObjArray[i];
+			if ( !pObj || pObj == UID_PLACE_HOLDER )
+				continue;
+
+			int iResultCode;
+			try
+			{
+				if (( pObj->GetUID() & UID_O_INDEX_MASK ) != i )
+					iResultCode = 0x7101;
+				else
+					iResultCode = pObj->IsWeird();
+			}
+			catch (...)
+			{
+				iResultCode = 0xFFFF;	// Reported again by FixObj, from the main thread.
+			}
+			if ( iResultCode )
+				vWeird.push_back(i);
+		}
+	};
+
+	std::vector<std::thread> vThreads;
+	vThreads.reserve(uiThreads);
+	const dword dwRange = (dwCount + uiThreads - 1) / uiThreads;
+	for ( uint t = 0; t < uiThreads; ++t )
+	{
+		const dword dwStart = maximum((dword)1, t * dwRange);
+		const dword dwEnd = minimum(dwCount, (t + 1) * dwRange);
+		CGarbageCheckThread * pContext = GarbageCheckThreadContext(t);
+		vThreads.emplace_back([&CheckRange, pContext, t, dwStart, dwEnd]()
+		{
+			ThreadHolder::m_currentThread = pContext;
+			CheckRange(t, dwStart, dwEnd);
+			ThreadHolder::m_currentThread = nullptr;
+		});
+	}
+	for ( std::thread & thread : vThreads )
+		thread.join();
+
+	// The ranges are in order, so are the UIDs.
+	vWeirdUIDs.clear();
+	for ( const std::vector<dword> & vWeird : vThreadWeirdUIDs )
+		vWeirdUIDs.insert(vWeirdUIDs.end(), vWeird.begin(), vWeird.end());
+	return uiThreads;
+}
+
 void CWorldThread::GarbageCollection_UIDs()
 {
 	ADDTOCALLSTACK("CWorldThread::GarbageCollection_UIDs");
@@ -520,7 +596,19 @@ void CWorldThread::GarbageCollection_UIDs()
 
 	GarbageCollection_New();
 
+	// Check pass: find the weird objects, in parallel.
+	llong llTimeStart = GetPreciseSysTimeMilli();
+	std::vector<dword> vWeirdUIDs;
+	const uint uiThreads = GarbageCollection_CheckUIDs(vWeirdUIDs);
+	const llong llTimeCheck = GetPreciseSysTimeMilli() - llTimeStart;
+
+	// Fix pass: FixWeirdness still has to run on every object (it repairs flags and links), but the objects found sane
+	// by the check pass (if done) don't need to be checked again at its end. This holds as long as nothing has been deleted:
+	// a deleted object may be the container of the following ones.
+	llTimeStart = GetPreciseSysTimeMilli();
+	std::vector<dword>::const_iterator itWeird = vWeirdUIDs.begin();
 	dword iCount = 0;
+	dword iDeleted = 0;
 	for (dword i = 1; i < GetUIDCount(); ++i )
 	{
 		try
@@ -529,13 +617,21 @@ void CWorldThread::GarbageCollection_UIDs()
 			if ( !pObj || pObj == UID_PLACE_HOLDER )
 				continue;
 
+			while ( (itWeird != vWeirdUIDs.end()) && (*itWeird < i) )
+				++itWeird;
+			const bool fFoundWeird = (itWeird != vWeirdUIDs.end()) && (*itWeird == i);
+			_pGCCheckedObj = (!uiThreads || fFoundWeird || iDeleted) ? nullptr : pObj;
+
 			// Look for anomalies and fix them (that might mean delete it.)
 			int iResultCode = FixObj(pObj, i);
+			_pGCCheckedObj = nullptr;
 			if ( iResultCode )
 			{
 				// Do an immediate delete here instead of Delete()
 				delete pObj;
 				FreeUID(i);	// Get rid of junk uid if all fails..
+				g_ServerMetrics.m_GarbageDeleted.Add(1);
+				++iDeleted;
 				continue;
 			}
 
@@ -545,42 +641,35 @@ void CWorldThread::GarbageCollection_UIDs()
 		}
 		catch ( const CSError& e )
 		{
+			_pGCCheckedObj = nullptr;
 			g_Log.CatchEvent(&e, "GarbageCollection_UIDs");
 			CurrentProfileData.Count(PROFILE_STAT_FAULTS, 1);
 		}
 		catch (...)
 		{
+			_pGCCheckedObj = nullptr;
 			g_Log.CatchEvent(nullptr, "GarbageCollection_UIDs");
 			CurrentProfileData.Count(PROFILE_STAT_FAULTS, 1);
 		}
 	}
+	const llong llTimeFix = GetPreciseSysTimeMilli() - llTimeStart;
 
 	GarbageCollection_New();
 
+	if ( uiThreads )
+	{
+		g_Log.Event(LOGL_EVENT|LOGM_NOCONTEXT, "Garbage Collection: check pass %lld ms (%u threads, %" PRIuSIZE_T " weird objects), fix pass %lld ms (%" PRIu32 " deleted).\n",
+			llTimeCheck, uiThreads, vWeirdUIDs.size(), llTimeFix, iDeleted);
+	}
+	else
+	{
+		g_Log.Event(LOGL_EVENT|LOGM_NOCONTEXT, "Garbage Collection: fix pass %lld ms (%" PRIu32 " deleted), no check pass on a single thread.\n",
+			llTimeFix, iDeleted);
+	}
 	if ( iCount != CObjBase::sm_iCount )	// All objects must be accounted for.
 		g_Log.Event(LOGL_ERROR|LOGM_NOCONTEXT, "Garbage Collection: done. Object memory leak %" PRIu32 "!=%" PRIu32 ".\n", iCount, CObjBase::sm_iCount);
 	else
 		g_Log.Event(LOGL_EVENT|LOGM_NOCONTEXT, "Garbage Collection: done. %" PRIu32 " Objects accounted for.\n", iCount);
-
-	if ( _pdwFreeUIDs != nullptr )	// new UID engine - search for empty holes and store it in a huge array
-	{							// the size of the array should be enough even for huge shards
-								// to survive till next garbage collection
-		memset(_pdwFreeUIDs, 0, FREE_UIDS_SIZE * sizeof(dword));
-		_dwFreeUIDOffset = 0;
-
-		for ( dword d = 1; d < GetUIDCount(); ++d )
-		{
-			CObjBase *pObj = _ppUIDObjArray[d];
-
-			if ( !pObj )
-			{
-				if ( _dwFreeUIDOffset >= ( FREE_UIDS_SIZE - 1 ))
-					break;
-
-				_pdwFreeUIDs[_dwFreeUIDOffset++] = d;
-			}
-		}
-	}
 }
 
 //////////////////////////////////////////////////////////////////
@@ -598,6 +687,10 @@ CWorld::CWorld() :
 	m_iLoadVersion = 0;
 	_fSaveNotificationSent = false;
 	_iTimeLastDeadRespawn = 0;
+	_fDeadNPCsIndexed = false;
+	_uiRespawnQueueIndex = 0;
+	_iRestockMap = -1;
+	_iRestockSector = 0;
 	_iTimeStartup = 0;
 	_iTimeLastCallUserFunc = 0;
 }
@@ -641,13 +734,13 @@ void CWorld::GetBackupName( CSString & sArchive, lpctstr pszBaseDir, tchar chTyp
 		SPHERE_SCRIPT );
 }
 
-bool CWorld::OpenScriptBackup( CScript & s, lpctstr pszBaseDir, lpctstr pszBaseName, int iSaveCount ) // static
+bool CWorld::OpenScriptBackup( CScript & s, lpctstr pszBaseDir, lpctstr pszBaseName, int iSaveCount, tchar chBackupType ) // static
 {
 	ADDTOCALLSTACK("CWorld::OpenScriptBackup");
 	ASSERT(pszBaseName);
 
 	CSString sArchive;
-	GetBackupName( sArchive, pszBaseDir, pszBaseName[0], iSaveCount );
+	GetBackupName( sArchive, pszBaseDir, (chBackupType != '\0') ? chBackupType : pszBaseName[0], iSaveCount );
 
 	// remove possible previous archive of same name
 	remove( sArchive );
@@ -787,12 +880,11 @@ bool CWorld::SaveStage() // Save world state in stages.
 		g_Log.Event(LOGM_SAVE, "Multi data saved   (%s).\n", m_FileMultis.GetFilePath());
 		g_Log.Event(LOGM_SAVE, "Context data saved (%s).\n", m_FileData.GetFilePath());
 
-		llong	llTicksEnd;
-		llong	llTicksStart = m_savetimer;
-		TIME_PROFILE_END;
+		const llong iSaveMsecs = GetPreciseSysTimeMilli() - m_savetimer;
+		g_ServerMetrics.m_SaveTime.Add(iSaveMsecs * 1000);
 
 		tchar * time = Str_GetTemp();
-		sprintf(time, "%lld.%04lld", TIME_PROFILE_GET_HI, TIME_PROFILE_GET_LO);
+		sprintf(time, "%lld.%04lld", iSaveMsecs / 1000, (iSaveMsecs * 10) % 10000);
 
 		g_Log.Event(LOGM_SAVE, "World save completed, took %s seconds.\n", time);
 
@@ -912,9 +1004,7 @@ bool CWorld::SaveTry( bool fForceImmediate ) // Save world state
 	if ( g_Cfg.m_fSaveGarbageCollect )
 		GarbageCollection();
 
-	llong llTicksStart;
-	TIME_PROFILE_START;
-	m_savetimer = llTicksStart;
+	m_savetimer = GetPreciseSysTimeMilli();
 
 	// Determine the save name based on the time.
 	// exponentially degrade the saves over time.
@@ -1512,6 +1602,41 @@ void CWorld::RespawnDeadNPCs()
 {
 	ADDTOCALLSTACK("CWorld::RespawnDeadNPCs");
 	// Respawn dead story NPC's
+	if ( g_Cfg._iRespawnPerTick > 0 )
+	{
+		// Queue them, they are respawned a few per tick.
+		if ( !_fDeadNPCsIndexed )
+		{
+			// The first round looks for them in the whole world, then they are added to the list when they die.
+			_fDeadNPCsIndexed = true;
+			for ( int m = 0; m < MAP_SUPPORTED_QTY; ++m )
+			{
+				if ( !g_MapList.IsMapSupported(m) )
+					continue;
+
+				for (int s = 0, qty = _Sectors.GetSectorQty(m); s < qty; ++s)
+				{
+					const CSector* pSector = _Sectors.GetSector(m, s);
+					ASSERT(pSector);
+					for (const CSObjContRec* pObjRec : pSector->m_Chars_Active)
+					{
+						const CChar* pChar = static_cast<const CChar*>(pObjRec);
+						if ( pChar->m_pNPC && pChar->IsStatFlag(STATF_DEAD) )
+							_setDeadNPCs.emplace((dword)pChar->GetUID());
+					}
+				}
+			}
+		}
+
+		_vRespawnQueue.erase(_vRespawnQueue.begin(), _vRespawnQueue.begin() + _uiRespawnQueueIndex);
+		_uiRespawnQueueIndex = 0;
+		_vRespawnQueue.insert(_vRespawnQueue.end(), _setDeadNPCs.begin(), _setDeadNPCs.end());
+		_setDeadNPCs.clear();
+		return;
+	}
+
+	_setDeadNPCs.clear();
+	_fDeadNPCsIndexed = false;
 	g_Serv.SetServerMode(SERVMODE_RestockAll);
 	for ( int m = 0; m < MAP_SUPPORTED_QTY; ++m )
 	{
@@ -1532,12 +1657,20 @@ void CWorld::RespawnDeadNPCs()
 	g_Serv.SetServerMode(SERVMODE_Run);
 }
 
+void CWorld::AddDeadNPC( const CChar * pChar )
+{
+	// An NPC died: it will be respawned by the next round of RespawnDeadNPCs, if it's still dead then.
+	if ( _fDeadNPCsIndexed && pChar->m_pNPC && pChar->m_ptHome.IsValidPoint() )
+		_setDeadNPCs.emplace((dword)pChar->GetUID());
+}
+
 void CWorld::Restock()
 {
 	ADDTOCALLSTACK("CWorld::Restock");
 	// Recalc all the base items as well.
 	g_Log.Event(LOGL_EVENT, "World Restock: started.\n");
-	g_Serv.SetServerMode(SERVMODE_RestockAll);
+	if ( g_Cfg._iRestockSectorsPerTick <= 0 )
+		g_Serv.SetServerMode(SERVMODE_RestockAll);
 
 	for ( size_t i = 0; i < CountOf(g_Cfg.m_ResHash.m_Array); ++i )
 	{
@@ -1553,6 +1686,15 @@ void CWorld::Restock()
 		}
 	}
 
+	if ( g_Cfg._iRestockSectorsPerTick > 0 )
+	{
+		// The sectors are restocked a few per tick, starting over if a restock was already going on.
+		_iRestockMap = 0;
+		_iRestockSector = 0;
+		return;
+	}
+
+	_iRestockMap = -1;
 	for ( int m = 0; m < MAP_SUPPORTED_QTY; ++m )
 	{
 		if ( !g_MapList.IsMapSupported(m) )
@@ -1574,6 +1716,51 @@ void CWorld::Restock()
 	g_Log.Event(LOGL_EVENT, "World Restock: done.\n");
 }
 
+void CWorld::OnTickRespawnRestock()
+{
+	ADDTOCALLSTACK("CWorld::OnTickRespawnRestock");
+	// Go on with the respawn round and the world restock, if any.
+
+	int iBudget = g_Cfg._iRespawnPerTick;
+	while ( (_uiRespawnQueueIndex < _vRespawnQueue.size()) && (iBudget > 0) )
+	{
+		EXC_TRY("Respawn");
+		CChar* pChar = CUID::CharFind(_vRespawnQueue[_uiRespawnQueueIndex++]);
+		if ( pChar && g_MapList.IsMapSupported(pChar->GetTopMap()) && CSector::RespawnDeadNPC(pChar) )
+			--iBudget;
+		EXC_CATCH;
+	}
+	if ( _uiRespawnQueueIndex >= _vRespawnQueue.size() )
+	{
+		_vRespawnQueue.clear();
+		_uiRespawnQueueIndex = 0;
+	}
+
+	iBudget = g_Cfg._iRestockSectorsPerTick;
+	while ( (_iRestockMap >= 0) && (iBudget > 0) )
+	{
+		if ( _iRestockMap >= MAP_SUPPORTED_QTY )
+		{
+			_iRestockMap = -1;
+			g_Log.Event(LOGL_EVENT, "World Restock: done.\n");
+			break;
+		}
+		if ( !g_MapList.IsMapSupported(_iRestockMap) || (_iRestockSector >= _Sectors.GetSectorQty(_iRestockMap)) )
+		{
+			++_iRestockMap;
+			_iRestockSector = 0;
+			continue;
+		}
+
+		EXC_TRY("Restock");
+		CSector* pSector = _Sectors.GetSector(_iRestockMap, _iRestockSector++);
+		ASSERT(pSector);
+		pSector->Restock();
+		--iBudget;
+		EXC_CATCH;
+	}
+}
+
 void CWorld::Close()
 {
 	ADDTOCALLSTACK("CWorld::Close");
@@ -1590,6 +1777,12 @@ void CWorld::Close()
 	m_Parties.ClearContainer();
 	m_GMPages.ClearContainer();
 
+	_setDeadNPCs.clear();
+	_fDeadNPCsIndexed = false;
+	_vRespawnQueue.clear();
+	_uiRespawnQueueIndex = 0;
+	_iRestockMap = -1;
+
     // Disconnect the players, so that we have none of them in a sector
     ClientIterator it;
     for (CClient* pClient = it.next(); pClient != nullptr; pClient = it.next())
@@ -1619,11 +1812,22 @@ void CWorld::GarbageCollection()
 	g_Log.Flush();
 	g_Serv.SetServerMode(SERVMODE_GarbageCollection);
 	g_Log.Event(LOGL_EVENT|LOGM_NOCONTEXT, "Garbage Collection: started.\n");
+	g_ServerMetrics.m_GarbageCollections.Add(1);
 	GarbageCollection_UIDs();
 	g_Serv.SetServerMode(SERVMODE_Run);
 	g_Log.Flush();
 }
 
+int64 CWorld::GetNextTimeoutDelay() const
+{
+	ADDTOCALLSTACK("CWorld::GetNextTimeoutDelay");
+	const int64 iCurTime = _GameClock.GetCurrentTime().GetTimeRaw();
+	int64 iNextTime = _Ticker.GetNextTimeout();
+	iNextTime = minimum(iNextTime, _GameClock.GetNextTickTime().GetTimeRaw());
+	iNextTime = minimum(iNextTime, _iTimeLastWorldSave);
+	return maximum(iNextTime - iCurTime, (int64)0);
+}
+
 void CWorld::OnTick()
 {
 	ADDTOCALLSTACK("CWorld::OnTick");
@@ -1662,8 +1866,11 @@ void CWorld::OnTick()
 		Save(false);
 	}
 
+	// The main loop is late: postpone what can wait, to handle the packets first.
+	const bool fDeferLowPriority = g_Main.IsDeferringLowPriority();
+
 	// Update map cache
-	if (_Cache._iTimeLastMapBlockCacheCheck < iCurTime)
+	if ((_Cache._iTimeLastMapBlockCacheCheck < iCurTime) && !fDeferLowPriority)
 	{
 		EXC_SET_BLOCK("Check map cache");
 		// delete the static CServerMapBlock items that have not been used recently.
@@ -1679,6 +1886,11 @@ void CWorld::OnTick()
 		_iTimeLastDeadRespawn = iCurTime + (20 * 60 * MSECS_PER_SEC);
 		RespawnDeadNPCs();
 	}
+	if ((!_vRespawnQueue.empty() || (_iRestockMap >= 0)) && !fDeferLowPriority)
+	{
+		EXC_SET_BLOCK("Respawn and restock slices");
+		OnTickRespawnRestock();
+	}
 
 	// f_onserver_timer function.
 	if (_iTimeLastCallUserFunc < iCurTime)
@@ -6,6 +6,7 @@
 #ifndef _INC_CWORLD_H
 #define _INC_CWORLD_H
 
+#include "../common/sphere_library/CSIndexBitmap.h"
 #include "../common/sphere_library/CSObjCont.h"
 #include "../common/sphere_library/CSObjList.h"
 #include "../common/CScript.h"
@@ -14,12 +15,14 @@
 #include "CWorldCache.h"
 #include "CWorldClock.h"
 #include "CWorldTicker.h"
+#include <set>
 
 class CItemTypeDef;
 class CSector;
 class CObjBaseTemplate;
 class CObjBase;
 class CItemStone;
+class CChar;
 
 
 enum IMPFLAGS_TYPE	// IMPORT and EXPORT flags.
@@ -33,8 +36,6 @@ enum IMPFLAGS_TYPE	// IMPORT and EXPORT flags.
 	IMPFLAGS_ACCOUNT = 0x20		// 0x20 = recover just this account/char	(and all it is carrying)
 };
 
-#define FREE_UIDS_SIZE	500000	//	the list of free empty slots in the uids list should contain these elements
-
 
 class CWorldThread
 {
@@ -45,9 +46,11 @@ protected:
 	CObjBase**	_ppUIDObjArray;		// Array containing all the UID's in the World. CChar and CItem.
 	size_t		_uiUIDObjArraySize;
 	dword		_dwUIDIndexLast;	// remeber the last index allocated so we have more even usage.
+	CSIndexBitmap _FreeUIDs;		// Empty slots of _ppUIDObjArray (not the ones waiting for the save to end).
+	const CObjBase * _pGCCheckedObj;	// Object being fixed by GarbageCollection_UIDs, already found sane by the parallel check.
 
-	dword*		_pdwFreeUIDs;		// list of free uids available
-	dword		_dwFreeUIDOffset;		// offset of the first free element
+	void GrowUIDs( dword dwIndex );
+	uint GarbageCollection_CheckUIDs( std::vector<dword> & vWeirdUIDs ) const;
 
 public:
 	static const char *m_sClassName;
@@ -81,6 +84,11 @@ public:
 
 	int FixObjTry( CObjBase * pObj, dword dwUID = 0 );
 	int FixObj( CObjBase * pObj, dword dwUID = 0 );
+	// The object was found sane by the check pass of the garbage collection, its FixWeirdness doesn't need to check it again.
+	inline bool IsGarbageChecked( const CObjBase * pObj ) const noexcept
+	{
+		return (pObj == _pGCCheckedObj);
+	}
 
 	void SaveThreadClose();
 	void GarbageCollection_UIDs();
@@ -120,6 +128,8 @@ private:
 	// Map cache
 	friend class CServer;
 	friend class CWorldMap;
+	friend class CBenchWorld;
+	friend class CServerBench;
 	CWorldCache _Cache;	
 
 	// Sector data
@@ -132,6 +142,12 @@ private:
 	int64	_iTimeLastWorldSave;				// when to auto do the worldsave ?
 	bool	_fSaveNotificationSent;// has notification been sent?
 	int64	_iTimeLastDeadRespawn;			// when to res dead NPC's ?
+	std::set<dword> _setDeadNPCs;		// UIDs of the NPCs (with a home) died since the last respawn round.
+	bool	_fDeadNPCsIndexed;			// _setDeadNPCs was filled by a whole world sweep (the first round does it).
+	std::vector<dword> _vRespawnQueue;	// NPCs of the current respawn round, respawned a few per tick.
+	size_t	_uiRespawnQueueIndex;
+	int		_iRestockMap;				// Next sector restocked by the current world restock, -1 if there isn't any.
+	int		_iRestockSector;
 	int64	_iTimeLastCallUserFunc;		// when to call next user func
 	ullong	m_ticksWithoutMySQL;	// MySQL should be running constantly if MySQLTicks is true, keep here record of how much ticks since Sphere is not connected.
     
@@ -167,6 +183,8 @@ private:
 	static void GetBackupName( CSString & sArchive, lpctstr pszBaseDir, tchar chType, int savecount );
 	bool SaveForce(); // Save world state
 
+	void OnTickRespawnRestock();
+
 public:
 	CWorld();
 	virtual ~CWorld();
@@ -187,12 +205,15 @@ public:
 	// World stuff
 
 	void OnTick();
+	// Game time (msecs) from the current time to the next timer, world tick or save stage due. The main loop can sleep until then.
+	int64 GetNextTimeoutDelay() const;
 
 	void GarbageCollection();
 	void Restock();
 	void RespawnDeadNPCs();
+	void AddDeadNPC( const CChar * pChar );
 	
-	static bool OpenScriptBackup(CScript& s, lpctstr pszBaseDir, lpctstr pszBaseName, int savecount);
+	static bool OpenScriptBackup(CScript& s, lpctstr pszBaseDir, lpctstr pszBaseName, int savecount, tchar chBackupType = '\0');
     bool CheckAvailableSpaceForSave(bool fStatics);
 	bool Save( bool fForceImmediate ); // Save world state
 	void SaveStatics();
@@ -11,6 +11,7 @@ class CWorldCache
 {
 	friend class CWorld;
 	friend class CWorldMap;
+	friend class CBenchWorld;	// Fills the cache with its own map blocks.
 
 	int64	_iTimeLastMapBlockCacheCheck;
 	
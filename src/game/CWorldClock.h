@@ -43,6 +43,10 @@ public:
 	{
 		return _iCurTick;
 	}
+	inline CServerTime GetNextTickTime() const // in milliseconds
+	{
+		return m_nextTickTime;
+	}
 };
 
 #endif // _INC_CWORLDCLOCK_H
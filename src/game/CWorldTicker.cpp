@@ -1,13 +1,19 @@
 #include "../common/CException.h"
 #include "../sphere/threads.h"
+#include "../sphere/ProfileMetrics.h"
 #include "../sphere/ProfileTask.h"
+#include "../sphere/TickWatchdog.h"
 #include "chars/CChar.h"
+#include "chars/CCharNPC.h"
 #include "items/CItem.h"
 #include "items/CItemShip.h"
 #include "CSector.h"
+#include "CSectorList.h"
+#include "CServerConfig.h"
 #include "CWorldClock.h"
 #include "CWorldGameTime.h"
 #include "CWorldTicker.h"
+#include "spheresvr.h"
 
 
 CWorldTicker::CWorldTicker(CWorldClock *pClock)
@@ -182,6 +188,97 @@ void CWorldTicker::DelCharTicking(CChar* pChar)
     EXC_CATCH;
 }
 
+void CWorldTicker::AddSectorAwake(CSector* pSector)
+{
+    _vecSectorsAwake.emplace_back(pSector);
+}
+
+
+// NPC AI level of detail
+
+void CWorldTicker::_UpdateNPCAILod(CChar* pChar) // static
+{
+    CCharNPC* pNPC = pChar->m_pNPC;
+    ASSERT(pNPC);
+
+    if (!g_Cfg._fNPCAILod)
+    {
+        pNPC->m_AILod = NPCAILOD_FULL;
+        return;
+    }
+
+    // Players don't move that fast: no need to recalculate it more than once per second.
+    const int64 iCurTime = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+    if (iCurTime - pNPC->m_timeAILodCheck < MSECS_PER_SEC)
+        return;
+    pNPC->m_timeAILodCheck = iCurTime;
+
+    // Pets and fighting NPCs always think at full rate.
+    if (pChar->IsStatFlag(STATF_PET|STATF_WAR))
+    {
+        pNPC->m_AILod = NPCAILOD_FULL;
+        return;
+    }
+
+    const CPointMap& ptTop = pChar->GetTopPoint();
+    const CSectorList* pSectors = CSectorList::Get();
+    const int iSectorSize = pSectors->GetSectorSize(ptTop.m_map);
+    const int iMaxX = g_MapList.GetMapSizeX(ptTop.m_map), iMaxY = g_MapList.GetMapSizeY(ptTop.m_map);
+    const int iFrozenDist = g_Cfg._iNPCAILodFrozenDist;
+
+    bool fPlayersNear = false;
+    for (int iOffY = -iFrozenDist; iOffY <= iFrozenDist; ++iOffY)
+    {
+        const int iY = ptTop.m_y + (iOffY * iSectorSize);
+        if ((iY < 0) || (iY >= iMaxY))
+            continue;
+        for (int iOffX = -iFrozenDist; iOffX <= iFrozenDist; ++iOffX)
+        {
+            const int iX = ptTop.m_x + (iOffX * iSectorSize);
+            if ((iX < 0) || (iX >= iMaxX))
+                continue;
+
+            const CSector* pSector = pSectors->GetSector(ptTop.m_map, (short)iX, (short)iY);
+            if (!pSector || (pSector->GetClientsNumber() <= 0))
+                continue;
+            fPlayersNear = true;
+
+            // Only the adjacent sectors can contain a player having me in view: check the actual distance.
+            if ((abs(iOffX) > 1) || (abs(iOffY) > 1))
+                continue;
+            for (CSObjContRec* pObjRec : pSector->m_Chars_Active)
+            {
+                const CChar* pCharClient = static_cast<const CChar*>(pObjRec);
+                if (pCharClient->IsClient() && (pCharClient->GetTopDist(pChar) <= pCharClient->GetVisualRange()))
+                {
+                    pNPC->m_AILod = NPCAILOD_FULL;
+                    return;
+                }
+            }
+        }
+    }
+
+    pNPC->m_AILod = fPlayersNear ? NPCAILOD_REDUCED : NPCAILOD_FROZEN;
+}
+
+
+int64 CWorldTicker::GetNextTimeout() const
+{
+    // Both lists are ticked once the current time is past the key (see Tick).
+    int64 iNextTimeout = INT64_MAX;
+    {
+        std::shared_lock<std::shared_mutex> lock(_mWorldTickList.THREAD_CMUTEX);
+        if (!_mWorldTickList.empty())
+            iNextTimeout = _mWorldTickList.begin()->first + 1;
+    }
+    {
+        std::shared_lock<std::shared_mutex> lock(_mCharTickList.THREAD_CMUTEX);
+        if (!_mCharTickList.empty())
+            iNextTimeout = std::min(iNextTimeout, _mCharTickList.begin()->first + 1);
+    }
+    return iNextTimeout;
+}
+
 
 // Check timeouts and do ticks
 
@@ -198,6 +295,7 @@ void CWorldTicker::Tick()
     if (_iLastTickDone <= _pWorldClock->GetCurrentTick())
     {
         ++_iLastTickDone;   // Update current tick.
+        const bool fDeferLowPriority = g_Main.IsDeferringLowPriority();    // The main loop is late, these can wait for the next tick.
 
         /* process objects that need status updates
         * these objects will normally be in containers which don't have any period OnTick method
@@ -206,6 +304,7 @@ void CWorldTicker::Tick()
         * note: ideally, a better solution to accomplish this should be found if possible
         * TODO: implement a new class inheriting from CTimedObject to get rid of this code.
         */
+        if (!fDeferLowPriority)
         {
             EXC_TRYSUB("StatusUpdates");
             {
@@ -241,6 +340,22 @@ void CWorldTicker::Tick()
             _TimedFunctions.OnTick();
             EXC_CATCHSUB("CTimedFunctionHandler");
         }
+
+        // Sectors waiting to be awaken: don't wake them all in the same tick.
+        if (!_vecSectorsAwake.empty() && !fDeferLowPriority)
+        {
+            EXC_TRYSUB("Tick::SectorsAwake");
+            const ProfileTask sectorsTask(PROFILE_SECTORS);
+            const size_t uiAwake = std::min(_vecSectorsAwake.size(), (size_t)g_Cfg._iSectorAwakePerTick);
+            vecObjs.assign(_vecSectorsAwake.begin(), _vecSectorsAwake.begin() + uiAwake);
+            _vecSectorsAwake.erase(_vecSectorsAwake.begin(), _vecSectorsAwake.begin() + uiAwake);
+            for (void* pObjVoid : vecObjs)
+            {
+                static_cast<CSector*>(pObjVoid)->AwakeFromQueue();
+            }
+            vecObjs.clear();
+            EXC_CATCHSUB("");
+        }
     }
 
 
@@ -306,6 +421,8 @@ void CWorldTicker::Tick()
             EXC_CATCHSUB("");
         }
 
+        g_ServerMetrics.m_TimersFired.Add(vecObjs.size());
+
         lpctstr ptcSubDesc = TSTRING_NULL;
         for (void* pObjVoid : vecObjs)    // Loop through all msecs stored, unless we passed the timestamp.
         {
@@ -316,6 +433,7 @@ void CWorldTicker::Tick()
             CTimedObject* pObj = static_cast<CTimedObject*>(pObjVoid);
             const PROFILE_TYPE profile = pObj->GetProfileType();
             const ProfileTask  profileTask(profile);
+            TickWatchdogUnit   watchdogUnit(TICKUNIT_TIMER, 0, ptcSubDesc);
 
             bool fRemove = true;    // Default to true, so if any error occurs it gets deleted for safety.
             switch (profile)
@@ -327,6 +445,8 @@ void CWorldTicker::Tick()
                     if (pItem->IsItemEquipped())
                     {
                         ptcSubDesc = "ItemEquipped";
+                        watchdogUnit.SetName(ptcSubDesc);
+                        watchdogUnit.SetUID(pItem->GetUID().GetObjUID());
                         CObjBaseTemplate* pObjTop = pItem->GetTopLevelObj();
                         ASSERT(pObjTop);
                         CChar* pChar = dynamic_cast<CChar*>(pObjTop);
@@ -337,6 +457,8 @@ void CWorldTicker::Tick()
                     else
                     {
                         ptcSubDesc = "Item";
+                        watchdogUnit.SetName(ptcSubDesc);
+                        watchdogUnit.SetUID(pItem->GetUID().GetObjUID());
                         fRemove = (pItem->OnTick() == false);
                         break;
                     }
@@ -348,17 +470,35 @@ void CWorldTicker::Tick()
                     ptcSubDesc = "Char";
                     CChar* pChar = dynamic_cast<CChar*>(pObj);
                     ASSERT(pChar);
+                    watchdogUnit.SetName(ptcSubDesc);
+                    watchdogUnit.SetUID(pChar->GetUID().GetObjUID());
+                    if (pChar->m_pNPC)
+                    {
+                        _UpdateNPCAILod(pChar);
+                    }
                     fRemove = !pChar->OnTick();
                     if (pChar->m_pNPC && !pObj->IsTimerSet())
                     {
                         pObj->SetTimeoutS(3);   //3 seconds timeout to keep NPCs 'alive'
                     }
+                    if (!fRemove && pChar->m_pNPC && (pChar->m_pNPC->m_AILod != NPCAILOD_FULL) &&
+                        (pObj->GetTimerAdjusted() < g_Cfg._iNPCAILodReducedDelay))
+                    {
+                        pObj->SetTimeout(g_Cfg._iNPCAILodReducedDelay);    // Out of players view: think less often
+                    }
                 }
                 break;
 
                 case PROFILE_SECTORS:
                 {
                     ptcSubDesc = "Sector";
+                    watchdogUnit.SetName(ptcSubDesc);
+                    if (CTickWatchdog::IsRecording())
+                    {
+                        const CSector* pSector = dynamic_cast<const CSector*>(pObj);
+                        if (pSector)
+                            watchdogUnit.SetDetail(pSector->GetIndex());
+                    }
                     fRemove = false;    // sectors should NEVER be deleted.
                     pObj->OnTick();
                 }
@@ -367,6 +507,7 @@ void CWorldTicker::Tick()
                 case PROFILE_MULTIS:
                 {
                     ptcSubDesc = "Multi";
+                    watchdogUnit.SetName(ptcSubDesc);
                     fRemove = !pObj->OnTick();
                 }
                 break;
@@ -374,6 +515,7 @@ void CWorldTicker::Tick()
                 case PROFILE_SHIPS:
                 {
                     ptcSubDesc = "ItemShip";
+                    watchdogUnit.SetName(ptcSubDesc);
                     fRemove = !pObj->OnTick();
                 }
                 break;
@@ -381,6 +523,7 @@ void CWorldTicker::Tick()
                 default:
                 {
                     ptcSubDesc = "Default";
+                    watchdogUnit.SetName(ptcSubDesc);
                     fRemove = !pObj->OnTick();
                 }
                 break;
@@ -458,6 +601,7 @@ void CWorldTicker::Tick()
         for (void* pObjVoid : vecObjs)    // Loop through all msecs stored, unless we passed the timestamp.
         {
             CChar* pChar = static_cast<CChar*>(pObjVoid);
+            const TickWatchdogUnit watchdogUnit(TICKUNIT_PERIODIC, pChar->GetUID().GetObjUID(), "Char");
             if (pChar->OnTickPeriodic())
             {
                 AddCharTicking(pChar, false);
@@ -13,6 +13,7 @@
 
 class CObjBase;
 class CChar;
+class CSector;
 class CWorldClock;
 
 class CWorldTicker
@@ -40,8 +41,11 @@ private:
         THREAD_CMUTEX_DEF;
     };
 
+    using SectorsAwakeList = std::vector<CSector*>;
+
     WorldTickList _mWorldTickList;
     CharTickList _mCharTickList;
+    SectorsAwakeList _vecSectorsAwake;  // sleeping sectors with a client nearby, awaken a few per tick
 
     friend class CWorldTickingList;
     StatusUpdatesList _ObjStatusUpdates;   // objects that need OnTickStatusUpdate called
@@ -55,17 +59,22 @@ private:
 
 public:
     void Tick();
+    // Game time (msecs) at which the first timed object or char periodic tick is due, INT64_MAX if none.
+    int64 GetNextTimeout() const;
 
     void AddTimedObject(int64 iTimeout, CTimedObject* pTimedObject);
     void DelTimedObject(CTimedObject* pTimedObject);
     void AddCharTicking(CChar* pChar, bool fIgnoreSleep);
     void DelCharTicking(CChar* pChar);
+    void AddSectorAwake(CSector* pSector);
 
 private:
     void _InsertTimedObject(const int64 iTimeout, CTimedObject* pTimedObject);
     void _RemoveTimedObject(const int64 iOldTimeout, CTimedObject* pTimedObject);
     void _InsertCharTicking(const int64 iTickNext, CChar* pChar);
     void _RemoveCharTicking(const int64 iOldTimeout, CChar* pChar);
+
+    static void _UpdateNPCAILod(CChar* pChar);
 };
 
 #endif // _INC_CWORLDTICKER_H
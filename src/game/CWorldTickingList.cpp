@@ -36,6 +36,11 @@ void CWorldTickingList::DelObjStatusUpdate(CObjBase* pObj) // static
     g_World._Ticker._ObjStatusUpdates.erase(pObj);
 }
 
+void CWorldTickingList::AddSectorAwake(CSector* pSector) // static
+{
+    g_World._Ticker.AddSectorAwake(pSector);
+}
+
 
 void CWorldTickingList::ClearTickingLists() // static
 {
@@ -51,4 +56,9 @@ void CWorldTickingList::ClearTickingLists() // static
         std::unique_lock<std::shared_mutex> lock(g_World._Ticker._ObjStatusUpdates.THREAD_CMUTEX);
         g_World._Ticker._ObjStatusUpdates.clear();
     }
+    for (CSector* pSector : g_World._Ticker._vecSectorsAwake)
+    {
+        pSector->DequeueAwake();
+    }
+    g_World._Ticker._vecSectorsAwake.clear();
 }
\ No newline at end of file
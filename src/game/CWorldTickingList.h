@@ -8,6 +8,7 @@
 class CTimedObject;
 class CObjBase;
 class CChar;
+class CSector;
 
 class CWorldTickingList
 {
@@ -23,6 +24,8 @@ public:
     static void AddObjStatusUpdate(CObjBase* pObj);
     static void DelObjStatusUpdate(CObjBase* pObj);
 
+    static void AddSectorAwake(CSector* pSector);
+
 private:
     friend class CWorld;
     static void ClearTickingLists();
@@ -768,6 +768,8 @@ bool CChar::IsStatFlag( uint64 iStatFlag ) const
 void CChar::StatFlag_Set( uint64 iStatFlag)
 {
     THREAD_UNIQUE_LOCK_SET;
+    if ((iStatFlag & STATF_DEAD) && !(m_iStatFlag & STATF_DEAD))
+        g_World.AddDeadNPC(this);
     m_iStatFlag |= iStatFlag;
 }
 
@@ -781,7 +783,11 @@ void CChar::StatFlag_Mod(uint64 iStatFlag, bool fMod )
 {
     THREAD_UNIQUE_LOCK_SET;
 	if ( fMod )
+    {
+        if ((iStatFlag & STATF_DEAD) && !(m_iStatFlag & STATF_DEAD))
+            g_World.AddDeadNPC(this);
         m_iStatFlag |= iStatFlag;
+    }
 	else
         m_iStatFlag &= ~iStatFlag;
 }
@@ -971,7 +977,7 @@ int CChar::FixWeirdness()
 	if ( GetTimerSAdjusted() > 60*60 )
 		SetTimeout(1);	// unreasonably long for a char?
 
-	return IsWeird();
+	return g_World.IsGarbageChecked(this) ? 0 : IsWeird();
 }
 
 // Creating a new char. (Not loading from save file) Make sure things are set to reasonable values.
@@ -2008,6 +2014,7 @@ lpctstr const CChar::sm_szRefKeys[CHR_QTY+1] =
 	"WEAPON",
 	nullptr
 };
+const CKeyTableIndex CChar::sm_RefKeysIndex(CChar::sm_szRefKeys, CountOf(CChar::sm_szRefKeys)-1);
 
 bool CChar::r_GetRef( lpctstr & ptcKey, CScriptObj * & pRef )
 {
@@ -2018,7 +2025,7 @@ bool CChar::r_GetRef( lpctstr & ptcKey, CScriptObj * & pRef )
         return true;
     }
 
-	int i = FindTableHeadSorted( ptcKey, sm_szRefKeys, CountOf(sm_szRefKeys)-1 );
+	int i = sm_RefKeysIndex.FindHead(ptcKey);
 	if ( i >= 0 )
 	{
 		ptcKey += strlen( sm_szRefKeys[i] );
@@ -2106,6 +2113,7 @@ lpctstr const CChar::sm_szLoadKeys[CHC_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CChar::sm_LoadKeysIndex(CChar::sm_szLoadKeys, CountOf(CChar::sm_szLoadKeys)-1);
 
 bool CChar::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc, bool fNoCallParent, bool fNoCallChildren )
 {
@@ -2133,7 +2141,7 @@ bool CChar::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc, bo
     }
 
     EXC_SET_BLOCK("Keyword");
-	const CHC_TYPE iKeyNum = (CHC_TYPE) FindTableHeadSorted( ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 );
+	const CHC_TYPE iKeyNum = (CHC_TYPE) sm_LoadKeysIndex.FindHead(ptcKey);
 	if ( iKeyNum < 0 )
 	{
 do_default:
@@ -3096,7 +3104,7 @@ bool CChar::r_LoadVal( CScript & s )
 
     EXC_SET_BLOCK("Keyword");
 	lpctstr	ptcKey = s.GetKey();
-	CHC_TYPE iKeyNum = (CHC_TYPE) FindTableHeadSorted( ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 );
+	CHC_TYPE iKeyNum = (CHC_TYPE) sm_LoadKeysIndex.FindHead(ptcKey);
 	if ( iKeyNum < 0 )
 	{
 		if ( m_pPlayer )
@@ -3393,8 +3401,13 @@ bool CChar::r_LoadVal( CScript & s )
 				m_iStatFlag = s.GetArgLLVal() & ~STATF_SAVEPARITY;
 				break;
 			}
-			// Don't modify STATF_SAVEPARITY, STATF_PET, STATF_SPAWNED here
-			m_iStatFlag = (m_iStatFlag & (STATF_SAVEPARITY | STATF_PET | STATF_SPAWNED)) | (s.GetArgLLVal() & ~(STATF_SAVEPARITY | STATF_PET | STATF_SPAWNED));
+			{
+				// Don't modify STATF_SAVEPARITY, STATF_PET, STATF_SPAWNED here
+				const uint64 iStatFlag = s.GetArgLLVal();
+				if ((iStatFlag & STATF_DEAD) && !(m_iStatFlag & STATF_DEAD))
+					g_World.AddDeadNPC(this);
+				m_iStatFlag = (m_iStatFlag & (STATF_SAVEPARITY | STATF_PET | STATF_SPAWNED)) | (iStatFlag & ~(STATF_SAVEPARITY | STATF_PET | STATF_SPAWNED));
+			}
 			NotoSave_Update();
 			break;
 		case CHC_FONT:
@@ -3864,6 +3877,7 @@ lpctstr const CChar::sm_szVerbKeys[CHV_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CChar::sm_VerbKeysIndex(CChar::sm_szVerbKeys, CountOf(CChar::sm_szVerbKeys)-1);
 
 bool CChar::r_Verb( CScript &s, CTextConsole * pSrc ) // Execute command from script
 {
@@ -3881,7 +3895,7 @@ bool CChar::r_Verb( CScript &s, CTextConsole * pSrc ) // Execute command from sc
 
 	EXC_TRY("Verb");
 
-	int index = FindTableSorted( s.GetKey(), sm_szVerbKeys, CountOf(sm_szVerbKeys)-1 );
+	int index = sm_VerbKeysIndex.Find(s.GetKey());
 	if ( index < 0 )
     {
 		return ( (m_pNPC && NPC_OnVerb(s, pSrc)) || (m_pPlayer && Player_OnVerb(s, pSrc)) || CObjBase::r_Verb(s, pSrc) );
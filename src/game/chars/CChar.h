@@ -113,8 +113,11 @@ public:
 	CRegion * m_pRoom;		// What room we are in now.
 
 	static lpctstr const sm_szRefKeys[];
+	static const CKeyTableIndex sm_RefKeysIndex;
 	static lpctstr const sm_szLoadKeys[];
+	static const CKeyTableIndex sm_LoadKeysIndex;
 	static lpctstr const sm_szVerbKeys[];
+	static const CKeyTableIndex sm_VerbKeysIndex;
 	static lpctstr const sm_szTrigName[CTRIG_QTY+1];
 	static const LAYER_TYPE sm_VendorLayers[3];
 
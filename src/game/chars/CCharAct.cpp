@@ -4364,15 +4364,24 @@ bool CChar::OnTick()
     EXC_SET_BLOCK("Timer expired");
     OnTickSkill();
 
-    if (m_pNPC)
+    if (m_pNPC && (m_pNPC->m_AILod == NPCAILOD_FROZEN))
     {
-        const ProfileTask aiTask(PROFILE_NPC_AI);
+        // No players nearby, don't waste time thinking.
+        CurrentProfileData.Count(PROFILE_STAT_NPC_AI_FROZEN, 1);
+    }
+    else if (m_pNPC)
+    {
+        const bool fFullAI = (m_pNPC->m_AILod == NPCAILOD_FULL);
+        const ProfileTask aiTask(fFullAI ? PROFILE_NPC_AI : PROFILE_NPC_AI_LOD);
         EXC_SET_BLOCK("NPC action");
         if (!IsStatFlag(STATF_FREEZE) && !Can(CAN_C_STATUE))
         {
-            NPC_OnTickAction();
+            // Out of the players view, don't bother wandering or searching for food.
+            const SKILL_TYPE iAction = Skill_GetActive();
+            if (fFullAI || ((iAction != NPCACT_WANDER) && (iAction != NPCACT_FOOD)))
+                NPC_OnTickAction();
 
-            if (!IsStatFlag(STATF_DEAD))
+            if (fFullAI && !IsStatFlag(STATF_DEAD))
             {
                 const int iFlags = NPC_GetAiFlags();
                 if ((iFlags & NPC_AI_FOOD) && !(iFlags & NPC_AI_INTFOOD))
@@ -162,6 +162,7 @@ lpctstr const CCharBase::sm_szLoadKeys[CBC_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CCharBase::sm_LoadKeysIndex(CCharBase::sm_szLoadKeys, CountOf(CCharBase::sm_szLoadKeys)-1);
 
 bool CCharBase::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc, bool fNoCallParent, bool fNoCallChildren )
 {
@@ -176,7 +177,7 @@ bool CCharBase::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc
     }
 
     EXC_SET_BLOCK("Keyword");
-	switch ( FindTableSorted( ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 ))
+	switch ( sm_LoadKeysIndex.Find(ptcKey))
 	{
 		//return as string or hex number or nullptr if not set
 		case CBC_THROWDAM:
@@ -332,7 +333,7 @@ bool CCharBase::r_LoadVal( CScript & s )
     }
 
     EXC_SET_BLOCK("Keyword");
-	switch ( FindTableSorted( s.GetKey(), sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 ))
+	switch ( sm_LoadKeysIndex.Find(s.GetKey()))
 	{
 		//Set as Strings
 		case CBC_THROWDAM:
@@ -61,6 +61,7 @@ public:
 	CResourceRefArray m_Speech;	// Speech fragment list (other stuff we know)
 
 	static lpctstr const sm_szLoadKeys[];
+	static const CKeyTableIndex sm_LoadKeysIndex;
 
 private:
 	void SetFoodType( lpctstr pszFood );
@@ -16,6 +16,7 @@ lpctstr const CCharNPC::sm_szLoadKeys[CNC_QTY+1] =
 #undef ADD
 	nullptr
 };
+const CKeyTableIndex CCharNPC::sm_LoadKeysIndex(CCharNPC::sm_szLoadKeys, CountOf(CCharNPC::sm_szLoadKeys)-1);
 
 void CChar::ClearNPC()
 {
@@ -56,6 +57,9 @@ CCharNPC::CCharNPC( CChar * pChar, NPCBRAIN_TYPE NPCBrain )
 	memset(m_nextY, 0, sizeof(m_nextY));
 #endif
 	m_timeRestock = 0;
+	m_timeLastLookAround = 0;
+	m_AILod = NPCAILOD_FULL;
+	m_timeAILodCheck = 0;
 }
 
 CCharNPC::~CCharNPC()
@@ -65,7 +69,7 @@ CCharNPC::~CCharNPC()
 bool CCharNPC::r_LoadVal( CChar * pChar, CScript &s )
 {
 	EXC_TRY("LoadVal");
-	switch ( FindTableSorted( s.GetKey(), sm_szLoadKeys, CNC_QTY ))
+	switch ( sm_LoadKeysIndex.Find(s.GetKey()))
 	{
 		//Set as Strings
 		case CNC_THROWDAM:
@@ -150,7 +154,7 @@ bool CCharNPC::r_LoadVal( CChar * pChar, CScript &s )
 bool CCharNPC::r_WriteVal( CChar * pChar, lpctstr ptcKey, CSString & sVal )
 {
 	EXC_TRY("WriteVal");
-	switch ( FindTableSorted( ptcKey, sm_szLoadKeys, CNC_QTY ))
+	switch ( sm_LoadKeysIndex.Find(ptcKey))
 	{
 
 		//return as string or hex number or nullptr if not set
@@ -18,6 +18,13 @@ enum CNC_TYPE
 	CNC_QTY
 };
 
+enum NPCAILOD_TYPE : uchar	// AI level of detail, set by CWorldTicker when NPCAILOD is enabled.
+{
+	NPCAILOD_FULL,		// In view of a player: think at the normal rate.
+	NPCAILOD_REDUCED,	// Player(s) in nearby sectors, but not in view: think less often, don't wander or loot.
+	NPCAILOD_FROZEN		// No players within NPCAILODFrozenDist sectors: don't think at all.
+};
+
 class CCharNPC
 {
 	// This is basically the unique "brains" for any character.
@@ -37,12 +44,16 @@ public:
 	CResourceQty m_Need;	// What items might i need/Desire ? (coded as resource scripts) ex "10 gold,20 logs" etc.
 
 	static lpctstr const sm_szLoadKeys[];
+	static const CKeyTableIndex sm_LoadKeysIndex;
 
 	short	m_nextX[MAX_NPC_PATH_STORAGE_SIZE];	// array of X coords of the next step
 	short	m_nextY[MAX_NPC_PATH_STORAGE_SIZE];	// array of Y coords of the next step
 	CPointMap m_nextPt;							// where the array(^^) wants to go, if changed, recount the path
 
 	int64	m_timeRestock;		//	when last restock happened in sell/buy container
+	int64	m_timeLastLookAround;	//	when i last searched for chars around me (used only with EF_NPCEventPerception)
+	NPCAILOD_TYPE m_AILod;		//	AI level of detail, depending on the distance from the nearest player
+	int64	m_timeAILodCheck;	//	when m_AILod was last updated
 
 	struct Spells {
 		SPELL_TYPE	id;
@@ -1111,33 +1111,54 @@ bool CChar::NPC_LookAround( bool fForceCheckItems )
 	if ( pSector->GetCharComplexity() > (g_Cfg.m_iMaxCharComplexity / 2) )
 		iRange /= 4;
 
-	// Any interesting chars here ?
-	int iDist = 0;
-	CChar *pChar = nullptr;
-	CWorldSearch AreaChars(ptTop, iRange);
-	for (;;)
+	// With the event-driven perception, search for chars only if something has moved around me since the last search.
+	bool fLookAtChars = true;
+	if ( IsSetEF(EF_NPCEventPerception) )
 	{
-		pChar = AreaChars.GetChar();
-		if ( !pChar )
-			break;
-		if ( pChar == this )	// just myself.
-			continue;
-
-		iDist = GetTopDist3D(pChar);
-		if ( iDist > iRangeBlur )
+		const int64 iCurTime = CWorldGameTime::GetCurrentTime().GetTimeRaw();
+		if ( (pSector->GetLastCharEventTime(true) < m_pNPC->m_timeLastLookAround) &&
+			(iCurTime - m_pNPC->m_timeLastLookAround < g_Cfg._iNPCPerceptionRefresh) )
 		{
-			if (iRand % iDist )
-				continue;	// can't see them.
+			fLookAtChars = false;
 		}
-		if ( NPC_LookAtChar(pChar, iDist) )		// expensive function call
+		else
 		{
-			SoundChar(CRESND_NOTICE);
-			return true;
+			m_pNPC->m_timeLastLookAround = iCurTime;
+		}
+	}
+
+	// Any interesting chars here ?
+	int iDist = 0;
+	if ( fLookAtChars )
+	{
+		CChar *pChar = nullptr;
+		CWorldSearch AreaChars(ptTop, iRange);
+		for (;;)
+		{
+			pChar = AreaChars.GetChar();
+			if ( !pChar )
+				break;
+			if ( pChar == this )	// just myself.
+				continue;
+
+			iDist = GetTopDist3D(pChar);
+			if ( iDist > iRangeBlur )
+			{
+				if (iRand % iDist )
+					continue;	// can't see them.
+			}
+			if ( NPC_LookAtChar(pChar, iDist) )		// expensive function call
+			{
+				SoundChar(CRESND_NOTICE);
+				return true;
+			}
 		}
 	}
 
-	// Check the ground for good stuff.
-	if ( !fForceCheckItems && (Stat_GetAdjusted(STAT_INT) > 10) && !IsSkillBase(Skill_GetActive()) && !(iRand % 3) )
+	// Check the ground for good stuff (not if no player can see me: i won't loot anything, then).
+	if ( m_pNPC->m_AILod != NPCAILOD_FULL )
+		fForceCheckItems = false;
+	else if ( !fForceCheckItems && (Stat_GetAdjusted(STAT_INT) > 10) && !IsSkillBase(Skill_GetActive()) && !(iRand % 3) )
 		fForceCheckItems = true;
 
 	if ( fForceCheckItems )
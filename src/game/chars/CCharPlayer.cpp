@@ -20,6 +20,7 @@ lpctstr const CCharPlayer::sm_szLoadKeys[CPC_QTY+1] =
 #undef ADD
 	nullptr
 };
+const CKeyTableIndex CCharPlayer::sm_LoadKeysIndex(CCharPlayer::sm_szLoadKeys, CountOf(CCharPlayer::sm_szLoadKeys)-1);
 
 
 CCharPlayer::CCharPlayer(CChar *pChar, CAccount *pAccount) : m_pAccount(pAccount)
@@ -204,7 +205,7 @@ bool CCharPlayer::r_WriteVal( CChar * pChar, lpctstr ptcKey, CSString & sVal )
 		return false;
 	}
 
-	switch ( FindTableHeadSorted( ptcKey, sm_szLoadKeys, CPC_QTY ))
+	switch ( sm_LoadKeysIndex.FindHead(ptcKey))
 	{
 		case CPC_ACCOUNT:
 			sVal = GetAccount()->GetName();
@@ -344,7 +345,7 @@ bool CCharPlayer::r_LoadVal( CChar * pChar, CScript &s )
 		return false;
 	}
 
-	switch ( FindTableHeadSorted( s.GetKey(), sm_szLoadKeys, CPC_QTY ))
+	switch ( sm_LoadKeysIndex.FindHead(s.GetKey()))
 	{
 
 		case CPC_ADDHOUSE:
@@ -596,6 +597,7 @@ lpctstr const CCharPlayer::sm_szVerbKeys[CPV_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CCharPlayer::sm_VerbKeysIndex(CCharPlayer::sm_szVerbKeys, CountOf(CCharPlayer::sm_szVerbKeys)-1);
 
 // Execute command from script
 bool CChar::Player_OnVerb( CScript &s, CTextConsole * pSrc )
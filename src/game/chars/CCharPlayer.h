@@ -59,7 +59,9 @@ public:
 	uint8 _iMaxShips;               // Max ships this player (Client?) can have (Overriding CAccount::_iMaxShips)
 
 	static lpctstr const sm_szVerbKeys[];
+	static const CKeyTableIndex sm_VerbKeysIndex;
 	static lpctstr const sm_szLoadKeys[];
+	static const CKeyTableIndex sm_LoadKeysIndex;
 
 	CResourceRefArray m_Speech;	// Speech fragment list (other stuff we know)
 
@@ -112,13 +112,49 @@ bool CAccounts::Account_LoadAll( bool fChanges, bool fClearChanges )
 	}
 
 	if ( !fChanges )
+	{
+		Account_LoadJournal();
         Account_LoadAll(true);
+	}
 
 	return true;
 }
 
+bool CAccounts::Account_LoadJournal()
+{
+	ADDTOCALLSTACK("CAccounts::Account_LoadJournal");
+	lpctstr pszBaseDir = g_Cfg.m_sAcctBaseDir.IsEmpty() ? g_Cfg.m_sWorldBaseDir : g_Cfg.m_sAcctBaseDir;
+	char *z = Str_GetTemp();
+	strcpy(z, pszBaseDir);
+	strcat(z, SPHERE_FILE "accj" SPHERE_SCRIPT);
 
-bool CAccounts::Account_SaveAll()
+	CScript s;
+	if ( !s.Open(z, OF_READ|OF_TEXT|OF_DEFAULTMODE|OF_NONCRIT) )
+		return false;
+
+	CScriptFileContext ScriptContext(&s);
+	while (s.FindNextSection())
+	{
+		lpctstr pszKey = s.GetKey();
+		if ( s.HasArgs() && !strcmpi(pszKey, "DELETE") )
+		{
+			CAccount * pAccount = Account_Find(s.GetArgStr());
+			if ( pAccount && Account_Remove(pAccount) )
+				delete pAccount;
+			continue;
+		}
+
+		// The journal contains the whole account, so it replaces the one read from the accounts file.
+		CAccount * pAccount = Account_Find(pszKey);
+		if ( pAccount && Account_Remove(pAccount) )
+			delete pAccount;
+		Account_Load(pszKey, s, false);
+	}
+	return true;
+}
+
+
+bool CAccounts::Account_SaveAll( bool fForceFull )
 {
 	ADDTOCALLSTACK("CAccounts::Account_SaveAll");
 	EXC_TRY("SaveAll");
@@ -130,6 +166,45 @@ bool CAccounts::Account_SaveAll()
 	if ( g_Cfg.m_sAcctBaseDir.IsEmpty() ) pszBaseDir = g_Cfg.m_sWorldBaseDir;
 	else pszBaseDir = g_Cfg.m_sAcctBaseDir;
 
+	const llong llTimeStart = GetPreciseSysTimeMilli();
+
+	// Accounts in use can be modified in many ways (login times, tags set by the client code...), so always write them.
+	ClientIterator it;
+	for (CClient * pClient = it.next(); pClient != nullptr; pClient = it.next())
+	{
+		CAccount * pAccount = pClient->GetAccount();
+		if ( pAccount )
+			pAccount->SetChanged();
+	}
+
+	size_t uiChanged = _sAccountsDeleted.size();
+	for ( size_t i = 0; i < m_Accounts.size(); ++i )
+	{
+		CAccount * pAccount = Account_Get(i);
+		if ( pAccount && pAccount->IsChanged() )
+			++uiChanged;
+	}
+
+	// Rewrite the whole accounts file periodically, or if the journal would be too big.
+	const bool fFull = fForceFull || (_iSavesSinceCompact < 0) || (g_Cfg._iAcctCompactSaves <= 0) ||
+		(_iSavesSinceCompact >= g_Cfg._iAcctCompactSaves) || (uiChanged > m_Accounts.size() / 4);
+
+	size_t uiWritten = 0;
+	if ( !(fFull ? Account_SaveFull(pszBaseDir, &uiWritten) : Account_SaveJournal(pszBaseDir, &uiWritten)) )
+		return false;
+
+	Account_LoadAll(true, true);	// clear the change file now.
+
+	g_Log.Event(LOGM_SAVE, "Accounts saved (%s, %" PRIuSIZE_T " of %" PRIuSIZE_T " written), took %lld ms.\n",
+		(fFull ? "full" : "incremental"), uiWritten, m_Accounts.size(), GetPreciseSysTimeMilli() - llTimeStart);
+	return true;
+	EXC_CATCH;
+	return false;
+}
+
+bool CAccounts::Account_SaveFull( lpctstr pszBaseDir, size_t * puiWritten )
+{
+	ADDTOCALLSTACK("CAccounts::Account_SaveFull");
 	CScript s;
 	if ( !CWorld::OpenScriptBackup(s, pszBaseDir, "accu", g_World.m_iSaveCountID) )
 		return false;
@@ -139,17 +214,62 @@ bool CAccounts::Account_SaveAll()
 		"// Any file changes must be made to " SPHERE_FILE "accu" SPHERE_SCRIPT ". This is read in at save time.\n",
 		g_Serv.GetName());
 
+	size_t uiWritten = 0;
 	for ( size_t i = 0; i < m_Accounts.size(); ++i )
 	{
 		CAccount * pAccount = Account_Get(i);
 		if ( pAccount )
+		{
 			pAccount->r_Write(s);
+			pAccount->ClearChanged();
+			++uiWritten;
+		}
 	}
+	s.Close();
 
-	Account_LoadAll(true, true);	// clear the change file now.
+	// Everything is in the accounts file now, the journal isn't needed anymore.
+	CSString sJournal;
+	sJournal.Format("%s" SPHERE_FILE "accj" SPHERE_SCRIPT, pszBaseDir);
+	remove(sJournal);
+
+	_sAccountsDeleted.clear();
+	_iSavesSinceCompact = 0;
+	*puiWritten = uiWritten;
+	return true;
+}
+
+bool CAccounts::Account_SaveJournal( lpctstr pszBaseDir, size_t * puiWritten )
+{
+	ADDTOCALLSTACK("CAccounts::Account_SaveJournal");
+	CScript s;
+	if ( !CWorld::OpenScriptBackup(s, pszBaseDir, "accj", g_World.m_iSaveCountID, 'j') )
+		return false;
+
+	s.Printf("// " SPHERE_TITLE " %s accounts journal\n"
+		"// NOTE: This file cannot be edited while the server is running.\n"
+		"// Accounts changed since the last full save of " SPHERE_FILE "accu" SPHERE_SCRIPT ", they replace the ones in that file when loading.\n",
+		g_Serv.GetName());
+
+	// Deletions first, an account may have been deleted and created again.
+	for ( const std::string & strName : _sAccountsDeleted )
+	{
+		s.WriteSection("DELETE %s", strName.c_str());
+	}
+
+	size_t uiWritten = 0;
+	for ( size_t i = 0; i < m_Accounts.size(); ++i )
+	{
+		CAccount * pAccount = Account_Get(i);
+		if ( pAccount && pAccount->IsChanged() )
+		{
+			pAccount->r_Write(s);
+			++uiWritten;
+		}
+	}
+
+	++_iSavesSinceCompact;
+	*puiWritten = uiWritten;
 	return true;
-	EXC_CATCH;
-	return false;
 }
 
 CAccount * CAccounts::Account_FindChat( lpctstr pszChatName )
@@ -172,9 +292,9 @@ CAccount * CAccounts::Account_Find( lpctstr pszName )
 	if ( !CAccount::NameStrip(szName, pszName) )
 		return nullptr;
 
-	size_t i = m_Accounts.FindKey(szName);
-	if ( i != SCONT_BADINDEX )
-		return Account_Get(i);
+	const auto it = _mAccountsIndex.find(GetIndexKey(szName));
+	if ( it != _mAccountsIndex.end() )
+		return it->second;
 
 	return nullptr;
 }
@@ -216,10 +336,35 @@ bool CAccounts::Account_Delete( CAccount * pAccount )
 		return false;
 	}
 
-	m_Accounts.RemovePtr( pAccount );
+	Account_Remove( pAccount );
+	return true;
+}
+
+bool CAccounts::Account_Remove( CAccount * pAccount )
+{
+	ADDTOCALLSTACK("CAccounts::Account_Remove");
+	ASSERT(pAccount != nullptr);
+
+	const std::string strKey(GetIndexKey(pAccount->GetName()));
+	const size_t i = m_Accounts.FindKey(pAccount->GetName());
+	if ( (i != SCONT_BADINDEX) && (m_Accounts[i] == pAccount) )
+		m_Accounts.erase_at(i);
+	else if ( !m_Accounts.RemovePtr(pAccount) )
+		return false;
+
+	_mAccountsIndex.erase(strKey);
+	_sAccountsDeleted.insert(strKey);
 	return true;
 }
 
+std::string CAccounts::GetIndexKey( lpctstr pszName ) // static
+{
+	std::string strKey(pszName);
+	for ( char & ch : strKey )
+		ch = static_cast<char>(tolower(static_cast<uchar>(ch)));
+	return strKey;
+}
+
 void CAccounts::Account_Add( CAccount * pAccount )
 {
 	ADDTOCALLSTACK("CAccounts::Account_Add");
@@ -239,6 +384,7 @@ void CAccounts::Account_Add( CAccount * pAccount )
 		}
 	}
 	m_Accounts.AddSortKey(pAccount,pAccount->GetName());
+	_mAccountsIndex[GetIndexKey(pAccount->GetName())] = pAccount;
 }
 
 CAccount * CAccounts::Account_Get( size_t index )
@@ -546,6 +692,7 @@ PLEVEL_TYPE CAccount::GetPrivLevelText( lpctstr pszFlags ) // static
 CAccount::CAccount( lpctstr pszName, bool fGuest )
 {
 	g_Serv.StatInc( SERV_STAT_ACCOUNTS );
+	_fChanged = true;
 
 	tchar szName[ MAX_ACCOUNT_NAME_SIZE ];
 	if ( !CAccount::NameStrip( szName, pszName ) )
@@ -609,6 +756,7 @@ void CAccount::SetPrivLevel( PLEVEL_TYPE plevel )
 {
 	ADDTOCALLSTACK("CAccount::SetPrivLevel");
 	m_PrivLevel = plevel;	// PLEVEL_Counsel
+	SetChanged();
 }
 
 CClient * CAccount::FindClient( const CClient * pExclude ) const
@@ -647,6 +795,7 @@ size_t CAccount::DetachChar( CChar * pChar )
 	{
 		m_uidLastChar.InitUID();
 	}
+	SetChanged();
 
 	return( m_Chars.DetachChar( pChar ));
 }
@@ -661,6 +810,7 @@ size_t CAccount::AttachChar( CChar * pChar )
 	size_t i = m_Chars.AttachChar( pChar );
 	if ( i != SCONT_BADINDEX )
 	{
+		SetChanged();
 		size_t iQty = m_Chars.GetCharCount();
 		if ( iQty > MAX_CHARS_PER_ACCT )
 		{
@@ -674,6 +824,7 @@ size_t CAccount::AttachChar( CChar * pChar )
 void CAccount::TogPrivFlags( word wPrivFlags, lpctstr pszArgs )
 {
 	ADDTOCALLSTACK("CAccount::TogPrivFlags");
+	SetChanged();
 
 	if ( pszArgs == nullptr || pszArgs[0] == '\0' )	// toggle.
 	{
@@ -694,6 +845,7 @@ void CAccount::OnLogin( CClient * pClient )
 	ADDTOCALLSTACK("CAccount::OnLogin");
 
 	ASSERT(pClient);
+	SetChanged();
 	pClient->m_timeLogin = CWorldGameTime::GetCurrentTime().GetTimeRaw();	// g_World clock of login time. "LASTCONNECTTIME"
 
 	if ( GetPrivLevel() >= PLEVEL_Counsel )	// ON by default.
@@ -728,6 +880,7 @@ void CAccount::OnLogout(CClient *pClient, bool bWasChar)
 {
 	ADDTOCALLSTACK("CAccount::OnLogout");
 	ASSERT(pClient);
+	SetChanged();
 
 	if ( pClient->GetConnectType() == CONNECT_TELNET ) // unlink the admin client.
 		g_Serv.m_iAdminClients --;
@@ -918,6 +1071,7 @@ bool CAccount::SetPassword( lpctstr pszPassword, bool isMD5Hash )
 
 	if ( Str_Check( pszPassword ) )	// Prevents exploits
 		return false;
+	SetChanged();
 
 	bool useMD5 = g_Cfg.m_fMd5Passwords;
 
@@ -990,6 +1144,7 @@ bool CAccount::SetPassword( lpctstr pszPassword, bool isMD5Hash )
 void CAccount::SetNewPassword( lpctstr pszPassword )
 {
 	ADDTOCALLSTACK("CAccount::SetNewPassword");
+	SetChanged();
 	if ( !pszPassword || !pszPassword[0] )		// no password given, auto-generate password
 	{
 		static tchar const passwdChars[] = "ABCDEFGHJKLMNPQRTUVWXYZ2346789";
@@ -1248,6 +1403,7 @@ bool CAccount::r_LoadVal( CScript & s )
 	{
 		return false;
 	}
+	SetChanged();
 
 	switch ( i )
 	{
@@ -1511,6 +1667,7 @@ bool CAccount::r_Verb( CScript &s, CTextConsole * pSrc )
 	// can't change accounts higher than you in any way
 	if (( pSrc->GetPrivLevel() < GetPrivLevel() ) &&  ( pSrc->GetPrivLevel() < PLEVEL_Admin ))
 		return false;
+	SetChanged();
 
 	if ( !strnicmp(ptcKey, "CLEARTAGS", 9) )
 	{
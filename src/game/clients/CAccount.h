@@ -7,6 +7,7 @@
 
 #include "../../network/CSocket.h"
 #include "../../common/sphere_library/CSString.h"
+#include "../../common/parallel_hashmap/phmap.h"
 #include "../../common/sphereproto.h"
 #include "../../common/CScriptObj.h"
 #include "../chars/CCharRefArray.h"
@@ -59,6 +60,8 @@ private:
 	typedef std::map<dword,BlockLocalTimePair_t> BlockLocalTime_t;
 	BlockLocalTime_t m_BlockIP; // Password tries.
 
+	bool _fChanged; // Modified since the last full save of the accounts file, so it must be written in the accounts journal.
+
 public:
 	static const char *m_sClassName;
 
@@ -131,6 +134,20 @@ public:
 	virtual bool r_GetRef( lpctstr & ptcKey, CScriptObj * & pRef ) override;
 	void r_Write(CScript & s);
 
+	/**
+	* @brief Mark this CAccount to be written in the next incremental accounts save.
+	*/
+	void SetChanged() { _fChanged = true; }
+	/**
+	* @brief Check if this CAccount was modified since the last full accounts save.
+	* @return true if it has to be written in the accounts journal.
+	*/
+	bool IsChanged() const { return _fChanged; }
+	/**
+	* @brief Called after a full accounts save, the CAccount is now up to date in the accounts file.
+	*/
+	void ClearChanged() { _fChanged = false; }
+
 	/************************************************************************
 	* Name and password related section.
 	************************************************************************/
@@ -209,6 +226,7 @@ public:
 		if (what >= RDS_T2A && what < RDS_QTY)
 		{
 			m_ResDisp = what;
+			SetChanged();
 			return true;
 		}
 		return false;
@@ -271,12 +289,12 @@ public:
 	* @brief Set the privileges flags specified.
 	* @param wPrivFlags flags to set.
 	*/
-	void SetPrivFlags( word wPrivFlags ) { m_PrivFlags |= wPrivFlags; }
+	void SetPrivFlags( word wPrivFlags ) { m_PrivFlags |= wPrivFlags; SetChanged(); }
 	/**
 	* @brief Unset the privileges flags specified.
 	* @param wPrivFlags flags to unset.
 	*/
-	void ClearPrivFlags( word wPrivFlags ) { m_PrivFlags &= ~wPrivFlags; }
+	void ClearPrivFlags( word wPrivFlags ) { m_PrivFlags &= ~wPrivFlags; SetChanged(); }
 	/**
 	* @brief Operate with privilege flags.
 	* If pszArgs is empty, only intersection privileges with wPrivFlags are set.
@@ -329,7 +347,7 @@ public:
 	* The max is set only if the current number of chars is lesser than the new value.
 	* @param chars New value for max chars.
 	*/
-	void SetMaxChars(byte chars) { m_MaxChars = minimum(chars, MAX_CHARS_PER_ACCT); }
+	void SetMaxChars(byte chars) { m_MaxChars = minimum(chars, MAX_CHARS_PER_ACCT); SetChanged(); }
 	/**
 	* @brief Check if a CChar is owned by this CAccount.
 	* @param pChar CChar to check.
@@ -374,6 +392,10 @@ protected:
 	static const char *m_sClassName; // TODOC.
 	static lpctstr const sm_szVerbKeys[]; // ACCOUNT action list.
 	CObjNameSortArray m_Accounts; // Sorted CAccount list.
+	phmap::flat_hash_map<std::string, CAccount*> _mAccountsIndex; // CAccount list hashed by lowercase name, for faster lookups.
+	phmap::flat_hash_set<std::string> _sAccountsDeleted; // Names of the CAccounts deleted since the last full save, written in the accounts journal.
+	int _iSavesSinceCompact = -1; // Incremental saves done since the last full save (-1: no full save done yet).
+
 public:
 	/**
 	* CAccount needs CAccounts methods.
@@ -407,12 +429,39 @@ private:
 	* @return Always true.
 	*/
 	bool Cmd_ListUnused( CTextConsole * pSrc, lpctstr pszDays, lpctstr pszVerb, lpctstr pszArgs, dword dwMask = 0);
+	/**
+	* @brief Get the key used in the hashed index for the given (already stripped) account name.
+	*/
+	static std::string GetIndexKey( lpctstr pszName );
+	/**
+	* @brief Remove a CAccount from the lists without calling any trigger. The CAccount is not deleted: the caller owns it and must delete it.
+	* @return true if the CAccount was in the list.
+	*/
+	bool Account_Remove( CAccount * pAccount );
+	/**
+	* @brief Load the accounts journal (accounts written by the incremental saves since the last full save).
+	* @return true if the journal was read.
+	*/
+	bool Account_LoadJournal();
+	/**
+	* @brief Write the whole accounts file and empty the journal.
+	* @return true if successfully saved, false otherwise.
+	*/
+	bool Account_SaveFull( lpctstr pszBaseDir, size_t * puiWritten );
+	/**
+	* @brief Write in the journal only the accounts modified or deleted since the last full save.
+	* @return true if successfully saved, false otherwise.
+	*/
+	bool Account_SaveJournal( lpctstr pszBaseDir, size_t * puiWritten );
 public:
 	/**
 	* @brief Save the accounts file.
+	* Only the accounts changed since the last full save are written to the journal, unless AcctCompactSaves
+	* incremental saves were done or the journal grew too much: in that case the whole accounts file is rewritten.
+	* @param fForceFull true to always rewrite the whole accounts file.
 	* @return true if successfully saved, false otherwise.
 	*/
-	bool Account_SaveAll();
+	bool Account_SaveAll( bool fForceFull = false );
 	/**
 	* @brief Load a single account.
 	* @see Account_LoadAll()
@@ -435,11 +435,12 @@ lpctstr const CClient::sm_szRefKeys[CLIR_QTY+1] =
 	"TARGPRV",
 	nullptr
 };
+const CKeyTableIndex CClient::sm_RefKeysIndex(CClient::sm_szRefKeys, CountOf(CClient::sm_szRefKeys)-1);
 
 bool CClient::r_GetRef( lpctstr & ptcKey, CScriptObj * & pRef )
 {
 	ADDTOCALLSTACK("CClient::r_GetRef");
-	int i = FindTableHeadSorted( ptcKey, sm_szRefKeys, CountOf(sm_szRefKeys)-1 );
+	int i = sm_RefKeysIndex.FindHead(ptcKey);
 	if ( i >= 0 )
 	{
 		ptcKey += strlen( sm_szRefKeys[i] );
@@ -510,6 +511,7 @@ lpctstr const CClient::sm_szLoadKeys[CC_QTY+1] = // static
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CClient::sm_LoadKeysIndex(CClient::sm_szLoadKeys, CountOf(CClient::sm_szLoadKeys)-1);
 
 lpctstr const CClient::sm_szVerbKeys[CV_QTY+1] =	// static
 {
@@ -518,6 +520,7 @@ lpctstr const CClient::sm_szVerbKeys[CV_QTY+1] =	// static
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CClient::sm_VerbKeysIndex(CClient::sm_szVerbKeys, CountOf(CClient::sm_szVerbKeys)-1);
 
 bool CClient::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc, bool fNoCallParent, bool fNoCallChildren )
 {
@@ -555,7 +558,7 @@ bool CClient::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc,
 	else if ( !strnicmp( "REPORTEDCLIVER", ptcKey, 14 ) && ( ptcKey[14] == '\0' || ptcKey[14] == '.' ) )
 		index = CC_REPORTEDCLIVER;
 	else
-		index = FindTableSorted( ptcKey, sm_szLoadKeys, CountOf(sm_szLoadKeys)-1 );
+		index = sm_LoadKeysIndex.Find(ptcKey);
 
 	switch (index)
 	{
@@ -691,7 +694,7 @@ bool CClient::r_LoadVal( CScript & s )
         }
     }
 
-	switch ( FindTableSorted(ptcKey, sm_szLoadKeys, CountOf(sm_szLoadKeys)-1 ))
+	switch ( sm_LoadKeysIndex.Find(ptcKey))
 	{
 		case CC_ALLMOVE:
 			addRemoveAll(true, false);
@@ -815,7 +818,7 @@ bool CClient::r_Verb( CScript & s, CTextConsole * pSrc ) // Execute command from
 		return true;
 	}
 
-	int index = FindTableSorted( s.GetKey(), sm_szVerbKeys, CountOf(sm_szVerbKeys)-1 );
+	int index = sm_VerbKeysIndex.Find(s.GetKey());
 	switch (index)
 	{
 		case CV_ADD:
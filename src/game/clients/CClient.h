@@ -99,8 +99,11 @@ private:
 public:
 	static const char *m_sClassName;
 	static lpctstr const sm_szRefKeys[];
+	static const CKeyTableIndex sm_RefKeysIndex;
 	static lpctstr const sm_szLoadKeys[];
+	static const CKeyTableIndex sm_LoadKeysIndex;
 	static lpctstr const sm_szVerbKeys[];
+	static const CKeyTableIndex sm_VerbKeysIndex;
 
 private:
     CChar* m_pChar;		// What char are we playing ?
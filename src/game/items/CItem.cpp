@@ -86,6 +86,7 @@ lpctstr const CItem::sm_szTrigName[ITRIG_QTY+1] =	// static
 	"@UNEQUIP",		// i have been unequipped (or try to unequip)
 	nullptr
 };
+const CKeyTableIndex CItem::sm_TrigNameIndex(CItem::sm_szTrigName, CountOf(CItem::sm_szTrigName)-1);
 
 /////////////////////////////////////////////////////////////////
 // -CItem
@@ -510,6 +511,7 @@ lpctstr const CItem::sm_szTemplateTable[ITC_QTY+1] =
 	"SELL",
 	nullptr
 };
+const CKeyTableIndex CItem::sm_TemplateTableIndex(CItem::sm_szTemplateTable, CountOf(CItem::sm_szTemplateTable)-1);
 
 CItem * CItem::CreateTemplate( ITEMID_TYPE id, CObjBase * pCont, CChar * pSrc )	// static
 {
@@ -566,7 +568,7 @@ CItem * CItem::ReadTemplate( CResourceLock & s, CObjBase * pCont ) // static
 		if ( s.IsKeyHead( "ON", 2 ))
 			break;
 
-		int index = FindTableSorted( s.GetKey(), sm_szTemplateTable, CountOf( sm_szTemplateTable )-1 );
+		int index = sm_TemplateTableIndex.Find(s.GetKey());
 		switch (index)
 		{
 			case ITC_BUY: // "BUY"
@@ -1155,8 +1157,8 @@ int CItem::FixWeirdness()
         }
     }
 
-    // is m_BaseDef just set bad ?
-    return IsWeird();
+    // is m_BaseDef just set bad ? (unless the garbage collection already checked it)
+    return g_World.IsGarbageChecked(this) ? 0 : IsWeird();
 }
 
 CItem * CItem::UnStackSplit( word amount, CChar * pCharSrc )
@@ -1979,6 +1981,7 @@ bool CItem::SetBase( CItemBase * pItemDef )
 	if (pParentCont)
 	{
 		ASSERT( IsItemEquipped() || IsItemInContainer());
+		pParentCont->InvalidateResourceTotals();
 		pParentCont->OnWeightChange( GetWeight() - iWeightOld );
 	}
 
@@ -2093,12 +2096,20 @@ void CItem::SetAmount(word amount )
 	if (pParentCont)
 	{
 		ASSERT( IsItemEquipped() || IsItemInContainer());
+		pParentCont->InvalidateResourceTotals();
 		pParentCont->OnWeightChange(GetWeight(amount) - GetWeight(oldamount));
 	}
 
 	UpdatePropertyFlag();
 }
 
+void CItem::InvalidateContainerTotals()
+{
+	CContainer * pParentCont = dynamic_cast <CContainer*> (GetParent());
+	if (pParentCont)
+		pParentCont->InvalidateResourceTotals();
+}
+
 word CItem::GetMaxAmount()
 {
 	ADDTOCALLSTACK("CItem::GetMaxAmount");
@@ -2399,6 +2410,7 @@ lpctstr const CItem::sm_szRefKeys[ICR_QTY+1] =
 	"REGION",
 	nullptr
 };
+const CKeyTableIndex CItem::sm_RefKeysIndex(CItem::sm_szRefKeys, CountOf(CItem::sm_szRefKeys)-1);
 
 bool CItem::r_GetRef( lpctstr & ptcKey, CScriptObj * & pRef )
 {
@@ -2409,7 +2421,7 @@ bool CItem::r_GetRef( lpctstr & ptcKey, CScriptObj * & pRef )
         return true;
     }
 
-	int i = FindTableHeadSorted( ptcKey, sm_szRefKeys, CountOf(sm_szRefKeys)-1 );
+	int i = sm_RefKeysIndex.FindHead(ptcKey);
 	if ( i >= 0 )
 	{
 		ptcKey += strlen( sm_szRefKeys[i] );
@@ -2450,6 +2462,7 @@ lpctstr const CItem::sm_szLoadKeys[IC_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CItem::sm_LoadKeysIndex(CItem::sm_szLoadKeys, CountOf(CItem::sm_szLoadKeys)-1);
 
 
 bool CItem::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc, bool fNoCallParent, bool fNoCallChildren )
@@ -2479,7 +2492,7 @@ bool CItem::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc, bo
 	if ( !strnicmp( CItem::sm_szLoadKeys[IC_ADDSPELL], ptcKey, 8 ) )
 		index = IC_ADDSPELL;
 	else
-		index = FindTableSorted( ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 );
+		index = sm_LoadKeysIndex.Find(ptcKey);
 
 	bool fDoDefault = false;
 
@@ -2875,7 +2888,7 @@ bool CItem::r_LoadVal( CScript & s ) // Load an item Script
     }
 
     EXC_SET_BLOCK("Keyword");
-    int index = FindTableSorted(s.GetKey(), sm_szLoadKeys, CountOf(sm_szLoadKeys) - 1);
+    int index = sm_LoadKeysIndex.Find(s.GetKey());
 	switch (index)
 	{
 		//Set as Strings
@@ -3296,6 +3309,7 @@ lpctstr const CItem::sm_szVerbKeys[CIV_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CItem::sm_VerbKeysIndex(CItem::sm_szVerbKeys, CountOf(CItem::sm_szVerbKeys)-1);
 
 bool CItem::r_Verb( CScript & s, CTextConsole * pSrc ) // Execute command from script
 {
@@ -3308,7 +3322,7 @@ bool CItem::r_Verb( CScript & s, CTextConsole * pSrc ) // Execute command from s
         return true;
     }
 
-	int index = FindTableSorted( s.GetKey(), sm_szVerbKeys, CountOf( sm_szVerbKeys )-1 );
+	int index = sm_VerbKeysIndex.Find(s.GetKey());
 	if ( index < 0 )
 	{
 		return CObjBase::r_Verb( s, pSrc );
@@ -3430,7 +3444,7 @@ bool CItem::IsTriggerActive(lpctstr trig) const
     if (_iRunningTriggerId != -1)
     {
         ASSERT(_iRunningTriggerId < ITRIG_QTY);
-        int iAction = FindTableSorted( trig, CItem::sm_szTrigName, CountOf(CItem::sm_szTrigName)-1 );
+        int iAction = sm_TrigNameIndex.Find(trig);
         return (_iRunningTriggerId == iAction);
     }
     ASSERT(!_sRunningTrigger.empty());
@@ -3445,7 +3459,7 @@ void CItem::SetTriggerActive(lpctstr trig)
         _sRunningTrigger.clear();
         return;
     }
-    int iAction = FindTableSorted( trig, CItem::sm_szTrigName, CountOf(CItem::sm_szTrigName)-1 );
+    int iAction = sm_TrigNameIndex.Find(trig);
     if (iAction != -1)
     {
         _iRunningTriggerId = (short)iAction;
@@ -3650,6 +3664,7 @@ bool CItem::SetType(IT_TYPE type, bool fPreCheck)
 
     // Assign type
 	m_type = type;
+	InvalidateContainerTotals();
 
     // Post-assignment checks
     // CComponents sanity check.
@@ -3866,6 +3881,7 @@ void CItem::DupeCopy( const CItem * pItem )
 	SetTimeout( pItem->GetTimerDiff() );
 	SetType(pItem->m_type);
 	m_wAmount = pItem->m_wAmount;
+	InvalidateContainerTotals();
 	m_Attr  = pItem->m_Attr;
 	m_CanMask = pItem->m_CanMask;
 	m_CanUse = pItem->m_CanUse;
@@ -3890,6 +3906,7 @@ void CItem::SetAnim( ITEMID_TYPE id, int64 iTicksTimeout)
 	m_itAnim.m_PrevType = m_type;
 	SetDispID( id );
 	m_type = IT_ANIM_ACTIVE;    // Do not change the components? SetType(IT_ANIM_ACTIVE);
+	InvalidateContainerTotals();
 	SetTimeout(iTicksTimeout);
 	//RemoveFromView();
 	Update();
@@ -4098,6 +4115,7 @@ void CItem::SetCorpseType( CREID_TYPE id )
 	// future: strongly typed enums will remove the need for this cast
     ASSERT(id <= UINT16_MAX);
 	m_wAmount = (word)id;	// m_corpse_DispID
+	InvalidateContainerTotals();
 }
 
 SPELL_TYPE CItem::GetScrollSpell() const
@@ -5924,6 +5942,7 @@ bool CItem::OnTick()
 				RemoveFromView();
 				SetDispID( m_itAnim.m_PrevID );
 				m_type = m_itAnim.m_PrevType;   // don't change the components SetType(m_itAnim.m_PrevType);
+				InvalidateContainerTotals();
 				SetTimeout( -1 );
 				Update();
 			}
@@ -40,10 +40,15 @@ class CItem : public CObjBase
 public:
 	static const char *m_sClassName;
 	static lpctstr const sm_szLoadKeys[];
+	static const CKeyTableIndex sm_LoadKeysIndex;
 	static lpctstr const sm_szVerbKeys[];
+	static const CKeyTableIndex sm_VerbKeysIndex;
 	static lpctstr const sm_szRefKeys[];
+	static const CKeyTableIndex sm_RefKeysIndex;
 	static lpctstr const sm_szTrigName[ITRIG_QTY+1];
+	static const CKeyTableIndex sm_TrigNameIndex;
 	static lpctstr const sm_szTemplateTable[ITC_QTY+1];
+	static const CKeyTableIndex sm_TemplateTableIndex;
 
 private:
 	ITEMID_TYPE m_dwDispIndex;		// The current display type. ITEMID_TYPE
@@ -639,6 +644,7 @@ public:
 	word ConsumeAmount( word iQty = 1 );
 
 	virtual void SetAmount( word amount );
+	void InvalidateContainerTotals();	// Amount, type or base id changed.
 	word GetMaxAmount();
 	bool SetMaxAmount( word amount );
 	void SetAmountUpdate( word amount );
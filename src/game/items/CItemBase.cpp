@@ -1049,6 +1049,7 @@ lpctstr const CItemBase::sm_szLoadKeys[IBC_QTY+1] =
 	#undef ADD
 	nullptr
 };
+const CKeyTableIndex CItemBase::sm_LoadKeysIndex(CItemBase::sm_szLoadKeys, CountOf(CItemBase::sm_szLoadKeys)-1);
 
 bool CItemBase::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc, bool fNoCallParent, bool fNoCallChildren )
 {
@@ -1063,7 +1064,7 @@ bool CItemBase::r_WriteVal( lpctstr ptcKey, CSString & sVal, CTextConsole * pSrc
     }
 
     EXC_SET_BLOCK("Keyword");
-	switch ( FindTableHeadSorted( ptcKey, sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 ))
+	switch ( sm_LoadKeysIndex.FindHead(ptcKey))
 	{
 		//return as string or hex number or nullptr if not set
 		case IBC_ALTERITEM:
@@ -1389,7 +1390,7 @@ bool CItemBase::r_LoadVal( CScript &s )
 
     EXC_SET_BLOCK("Keyword");
 	lpctstr	ptcKey = s.GetKey();
-	switch ( FindTableSorted( s.GetKey(), sm_szLoadKeys, CountOf( sm_szLoadKeys )-1 ) )
+	switch ( sm_LoadKeysIndex.Find(s.GetKey()) )
 	{
 		//Set as Strings
 		case IBC_ALTERITEM:
@@ -1968,12 +1969,13 @@ lpctstr const CItemBaseMulti::sm_szLoadKeys[] =
 	"TSPEECH",
 	nullptr
 };
+const CKeyTableIndex CItemBaseMulti::sm_LoadKeysIndex(CItemBaseMulti::sm_szLoadKeys, CountOf(CItemBaseMulti::sm_szLoadKeys)-1);
 
 bool CItemBaseMulti::r_LoadVal(CScript &s)
 {
     ADDTOCALLSTACK("CItemBaseMulti::r_LoadVal");
     EXC_TRY("LoadVal");
-    switch (FindTableSorted(s.GetKey(), sm_szLoadKeys, CountOf(sm_szLoadKeys) - 1))
+    switch (sm_LoadKeysIndex.Find(s.GetKey()))
     {
         case MLC_BASESTORAGE:
             _iBaseStorage = s.GetArgU16Val();
@@ -2028,7 +2030,7 @@ bool CItemBaseMulti::r_WriteVal(lpctstr ptcKey, CSString & sVal, CTextConsole *
     UNREFERENCED_PARAMETER(fNoCallChildren);
     ADDTOCALLSTACK("CItemBaseMulti::r_WriteVal");
     EXC_TRY("WriteVal");
-    switch (FindTableHeadSorted(ptcKey, sm_szLoadKeys, CountOf(sm_szLoadKeys) - 1))
+    switch (sm_LoadKeysIndex.FindHead(ptcKey))
     {
         case MLC_BASESTORAGE:
             sVal.FormatU16Val(_iBaseStorage);
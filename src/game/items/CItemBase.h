@@ -214,6 +214,7 @@ public:
 	};
 
 	static lpctstr const sm_szLoadKeys[];
+	static const CKeyTableIndex sm_LoadKeysIndex;
 
 private:
 	static CItemBase * MakeDupeReplacement( CItemBase * pBase, ITEMID_TYPE iddupe );
@@ -395,6 +396,7 @@ class CItemBaseMulti : public CItemBase
 	// define the list of objects it is made of.
 	// NOTE: It does not have to be a true multi item ITEMID_MULTI
 	static lpctstr const sm_szLoadKeys[];
+	static const CKeyTableIndex sm_LoadKeysIndex;
 public:
 	static const char *m_sClassName;
 	struct CMultiComponentItem	// a component item of a multi.
@@ -20,7 +20,10 @@
 #include "../network/CNetworkManager.h"
 #include "../network/PingServer.h"
 #include "../sphere/asyncdb.h"
+#include "../sphere/asynclog.h"
 #include "../sphere/ntwindow.h"
+#include "../sphere/ProfileMetrics.h"
+#include "../sphere/TickWatchdog.h"
 #include "clients/CAccount.h"
 #include "items/CItemMap.h"
 #include "items/CItemMessage.h"
@@ -159,7 +162,8 @@ extern CDataBaseAsyncHelper g_asyncHdb;
 //	Main server loop
 
 MainThread::MainThread()
-	: AbstractSphereThread("T_Main", IThread::RealTime)
+	: AbstractSphereThread("T_Main", IThread::RealTime),
+	_iTimeDue(0), _uiDeferredLoops(0), _fDeferLowPriority(false)
 {
     m_profile.EnableProfile(PROFILE_NETWORK_RX);
     m_profile.EnableProfile(PROFILE_CLIENTS);
@@ -169,10 +173,15 @@ MainThread::MainThread()
     m_profile.EnableProfile(PROFILE_MAP);
     m_profile.EnableProfile(PROFILE_MULTIS);
     m_profile.EnableProfile(PROFILE_NPC_AI);
+    m_profile.EnableProfile(PROFILE_NPC_AI_LOD);
+    m_profile.EnableProfile(PROFILE_STAT_NPC_AI_FROZEN);
     m_profile.EnableProfile(PROFILE_SCRIPTS);
     m_profile.EnableProfile(PROFILE_SHIPS);
     m_profile.EnableProfile(PROFILE_TIMEDFUNCTIONS);
     m_profile.EnableProfile(PROFILE_TIMERS);
+
+    // The scripts run here: give it the full temp storage.
+    setTempStorageSize(THREAD_TSTRING_STORAGE, THREAD_STRING_STORAGE);
 }
 
 void MainThread::onStart()
@@ -183,7 +192,59 @@ void MainThread::onStart()
 
 void MainThread::tick()
 {
+	const llong iTimeStart = GetPreciseSysTimeMicro();
+	const int iLoopRate = minimum(g_Cfg._iMainLoopRate, 1000);
+	bool fBehind = false;
+	if ( (iLoopRate > 0) && (_iTimeDue > 0) )
+	{
+		// Woken up early by a packet: it's not late.
+		const llong iLateness = maximum(iTimeStart - _iTimeDue, 0);
+		g_ServerMetrics.m_TickLateness.Add(iLateness);
+		fBehind = (iLateness > 1000000 / iLoopRate);
+	}
+
+	if ( fBehind && (_uiDeferredLoops < MAINLOOP_MAX_DEFERRED) )
+	{
+		_fDeferLowPriority = true;
+		++_uiDeferredLoops;
+		g_ServerMetrics.m_LoopsDeferred.Add(1);
+	}
+	else
+	{
+		_fDeferLowPriority = false;
+		_uiDeferredLoops = 0;
+	}
+
 	Sphere_OnTick();
+
+	if ( iLoopRate > 0 )
+		_Sleep(iTimeStart);
+	else
+		_iTimeDue = 0;
+}
+
+void MainThread::_Sleep( llong iTimeStart )
+{
+	// The world clock advanced at the start of the loop: the game time to the next timer counts from iTimeStart.
+	// A timer can only be added by this thread, so the only early wake ups needed are for the packets (and for closing).
+	const llong iPeriod = 1000000 / minimum(g_Cfg._iMainLoopRate, 1000);
+	llong iTimeDue = iTimeStart + iPeriod;
+	if ( !g_Serv.IsLoading() )
+		iTimeDue = minimum(iTimeDue, iTimeStart + (llong)g_World.GetNextTimeoutDelay() * 1000);
+	_iTimeDue = iTimeDue;
+
+	const llong iTimeNow = GetPreciseSysTimeMicro();
+	if ( (iTimeDue <= iTimeNow) || shouldExit() )
+		return;
+
+	CurrentProfileData.Start(PROFILE_IDLE);
+	_eventWake.wait((uint)((iTimeDue - iTimeNow + 999) / 1000));	// Rounded up: the timers aren't due before their msec.
+}
+
+void MainThread::awaken()
+{
+	_eventWake.signal();
+	AbstractSphereThread::awaken();
 }
 
 bool MainThread::shouldExit()
@@ -261,6 +322,10 @@ int Sphere_InitServer( int argc, char *argv[] )
 
 	g_Log.Event(LOGM_INIT, "%s", g_Serv.GetStatusString(0x24));
 	g_Log.Event(LOGM_INIT, "Startup complete. items=%" PRIuSIZE_T ", chars=%" PRIuSIZE_T "\n", g_Serv.StatGet(SERV_STAT_ITEMS), g_Serv.StatGet(SERV_STAT_CHARS));
+#ifdef DEBUG_STRINGS
+	g_Log.Event(LOGM_INIT, "Strings: %u, heap memory=%" PRIuSIZE_T ", heap allocations=%u, reallocations=%u, pooled names=%" PRIuSIZE_T "\n",
+		gAmount, gMemAmount, gAllocs, gReallocs, CSStringPool::Get().GetCount());
+#endif
 
 #ifdef _WIN32
 	g_Log.Event(LOGM_INIT, "Press '?' for console commands.\n");
@@ -288,8 +353,11 @@ void Sphere_ExitServer()
 
 	g_NetworkManager.stop();
 	g_Main.waitForClose();
+	g_StackSampler.waitForClose();
+	g_MetricsExporter.waitForClose();
 	g_PingServer.waitForClose();
 	g_asyncHdb.waitForClose();
+	g_asyncLdb.waitForClose();
 #ifdef _LIBEV
 	if ( g_Cfg.m_fUseAsyncNetwork != 0 )
 		g_NetworkEvent.waitForClose();
@@ -324,6 +392,7 @@ void Sphere_ExitServer()
     if (!g_Serv._fCloseNTWindowOnTerminate)
         g_Log.Event(LOGM_INIT | LOGF_CONSOLE_ONLY, "You can now close this window.\n");
 #endif
+    g_asyncLog.waitForClose();
     g_Log.Close();
 #ifdef _WIN32
     if (iExitFlag != 5)
@@ -336,6 +405,9 @@ int Sphere_OnTick()
 {
 	// Give the world (CMainTask) a single tick. RETURN: 0 = everything is fine.
 	constexpr const char *m_sClassName = "SphereTick";
+	const TemporaryBufferScope tempBufferScope(IsSetEF(EF_TempBufferScopes));
+	const llong iTickStart = GetPreciseSysTimeMicro();
+	g_TickWatchdog.BeginTick();
 	EXC_TRY("Tick");
 #ifdef _WIN32
 	EXC_SET_BLOCK("service");
@@ -361,6 +433,8 @@ int Sphere_OnTick()
 	g_NetworkManager.tick();	// then this thread has to call the network tick
 
 	EXC_CATCH;
+	g_TickWatchdog.EndTick();
+	g_ServerMetrics.m_TickTime.Add(GetPreciseSysTimeMicro() - iTickStart);
 	return g_Serv.GetExitFlag();
 }
 
@@ -704,7 +778,7 @@ void defragSphere(char *path)
 }
 
 
-#ifdef _WIN32
+#if defined(_WIN32) || defined(_SPHERE_BENCH)	// The benchmark program has its own main.
 int Sphere_MainEntryPoint( int argc, char *argv[] )
 #else
 int _cdecl main( int argc, char * argv[] )
@@ -725,10 +799,17 @@ int _cdecl main( int argc, char * argv[] )
 	{
 		WritePidFile();
 
+		// From now on the log messages are written by a dedicated thread
+		if ( g_Cfg._fLogAsync )
+			g_asyncLog.start();
+
 		// Start the ping server, this can only be ran in a separate thread
 		if ( IsSetEF( EF_UsePingServer ) )
 			g_PingServer.start();
 
+		if ( g_Cfg._iMetricsInterval > 0 )
+			g_MetricsExporter.start();
+
 #ifdef _LIBEV
 		if ( g_Cfg.m_fUseAsyncNetwork != 0 )
 			g_NetworkEvent.start();
@@ -739,6 +820,11 @@ int _cdecl main( int argc, char * argv[] )
 		g_NetworkManager.start();
 
 		const bool shouldRunInThread = ( g_Cfg.m_iFreezeRestartTime > 0 );
+#ifdef THREAD_TRACK_CALLSTACK
+		// Sample the call stack of the thread doing the ticks
+		if ( g_Cfg._fTickStackSampling )
+			g_StackSampler.Start(shouldRunInThread ? &g_Main : static_cast<AbstractSphereThread *>(ThreadHolder::current()));
+#endif
 		if (shouldRunInThread)
 		{
 			g_Main.start();				// Starts another thread to do all the work (it does Sphere_OnTick())
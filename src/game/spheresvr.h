@@ -18,8 +18,16 @@ public:
 
 ////////////////////////////////////////////////////////////////////////////////////
 
+#define MAINLOOP_MAX_DEFERRED	10	// Max loops in a row postponing the low priority work, so that it's done even when the server can't catch up.
+
 class MainThread : public AbstractSphereThread
 {
+	// Between two ticks, sleeps until the next world timer is due, a packet is received or 1/MainLoopRate seconds have passed.
+	AutoResetEvent _eventWake;	// Signaled to end the sleep early.
+	llong _iTimeDue;			// Real time (usecs) the current loop was due at, 0 if unknown.
+	uint _uiDeferredLoops;		// Loops in a row postponing the low priority work.
+	bool _fDeferLowPriority;
+
 public:
 	MainThread();
 	virtual ~MainThread() { };
@@ -33,6 +41,17 @@ public:
 	// configuration disables using threads
 	// TODO: in the future, such simulated functionality should lie in AbstractThread inself instead of hacks
 	virtual void tick();
+	virtual void awaken() override;
+
+	// The current loop started late: the work which can wait (status updates, map cache aging, sectors awakening,
+	// respawn and restock slices) is left to the next loops.
+	inline bool IsDeferringLowPriority() const noexcept
+	{
+		return _fDeferLowPriority;
+	}
+
+private:
+	void _Sleep( llong iTimeStart );
 
 protected:
 	virtual void onStart();
@@ -41,6 +60,7 @@ protected:
 
 //////////////////////////////////////////////////////////////
 
+extern MainThread g_Main;
 extern lpctstr g_szServerDescription;
 extern CSStringList g_AutoComplete;
 
@@ -14,6 +14,8 @@
 
 class CUOTiledata
 {
+    friend class CBenchWorld;   // Makes up its own entries, there's no tiledata.mul to load.
+
     std::vector<CUOItemTypeRec_HS> _tiledataItemEntries;
     std::vector<CUOTerrainTypeRec_HS> _tiledataTerrainEntries;
 
@@ -0,0 +1,681 @@
+#include "CLoadBot.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+
+class CLoadPacket
+{
+	// Packet being built, in network byte order.
+	byte _abData[256];
+	uint _uiLen;
+
+public:
+	CLoadPacket() : _uiLen(0) {}
+	explicit CLoadPacket( byte bCmd ) : _uiLen(0)
+	{
+		WriteByte(bCmd);
+	}
+
+	const byte * GetData() const noexcept	{ return _abData; }
+	uint GetLength() const noexcept			{ return _uiLen; }
+
+	void WriteByte( byte bVal ) noexcept
+	{
+		_abData[_uiLen++] = bVal;
+	}
+	void WriteInt16( word wVal ) noexcept
+	{
+		WriteByte((byte)(wVal >> 8));
+		WriteByte((byte)wVal);
+	}
+	void WriteInt32( dword dwVal ) noexcept
+	{
+		WriteInt16((word)(dwVal >> 16));
+		WriteInt16((word)dwVal);
+	}
+	void WriteData( const byte * pData, uint uiLen ) noexcept
+	{
+		memcpy(&_abData[_uiLen], pData, uiLen);
+		_uiLen += uiLen;
+	}
+	void WriteZero( uint uiLen ) noexcept
+	{
+		memset(&_abData[_uiLen], 0, uiLen);
+		_uiLen += uiLen;
+	}
+	// Padded with zeros (and cut) to uiLen.
+	void WriteStringFixed( lpctstr pszVal, uint uiLen ) noexcept
+	{
+		const uint uiCopy = (uint)strnlen(pszVal, uiLen);
+		WriteData(reinterpret_cast<const byte *>(pszVal), uiCopy);
+		WriteZero(uiLen - uiCopy);
+	}
+	// ASCII text as big endian UTF-16, null terminated.
+	void WriteStringUnicode( lpctstr pszVal ) noexcept
+	{
+		for ( ; *pszVal != '\0'; ++pszVal )
+			WriteInt16((word)(byte)*pszVal);
+		WriteInt16(0);
+	}
+	// For the packets of variable length: the length is in the bytes 1 and 2.
+	void WriteLength() noexcept
+	{
+		_abData[1] = (byte)(_uiLen >> 8);
+		_abData[2] = (byte)_uiLen;
+	}
+};
+
+static inline word ReadInt16( const byte * pData ) noexcept
+{
+	return (word)((pData[0] << 8) | pData[1]);
+}
+
+static inline dword ReadInt32( const byte * pData ) noexcept
+{
+	return ((dword)pData[0] << 24) | ((dword)pData[1] << 16) | ((dword)pData[2] << 8) | (dword)pData[3];
+}
+
+
+CLoadBot::CLoadBot( const CLoadConfig & config, uint uiIndex, CLoadStats * pStats, llong iTimeStart ) :
+	_config(config), _pStats(pStats), _uiIndex(uiIndex),
+	_hSocket(INVALID_SOCKET), _iState(LBS_IDLE), _fConnecting(false),
+	_iTimeConnect(iTimeStart), _iTimeLoginStart(0), _iTimeInGame(0),
+	_dwSerial(0), _dwBackpack(0), _dwOther(0),
+	_bWalkSequence(0), _bWalkPending(0), _uiWalkSteps(0), _bPingSequence(0), _bPingPending(0),
+	_dwUsePending(0), _uiSpeechCount(0)
+{
+	snprintf(_szAccount, sizeof(_szAccount), "%s%u", config.sPrefix.c_str(), config.uiIndexFirst + uiIndex);
+	_szError[0] = '\0';
+	memset(_abRelayKey, 0, sizeof(_abRelayKey));
+	memset(_iTimeNext, 0, sizeof(_iTimeNext));
+	memset(_iTimePending, 0, sizeof(_iTimePending));
+}
+
+CLoadBot::~CLoadBot()
+{
+	Close();
+}
+
+short CLoadBot::GetPollEvents() const noexcept
+{
+	if ( _hSocket == INVALID_SOCKET )
+		return 0;
+	if ( _fConnecting )
+		return POLLOUT;
+	return _vOut.empty() ? POLLIN : (POLLIN|POLLOUT);
+}
+
+void CLoadBot::Close()
+{
+	if ( _hSocket != INVALID_SOCKET )
+	{
+		CLOSESOCKET(_hSocket);
+		_hSocket = INVALID_SOCKET;
+	}
+	_fConnecting = false;
+	_vOut.clear();
+	_vIn.clear();
+	_Huffman.Reset();
+}
+
+void CLoadBot::Fail( lpctstr pszReason, llong iTimeNow )
+{
+	// Only the first errors are shown, the same error is likely to happen to all the clients.
+	static std::atomic<uint> s_uiErrorsShown(0);
+	if ( s_uiErrorsShown++ < 20 )
+		fprintf(stderr, "%s: %s.\n", _szAccount, pszReason);
+
+	if ( _iState == LBS_PLAYING )
+		++_pStats->m_uiDisconnects;
+	else
+		++_pStats->m_uiLoginFailures;
+
+	Close();
+	_iState = LBS_IDLE;
+	_iTimeConnect = iTimeNow + (LOADGEN_RETRY_MSECS * 1000);
+}
+
+void CLoadBot::Connect( llong iTimeNow )
+{
+	_hSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if ( _hSocket == INVALID_SOCKET )
+	{
+		Fail("can't create a socket", iTimeNow);
+		return;
+	}
+
+#ifdef _WIN32
+	u_long ulNonBlocking = 1;
+	ioctlsocket(_hSocket, FIONBIO, &ulNonBlocking);
+#else
+	fcntl(_hSocket, F_SETFL, fcntl(_hSocket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+	// The requests are timed: don't let them wait for other data.
+	int iNoDelay = 1;
+	setsockopt(_hSocket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&iNoDelay), sizeof(iNoDelay));
+
+	if ( connect(_hSocket, reinterpret_cast<const sockaddr *>(&_config.addrServer), sizeof(_config.addrServer)) == 0 )
+	{
+		OnConnected(iTimeNow);
+		return;
+	}
+	if ( !SOCKET_CONNECTING() )
+	{
+		Fail("can't connect to the server", iTimeNow);
+		return;
+	}
+	_fConnecting = true;
+}
+
+void CLoadBot::OnConnected( llong iTimeNow )
+{
+	(void)iTimeNow;
+	if ( _iState == LBS_LOGIN_CONNECT )
+	{
+		// New login handshake (seed and client version) and account login, in the same buffer: the server wants the whole
+		// 0x80 in a single read.
+		CLoadPacket packet(0xEF);
+		packet.WriteInt32(0x10000000 | _uiIndex);
+		packet.WriteInt32(LOADGEN_CLIVER_MAJOR);
+		packet.WriteInt32(LOADGEN_CLIVER_MINOR);
+		packet.WriteInt32(LOADGEN_CLIVER_REVISION);
+		packet.WriteInt32(LOADGEN_CLIVER_PATCH);
+		packet.WriteByte(0x80);
+		packet.WriteStringFixed(_szAccount, 30);
+		packet.WriteStringFixed(_szAccount, 30);
+		packet.WriteByte(0xFF);
+		Send(packet.GetData(), packet.GetLength(), 2);
+		_iState = LBS_LOGIN_SERVERLIST;
+	}
+	else if ( _iState == LBS_GAME_CONNECT )
+	{
+		// The relay key is the seed of the game connection, then the char list request.
+		CLoadPacket packet;
+		packet.WriteData(_abRelayKey, sizeof(_abRelayKey));
+		packet.WriteByte(0x91);
+		packet.WriteData(_abRelayKey, sizeof(_abRelayKey));
+		packet.WriteStringFixed(_szAccount, 30);
+		packet.WriteStringFixed(_szAccount, 30);
+		Send(packet.GetData(), packet.GetLength());
+		_iState = LBS_GAME_CHARLIST;
+	}
+}
+
+void CLoadBot::OnPoll( short iEvents, llong iTimeNow )
+{
+	if ( _hSocket == INVALID_SOCKET )
+		return;
+
+	if ( _fConnecting )
+	{
+		int iError = 0;
+		socklen_t iErrorLen = sizeof(iError);
+		getsockopt(_hSocket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&iError), &iErrorLen);
+		if ( (iError != 0) || (iEvents & (POLLERR|POLLHUP|POLLNVAL)) )
+		{
+			Fail("can't connect to the server", iTimeNow);
+			return;
+		}
+		if ( (iEvents & POLLOUT) == 0 )
+			return;
+
+		_fConnecting = false;
+		OnConnected(iTimeNow);
+		return;
+	}
+
+	if ( (iEvents & POLLOUT) && !Flush() )
+	{
+		Fail("connection lost", iTimeNow);
+		return;
+	}
+	if ( iEvents & (POLLIN|POLLHUP|POLLERR) )
+		Receive(iTimeNow);
+}
+
+void CLoadBot::Send( const byte * pData, uint uiLen, uint uiPackets )
+{
+	// Errors are found by the next poll.
+	_pStats->m_uiPacketsOut += uiPackets;
+	_vOut.insert(_vOut.end(), pData, pData + uiLen);
+	Flush();
+}
+
+bool CLoadBot::Flush()
+{
+	while ( !_vOut.empty() )
+	{
+		const int iSent = send(_hSocket, reinterpret_cast<const char *>(_vOut.data()), (int)_vOut.size(), 0);
+		if ( iSent <= 0 )
+			return (iSent < 0) && SOCKET_WOULDBLOCK();
+
+		_pStats->m_uiBytesOut += (ullong)iSent;
+		_vOut.erase(_vOut.begin(), _vOut.begin() + iSent);
+	}
+	return true;
+}
+
+void CLoadBot::Receive( llong iTimeNow )
+{
+	const SOCKET hSocket = _hSocket;
+	byte abBuffer[0x4000];
+	for (;;)
+	{
+		const int iRead = recv(_hSocket, reinterpret_cast<char *>(abBuffer), sizeof(abBuffer), 0);
+		if ( iRead == 0 )
+		{
+			Fail("connection closed by the server", iTimeNow);
+			return;
+		}
+		if ( iRead < 0 )
+		{
+			if ( !SOCKET_WOULDBLOCK() )
+				Fail("connection lost", iTimeNow);
+			return;
+		}
+
+		// The answers are timed when they are read, not when poll returned.
+		iTimeNow = LoadGen_GetTimeMicro();
+		_pStats->m_uiBytesIn += (ullong)iRead;
+		if ( _iState <= LBS_LOGIN_RELAY )
+		{
+			_vIn.insert(_vIn.end(), abBuffer, abBuffer + iRead);
+			OnLoginData(iTimeNow);
+		}
+		else if ( !_Huffman.Decode(abBuffer, (uint)iRead, [this, iTimeNow]( const byte * pData, uint uiLen ) { OnGamePacket(pData, uiLen, iTimeNow); }) )
+		{
+			snprintf(_szError, sizeof(_szError), "invalid compressed data from the game server");
+		}
+
+		if ( _szError[0] != '\0' )
+		{
+			Fail(_szError, iTimeNow);
+			_szError[0] = '\0';
+			return;
+		}
+		if ( _hSocket != hSocket )	// Relayed to the game server.
+			return;
+	}
+}
+
+void CLoadBot::OnLoginData( llong iTimeNow )
+{
+	// The login server data isn't compressed: the few packets it sends are split by their length.
+	size_t uiPos = 0;
+	while ( uiPos < _vIn.size() )
+	{
+		const byte * pData = &_vIn[uiPos];
+		const size_t uiAvailable = _vIn.size() - uiPos;
+		size_t uiLen;
+		switch ( pData[0] )
+		{
+			case 0xA8:	// Server list.
+			case 0x1C:	// Speech (ascii), the arrival of other players is announced to the login server clients too.
+			case 0xAE:	// Speech (unicode).
+				uiLen = (uiAvailable < 3) ? 3 : ReadInt16(pData + 1);	// Waits for the length, like for the rest of the packet.
+				break;
+			case 0x82:	// Login error.
+			case 0x53:	// Warning message.
+				uiLen = 2;
+				break;
+			case 0x8C:	// Relay.
+				uiLen = 11;
+				break;
+			default:
+				snprintf(_szError, sizeof(_szError), "unexpected packet 0x%02x from the login server", pData[0]);
+				return;
+		}
+		if ( uiLen < 2 )
+		{
+			snprintf(_szError, sizeof(_szError), "invalid packet 0x%02x from the login server", pData[0]);
+			return;
+		}
+		if ( uiAvailable < uiLen )
+			break;
+
+		++_pStats->m_uiPacketsIn;
+		switch ( pData[0] )
+		{
+			case 0xA8:
+				if ( _iState == LBS_LOGIN_SERVERLIST )
+				{
+					// The first server of the list is the one answering.
+					const byte abSelect[3] = { 0xA0, 0x00, 0x00 };
+					Send(abSelect, sizeof(abSelect));
+					_iState = LBS_LOGIN_RELAY;
+				}
+				break;
+			case 0x82:
+			case 0x53:
+				snprintf(_szError, sizeof(_szError), "login refused by the server (0x%02x, code %u)", pData[0], pData[1]);
+				return;
+			case 0x8C:
+				// The game server is reached at the same address: the relay one may not be usable from here.
+				memcpy(_abRelayKey, pData + 7, sizeof(_abRelayKey));
+				Close();
+				_iState = LBS_GAME_CONNECT;
+				Connect(iTimeNow);
+				return;
+		}
+		uiPos += uiLen;
+	}
+	_vIn.erase(_vIn.begin(), _vIn.begin() + uiPos);
+}
+
+void CLoadBot::OnGamePacket( const byte * pData, uint uiLen, llong iTimeNow )
+{
+	++_pStats->m_uiPacketsIn;
+	switch ( pData[0] )
+	{
+		case 0xA9:	// Char list: play the char in the first slot, or create it.
+		{
+			if ( _iState != LBS_GAME_CHARLIST )
+				break;
+			if ( (uiLen >= 4 + 30) && (pData[3] > 0) && (pData[4] != '\0') )
+			{
+				CLoadPacket packet(0x5D);
+				packet.WriteInt32(0xEDEDEDED);
+				packet.WriteData(pData + 4, 30);	// Char name.
+				packet.WriteZero(30);				// Char password.
+				packet.WriteInt32(0);				// Slot.
+				packet.WriteInt32(0x7F000001);		// Client IP.
+				Send(packet.GetData(), packet.GetLength());
+			}
+			else
+			{
+				CLoadPacket packet(0x00);
+				packet.WriteInt32(0xEDEDEDED);
+				packet.WriteInt32(0xFFFFFFFF);
+				packet.WriteByte(0);
+				packet.WriteStringFixed(_szAccount, 30);
+				packet.WriteZero(2);
+				packet.WriteInt32(0);		// Flags.
+				packet.WriteZero(8);
+				packet.WriteByte(0);		// Profession: advanced.
+				packet.WriteZero(15);
+				packet.WriteByte(2);		// Human male (clients 7.0.0.0+).
+				packet.WriteByte(60);		// Str, dex, int.
+				packet.WriteByte(10);
+				packet.WriteByte(10);
+				packet.WriteByte(1);		// Anatomy, for the target requests.
+				packet.WriteByte(50);
+				packet.WriteByte(17);		// Healing.
+				packet.WriteByte(50);
+				packet.WriteByte(43);		// Wrestling.
+				packet.WriteByte(0);
+				packet.WriteInt16(0x83EA);	// Skin hue.
+				packet.WriteInt16(0x203B);	// Hair and hue.
+				packet.WriteInt16(0x044E);
+				packet.WriteInt16(0);		// Beard and hue.
+				packet.WriteInt16(0);
+				packet.WriteByte(0);		// Shard index.
+				packet.WriteByte(0);		// Start location.
+				packet.WriteInt32(0);		// Slot.
+				packet.WriteInt32(0x7F000001);	// Client IP.
+				packet.WriteInt16(0x0384);	// Shirt and pants hues.
+				packet.WriteInt16(0x01BB);
+				Send(packet.GetData(), packet.GetLength());
+			}
+			_iState = LBS_GAME_ENTER;
+			break;
+		}
+
+		case 0x1B:	// Player start.
+			if ( uiLen >= 5 )
+				_dwSerial = ReadInt32(pData + 1);
+			break;
+
+		case 0x55:	// Login complete.
+			if ( _iState == LBS_GAME_ENTER )
+				OnEnterWorld(iTimeNow);
+			break;
+
+		case 0x53:	// Warning message (char idle...).
+		case 0x82:	// Login error.
+		case 0x85:	// Char creation/deletion error.
+			if ( _iState != LBS_PLAYING )
+				snprintf(_szError, sizeof(_szError), "refused by the game server (0x%02x, code %u)", pData[0], (uiLen >= 2) ? pData[1] : 0);
+			break;
+
+		case 0x78:	// Char in sight, with the items it's wearing.
+		{
+			if ( uiLen < 19 )
+				break;
+			const dword dwSerial = ReadInt32(pData + 3);
+			if ( dwSerial != _dwSerial )
+			{
+				_dwOther = dwSerial;
+				break;
+			}
+			for ( uint uiPos = 19; uiPos + 9 <= uiLen; uiPos += 9 )
+			{
+				const dword dwItem = ReadInt32(pData + uiPos);
+				if ( dwItem == 0 )
+					break;
+				if ( pData[uiPos + 6] == 0x15 )	// LAYER_PACK
+					_dwBackpack = dwItem;
+			}
+			break;
+		}
+
+		case 0x2E:	// Item equipped.
+			if ( (uiLen >= 13) && (pData[8] == 0x15) && (ReadInt32(pData + 9) == _dwSerial) )
+				_dwBackpack = ReadInt32(pData + 1);
+			break;
+
+		case 0x22:	// Walk ack.
+			if ( (uiLen >= 2) && _iTimePending[LGA_WALK] && (pData[1] == _bWalkPending) )
+				OnAnswer(LGA_WALK, iTimeNow);
+			break;
+
+		case 0x21:	// Walk rejected: the sequence restarts from 0.
+			if ( _iTimePending[LGA_WALK] )
+			{
+				_iTimePending[LGA_WALK] = 0;
+				++_pStats->m_uiWalkRejected;
+			}
+			_bWalkSequence = 0;
+			break;
+
+		case 0x1C:	// Speech (ascii).
+		case 0xAE:	// Speech (unicode).
+			if ( (uiLen >= 7) && _iTimePending[LGA_SPEECH] && (ReadInt32(pData + 3) == _dwSerial) )
+				OnAnswer(LGA_SPEECH, iTimeNow);
+			break;
+
+		case 0x24:	// Container open.
+		case 0x88:	// Paperdoll, if the backpack isn't known.
+			if ( (uiLen >= 5) && _iTimePending[LGA_USE] && ((ReadInt32(pData + 1) & 0x7FFFFFFF) == (_dwUsePending & 0x7FFFFFFF)) )
+				OnAnswer(LGA_USE, iTimeNow);
+			break;
+
+		case 0x6C:	// Target cursor: answered at once, on the other char if any.
+		{
+			if ( uiLen < 6 )
+				break;
+			OnAnswer(LGA_TARGET, iTimeNow);
+
+			CLoadPacket packet(0x6C);
+			packet.WriteByte(0);				// Target an object.
+			packet.WriteData(pData + 2, 4);		// Cursor id.
+			packet.WriteByte(0);
+			packet.WriteInt32(_dwOther ? _dwOther : _dwSerial);
+			packet.WriteZero(8);				// x, y, z, graphic.
+			Send(packet.GetData(), packet.GetLength());
+			break;
+		}
+
+		case 0x73:	// Ping.
+			if ( (uiLen >= 2) && _iTimePending[LGA_PING] && (pData[1] == _bPingPending) )
+				OnAnswer(LGA_PING, iTimeNow);
+			break;
+
+		case 0xBD:	// Client version request (it's already given by the handshake, but some setups ask anyway).
+		{
+			CLoadPacket packet(0xBD);
+			packet.WriteInt16(0);
+			packet.WriteStringFixed(LOADGEN_CLIVER_STRING, sizeof(LOADGEN_CLIVER_STRING));
+			packet.WriteLength();
+			Send(packet.GetData(), packet.GetLength());
+			break;
+		}
+
+		default:
+			break;
+	}
+}
+
+void CLoadBot::OnEnterWorld( llong iTimeNow )
+{
+	_iState = LBS_PLAYING;
+	_iTimeInGame = iTimeNow;
+	_pStats->m_Latency[LGA_LOGIN].Add(iTimeNow - _iTimeLoginStart);
+
+	// Spread the requests of the clients over their intervals, so that they don't all come in the same tick.
+	for ( int i = 0; i < LGA_QTY; ++i )
+	{
+		const llong iInterval = (llong)_config.uiIntervalMsecs[i] * 1000;
+		_iTimePending[i] = 0;
+		_iTimeNext[i] = iTimeNow + ((iInterval > 0) ? ((llong)(_uiIndex * 7919u + (uint)i * 104729u) % iInterval) : 0);
+	}
+	_bWalkSequence = 0;
+	_uiWalkSteps = 0;
+}
+
+void CLoadBot::OnTick( llong iTimeNow )
+{
+	switch ( _iState )
+	{
+		case LBS_IDLE:
+			if ( iTimeNow < _iTimeConnect )
+				return;
+			_iTimeLoginStart = iTimeNow;
+			_dwSerial = _dwBackpack = _dwOther = 0;
+			_iState = LBS_LOGIN_CONNECT;
+			Connect(iTimeNow);
+			return;
+
+		case LBS_PLAYING:
+			break;
+
+		default:
+			if ( iTimeNow - _iTimeLoginStart >= (llong)LOADGEN_LOGIN_TIMEOUT_MSECS * 1000 )
+				Fail("not in game after the login timeout", iTimeNow);
+			return;
+	}
+
+	if ( _config.fProfile[LGA_LOGIN] && (iTimeNow - _iTimeInGame >= (llong)_config.uiIntervalMsecs[LGA_LOGIN] * 1000) )
+	{
+		// Log out (the char stays in the world for the linger time) and in again.
+		Close();
+		_iState = LBS_IDLE;
+		_iTimeConnect = iTimeNow + 1000000;
+		return;
+	}
+
+	for ( int i = LGA_LOGIN + 1; i < LGA_QTY; ++i )
+	{
+		const LOADGEN_ACTION_TYPE action = static_cast<LOADGEN_ACTION_TYPE>(i);
+		if ( !_config.fProfile[action] )
+			continue;
+
+		if ( _iTimePending[action] )
+		{
+			if ( iTimeNow - _iTimePending[action] < (llong)LOADGEN_TIMEOUT_MSECS * 1000 )
+				continue;
+			_pStats->m_Latency[action].AddTimeout();
+			_iTimePending[action] = 0;
+			if ( action == LGA_WALK )
+				_bWalkSequence = 0;
+		}
+		if ( iTimeNow < _iTimeNext[action] )
+			continue;
+
+		const llong iInterval = (llong)_config.uiIntervalMsecs[action] * 1000;
+		_iTimeNext[action] += iInterval;
+		if ( _iTimeNext[action] < iTimeNow )
+			_iTimeNext[action] = iTimeNow + iInterval;
+		SendRequest(action, iTimeNow);
+	}
+}
+
+void CLoadBot::SendRequest( LOADGEN_ACTION_TYPE action, llong iTimeNow )
+{
+	switch ( action )
+	{
+		case LGA_WALK:
+		{
+			// Around a square: the first request of each side only turns the char, so it comes back where it started.
+			static const byte sm_abDirs[4] = { 0, 2, 4, 6 };	// North, east, south, west.
+			CLoadPacket packet(0x02);
+			packet.WriteByte(sm_abDirs[(_uiWalkSteps / 4) % 4]);
+			packet.WriteByte(_bWalkSequence);
+			packet.WriteInt32(0);		// Fastwalk key, not used.
+			Send(packet.GetData(), packet.GetLength());
+
+			++_uiWalkSteps;
+			_bWalkPending = _bWalkSequence;
+			_bWalkSequence = (_bWalkSequence == UINT8_MAX) ? 1 : (byte)(_bWalkSequence + 1);
+			break;
+		}
+
+		case LGA_SPEECH:
+		{
+			char szText[32];
+			snprintf(szText, sizeof(szText), "load test %u", ++_uiSpeechCount);
+			CLoadPacket packet(0xAD);
+			packet.WriteInt16(0);
+			packet.WriteByte(0);			// Regular speech.
+			packet.WriteInt16(0x02B2);		// Hue.
+			packet.WriteInt16(3);			// Font.
+			packet.WriteStringFixed("ENU", 4);
+			packet.WriteStringUnicode(szText);
+			packet.WriteLength();
+			Send(packet.GetData(), packet.GetLength());
+			break;
+		}
+
+		case LGA_USE:
+		{
+			// The backpack is known from the own char (0x78) or its equip (0x2E), else the own paperdoll is opened.
+			_dwUsePending = _dwBackpack ? _dwBackpack : (_dwSerial | 0x80000000);
+			CLoadPacket packet(0x06);
+			packet.WriteInt32(_dwUsePending);
+			Send(packet.GetData(), packet.GetLength());
+			break;
+		}
+
+		case LGA_TARGET:
+		{
+			CLoadPacket packet(0x12);
+			packet.WriteInt16(0);
+			packet.WriteByte(0x24);			// Use skill: Anatomy.
+			packet.WriteStringFixed("1 0", 4);
+			packet.WriteLength();
+			Send(packet.GetData(), packet.GetLength());
+			break;
+		}
+
+		case LGA_PING:
+		{
+			_bPingPending = ++_bPingSequence;
+			CLoadPacket packet(0x73);
+			packet.WriteByte(_bPingPending);
+			Send(packet.GetData(), packet.GetLength());
+			break;
+		}
+
+		default:
+			return;
+	}
+	_iTimePending[action] = iTimeNow;
+}
+
+void CLoadBot::OnAnswer( LOADGEN_ACTION_TYPE action, llong iTimeNow )
+{
+	if ( _iTimePending[action] == 0 )
+		return;
+	_pStats->m_Latency[action].Add(iTimeNow - _iTimePending[action]);
+	_iTimePending[action] = 0;
+}
@@ -0,0 +1,95 @@
+/**
+* @file CLoadBot.h
+* @brief A headless client: logs in (unencrypted), then sends the requests of the enabled profiles and times the answers.
+*/
+
+#ifndef _INC_CLOADBOT_H
+#define _INC_CLOADBOT_H
+
+#include "CLoadHuffman.h"
+#include "CLoadStats.h"
+
+
+enum LOADBOT_STATE
+{
+	LBS_IDLE,				// Not connected, waiting for _iTimeConnect.
+	LBS_LOGIN_CONNECT,		// Connecting to the login server.
+	LBS_LOGIN_SERVERLIST,	// 0xEF + 0x80 sent, waiting for the server list (0xA8).
+	LBS_LOGIN_RELAY,		// 0xA0 sent, waiting for the relay (0x8C).
+	LBS_GAME_CONNECT,		// Connecting to the game server.
+	LBS_GAME_CHARLIST,		// Relay key + 0x91 sent, waiting for the char list (0xA9).
+	LBS_GAME_ENTER,			// 0x5D or 0x00 sent, waiting for the login complete (0x55).
+	LBS_PLAYING
+};
+
+class CLoadBot
+{
+	// The server must accept unencrypted clients (UseNoCrypt=1 in sphere.ini) and create their accounts (AccApp=2),
+	// or have them already. A client without chars creates one in its first slot, then plays with it.
+	const CLoadConfig & _config;
+	CLoadStats * _pStats;		// Of the worker thread running this client.
+	uint _uiIndex;
+	char _szAccount[32];
+	char _szError[64];			// Set while handling the received data, the connection is closed after it.
+
+	SOCKET _hSocket;
+	LOADBOT_STATE _iState;
+	bool _fConnecting;			// Non blocking connect in progress.
+	std::vector<byte> _vOut;	// Data not sent yet (the socket buffer was full).
+	std::vector<byte> _vIn;		// Login server data not handled yet (plain, until the relay).
+	CLoadHuffman _Huffman;		// Game server data.
+
+	llong _iTimeConnect;		// Next (re)connection.
+	llong _iTimeLoginStart;
+	llong _iTimeInGame;
+	byte _abRelayKey[4];		// From 0x8C, sent back as the seed and in 0x91.
+
+	dword _dwSerial;			// Own char.
+	dword _dwBackpack;
+	dword _dwOther;				// Another char in sight, to target.
+
+	llong _iTimeNext[LGA_QTY];		// Next request of each type.
+	llong _iTimePending[LGA_QTY];	// Request waiting for an answer, 0 if none.
+	byte _bWalkSequence;
+	byte _bWalkPending;
+	uint _uiWalkSteps;
+	byte _bPingSequence;
+	byte _bPingPending;
+	dword _dwUsePending;		// Object double clicked.
+	uint _uiSpeechCount;
+
+public:
+	CLoadBot( const CLoadConfig & config, uint uiIndex, CLoadStats * pStats, llong iTimeStart );
+	~CLoadBot();
+private:
+	CLoadBot(const CLoadBot& copy);
+	CLoadBot& operator=(const CLoadBot& other);
+
+public:
+	bool IsInGame() const noexcept			{ return (_iState == LBS_PLAYING); }
+	SOCKET GetSocket() const noexcept		{ return _hSocket; }
+	// Events to poll the socket for (0 if not connected).
+	short GetPollEvents() const noexcept;
+
+	void OnTick( llong iTimeNow );
+	void OnPoll( short iEvents, llong iTimeNow );
+	void Close();
+
+private:
+	void Connect( llong iTimeNow );
+	void OnConnected( llong iTimeNow );
+	void Fail( lpctstr pszReason, llong iTimeNow );
+	void Receive( llong iTimeNow );
+	bool Flush();
+	void Send( const byte * pData, uint uiLen, uint uiPackets = 1 );
+
+	void OnLoginData( llong iTimeNow );
+	void OnGamePacket( const byte * pData, uint uiLen, llong iTimeNow );
+	void OnEnterWorld( llong iTimeNow );
+
+	void SendRequest( LOADGEN_ACTION_TYPE action, llong iTimeNow );
+	void OnAnswer( LOADGEN_ACTION_TYPE action, llong iTimeNow );
+};
+
+
+#endif // _INC_CLOADBOT_H
@@ -0,0 +1,80 @@
+/**
+* @file CLoadHuffman.h
+* @brief Decompression of the game data sent by the server, splitting it in packets.
+*/
+
+#ifndef _INC_CLOADHUFFMAN_H
+#define _INC_CLOADHUFFMAN_H
+
+#include "loadgen.h"
+#include <vector>
+
+
+class CLoadHuffman
+{
+	// The server compresses each packet on its own (CHuffman::Compress), ending it with the terminator code and padding
+	// the last byte, so the end of a packet is known without the packet lengths.
+	int _iNode;					// Position in the decoding tree.
+	std::vector<byte> _vPacket;	// Packet being decoded.
+
+public:
+	CLoadHuffman();
+	~CLoadHuffman() = default;
+private:
+	CLoadHuffman(const CLoadHuffman& copy);
+	CLoadHuffman& operator=(const CLoadHuffman& other);
+
+public:
+	void Reset();
+
+	/**
+	* @brief Decode the received data, calling fnPacket(pData, uiLen) for each complete packet.
+	* @return false if the data isn't valid compressed data.
+	*/
+	template <typename F>
+	bool Decode( const byte * pData, uint uiLen, F && fnPacket );
+
+private:
+	static const short (*GetTree())[2];
+};
+
+
+template <typename F>
+bool CLoadHuffman::Decode( const byte * pData, uint uiLen, F && fnPacket )
+{
+	const short (*pTree)[2] = GetTree();
+	for ( uint i = 0; i < uiLen; ++i )
+	{
+		const byte bData = pData[i];
+		for ( int iBit = 7; iBit >= 0; --iBit )
+		{
+			const short iNext = pTree[_iNode][(bData >> iBit) & 1];
+			if ( iNext > 0 )
+			{
+				_iNode = iNext;
+				continue;
+			}
+
+			_iNode = 0;
+			if ( iNext == 0 )
+				return false;
+
+			const int iSymbol = -iNext - 1;
+			if ( iSymbol < 256 )
+			{
+				_vPacket.emplace_back((byte)iSymbol);
+				continue;
+			}
+
+			// Terminator: the rest of the byte is padding.
+			if ( !_vPacket.empty() )
+				fnPacket(_vPacket.data(), (uint)_vPacket.size());
+			_vPacket.clear();
+			break;
+		}
+	}
+	return true;
+}
+
+
+#endif // _INC_CLOADHUFFMAN_H
@@ -0,0 +1,129 @@
+#include "CLoadStats.h"
+#include <cstring>
+
+
+//*******************************************************
+// CLoadLatency
+
+CLoadLatency::CLoadLatency()
+{
+	Clear();
+}
+
+void CLoadLatency::Clear() noexcept
+{
+	memset(_uiBuckets, 0, sizeof(_uiBuckets));
+	_uiCount = 0;
+	_uiSumMicro = 0;
+	_uiMaxMicro = 0;
+	_uiTimeouts = 0;
+}
+
+uint CLoadLatency::GetBucket( ullong uiMicro ) noexcept // static
+{
+	if ( uiMicro > UINT32_MAX )
+		uiMicro = UINT32_MAX;
+	if ( uiMicro < 16 )
+		return (uint)uiMicro;
+
+	uint uiHighBit = 4;
+	while ( (uiMicro >> (uiHighBit + 1)) != 0 )
+		++uiHighBit;
+	return ((uiHighBit - 3) * 16) + (uint)((uiMicro >> (uiHighBit - 4)) & 15);
+}
+
+double CLoadLatency::GetBucketMicro( uint uiBucket ) noexcept // static
+{
+	// Middle of the bucket.
+	if ( uiBucket < 16 )
+		return (double)uiBucket;
+
+	const uint uiShift = (uiBucket / 16) - 1;
+	const ullong uiLow = (ullong)(16 + (uiBucket % 16)) << uiShift;
+	return (double)uiLow + (double)(1ull << uiShift) / 2.0;
+}
+
+void CLoadLatency::Add( llong iMicro ) noexcept
+{
+	const ullong uiMicro = (iMicro > 0) ? (ullong)iMicro : 0;
+	++_uiBuckets[GetBucket(uiMicro)];
+	++_uiCount;
+	_uiSumMicro += uiMicro;
+	if ( uiMicro > _uiMaxMicro )
+		_uiMaxMicro = uiMicro;
+}
+
+void CLoadLatency::AddTimeout() noexcept
+{
+	++_uiTimeouts;
+}
+
+void CLoadLatency::Merge( const CLoadLatency & other ) noexcept
+{
+	for ( uint i = 0; i < LOADLATENCY_BUCKETS; ++i )
+		_uiBuckets[i] += other._uiBuckets[i];
+	_uiCount += other._uiCount;
+	_uiSumMicro += other._uiSumMicro;
+	if ( other._uiMaxMicro > _uiMaxMicro )
+		_uiMaxMicro = other._uiMaxMicro;
+	_uiTimeouts += other._uiTimeouts;
+}
+
+double CLoadLatency::GetAverageMsecs() const noexcept
+{
+	return _uiCount ? ((double)_uiSumMicro / (double)_uiCount / 1000.0) : 0.0;
+}
+
+double CLoadLatency::GetMaxMsecs() const noexcept
+{
+	return (double)_uiMaxMicro / 1000.0;
+}
+
+double CLoadLatency::GetPercentileMsecs( double dPercent ) const noexcept
+{
+	if ( _uiCount == 0 )
+		return 0.0;
+
+	const double dRank = (double)_uiCount * dPercent / 100.0;
+	ullong uiCumulative = 0;
+	for ( uint i = 0; i < LOADLATENCY_BUCKETS; ++i )
+	{
+		uiCumulative += _uiBuckets[i];
+		if ( (uiCumulative > 0) && ((double)uiCumulative >= dRank) )
+			return GetBucketMicro(i) / 1000.0;
+	}
+	return GetMaxMsecs();
+}
+
+
+//*******************************************************
+// CLoadStats
+
+CLoadStats::CLoadStats()
+{
+	Clear();
+}
+
+void CLoadStats::Clear() noexcept
+{
+	for ( CLoadLatency & latency : m_Latency )
+		latency.Clear();
+	m_uiBytesIn = m_uiBytesOut = 0;
+	m_uiPacketsIn = m_uiPacketsOut = 0;
+	m_uiWalkRejected = 0;
+	m_uiLoginFailures = 0;
+	m_uiDisconnects = 0;
+}
+
+void CLoadStats::Merge( const CLoadStats & other ) noexcept
+{
+	for ( int i = 0; i < LGA_QTY; ++i )
+		m_Latency[i].Merge(other.m_Latency[i]);
+	m_uiBytesIn += other.m_uiBytesIn;
+	m_uiBytesOut += other.m_uiBytesOut;
+	m_uiPacketsIn += other.m_uiPacketsIn;
+	m_uiPacketsOut += other.m_uiPacketsOut;
+	m_uiWalkRejected += other.m_uiWalkRejected;
+	m_uiLoginFailures += other.m_uiLoginFailures;
+	m_uiDisconnects += other.m_uiDisconnects;
+}
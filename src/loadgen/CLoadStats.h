@@ -0,0 +1,64 @@
+/**
+* @file CLoadStats.h
+* @brief Latencies, bandwidth and errors measured by the load generator clients.
+*/
+
+#ifndef _INC_CLOADSTATS_H
+#define _INC_CLOADSTATS_H
+
+#include "loadgen.h"
+
+
+#define LOADLATENCY_BUCKETS		(29 * 16)	// Up to 2^32 microseconds.
+
+class CLoadLatency
+{
+	// Log-linear histogram of the latencies: 16 buckets for each power of 2, so the percentiles are within 6%.
+	// Fixed size, so the worker threads merge theirs without keeping the samples.
+	ullong _uiBuckets[LOADLATENCY_BUCKETS];
+	ullong _uiCount;
+	ullong _uiSumMicro;
+	ullong _uiMaxMicro;
+	ullong _uiTimeouts;
+
+public:
+	CLoadLatency();
+
+	void Clear() noexcept;
+	void Add( llong iMicro ) noexcept;
+	void AddTimeout() noexcept;
+	void Merge( const CLoadLatency & other ) noexcept;
+
+	ullong GetCount() const noexcept	{ return _uiCount; }
+	ullong GetTimeouts() const noexcept	{ return _uiTimeouts; }
+	double GetAverageMsecs() const noexcept;
+	double GetMaxMsecs() const noexcept;
+	// dPercent from 0 to 100.
+	double GetPercentileMsecs( double dPercent ) const noexcept;
+
+private:
+	static uint GetBucket( ullong uiMicro ) noexcept;
+	static double GetBucketMicro( uint uiBucket ) noexcept;
+};
+
+class CLoadStats
+{
+public:
+	CLoadLatency m_Latency[LGA_QTY];
+	ullong m_uiBytesIn;			// Received from the server, as sent on the network (compressed).
+	ullong m_uiBytesOut;
+	ullong m_uiPacketsIn;
+	ullong m_uiPacketsOut;
+	ullong m_uiWalkRejected;	// 0x21 received.
+	ullong m_uiLoginFailures;	// Connections closed or refused before being in game.
+	ullong m_uiDisconnects;		// Connections closed while in game (not counting the LGA_LOGIN profile ones).
+
+public:
+	CLoadStats();
+
+	void Clear() noexcept;
+	void Merge( const CLoadStats & other ) noexcept;
+};
+
+
+#endif // _INC_CLOADSTATS_H
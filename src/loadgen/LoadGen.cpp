@@ -0,0 +1,485 @@
+/**
+* @file LoadGen.cpp
+* @brief Load generator entry point: runs the headless clients on worker threads and reports what they measured.
+*/
+
+#include "CLoadBot.h"
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+static const char * sm_szActionNames[LGA_QTY] =
+{
+	"login",
+	"walk",
+	"speech",
+	"use",
+	"target",
+	"ping"
+};
+
+static std::atomic<bool> sm_fStop(false);
+static std::mutex sm_StatsMutex;
+static CLoadStats sm_StatsTotal;	// Merged from the worker threads, under sm_StatsMutex.
+static std::atomic<uint> sm_uiInGame(0);
+
+
+CLoadConfig::CLoadConfig() :
+	sHost("127.0.0.1"), wPort(2593), uiClients(100), uiThreads(4),
+	sPrefix("loadgen"), uiIndexFirst(0),
+	uiLoginRate(20), uiDuration(60), uiReportInterval(5)
+{
+	memset(&addrServer, 0, sizeof(addrServer));
+	for ( int i = 0; i < LGA_QTY; ++i )
+		fProfile[i] = false;
+	fProfile[LGA_WALK] = fProfile[LGA_SPEECH] = fProfile[LGA_USE] = fProfile[LGA_TARGET] = true;
+	fProfile[LGA_PING] = true;	// Always: it gives the tick time seen by the clients.
+
+	uiIntervalMsecs[LGA_LOGIN] = 60000;
+	uiIntervalMsecs[LGA_WALK] = 500;	// The server refuses steps faster than the walking speed (about 400 ms).
+	uiIntervalMsecs[LGA_SPEECH] = 10000;
+	uiIntervalMsecs[LGA_USE] = 5000;
+	uiIntervalMsecs[LGA_TARGET] = 10000;
+	uiIntervalMsecs[LGA_PING] = LOADGEN_PING_MSECS;
+}
+
+llong LoadGen_GetTimeMicro() noexcept
+{
+	return (llong)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+lpctstr LoadGen_GetActionName( LOADGEN_ACTION_TYPE action ) noexcept
+{
+	return ((action >= 0) && (action < LGA_QTY)) ? sm_szActionNames[action] : "?";
+}
+
+static void LoadGen_Usage()
+{
+	printf(
+		"Usage: sphereloadgen [options]\n"
+		"Connects headless unencrypted clients to a running server and measures it under load.\n"
+		"The server needs UseNoCrypt=1, AccApp=2 (or the accounts already created), ClientMaxIP=0, ConnectingMaxIP=0,\n"
+		"ClientMax/ConnectingMax above the number of clients and MaxPings above twice that number (each client\n"
+		"connects to the login server, then to the game server).\n"
+		"  -?, --help      Show this help.\n"
+		"  -h <host>       Server address (default 127.0.0.1).\n"
+		"  -p <port>       Server port (default 2593).\n"
+		"  -n <clients>    Number of clients (default 100).\n"
+		"  -t <threads>    Worker threads running the clients (default 4).\n"
+		"  -a <prefix>     Account names prefix, followed by the client index (default loadgen).\n"
+		"  -f <index>      Index of the first account (default 0).\n"
+		"  -r <rate>       Clients connecting per second while ramping up (default 20).\n"
+		"  -d <seconds>    Duration of the test once all the clients are connecting (default 60).\n"
+		"  -i <seconds>    Interval of the reports (default 5).\n"
+		"  -P <profiles>   Comma separated profiles, each one optionally with its interval in ms (name=ms):\n"
+		"                  login (reconnect after the interval), walk, speech, use, target.\n"
+		"                  Default walk=500,speech=10000,use=5000,target=10000.\n"
+		"  -m <file>       metrics.prom of the server (MetricsInterval), to report the tick durations.\n"
+		"  -c <file>       Write the final results to this CSV file.\n");
+}
+
+static bool LoadGen_ParseProfiles( CLoadConfig & config, const char * pszProfiles )
+{
+	for ( int i = 0; i < LGA_QTY; ++i )
+	{
+		if ( i != LGA_PING )
+			config.fProfile[i] = false;
+	}
+
+	std::string sProfiles(pszProfiles);
+	size_t uiStart = 0;
+	while ( uiStart <= sProfiles.size() )
+	{
+		size_t uiEnd = sProfiles.find(',', uiStart);
+		if ( uiEnd == std::string::npos )
+			uiEnd = sProfiles.size();
+		std::string sName(sProfiles, uiStart, uiEnd - uiStart);
+		uiStart = uiEnd + 1;
+		if ( sName.empty() )
+			continue;
+
+		long lInterval = 0;
+		const size_t uiEqual = sName.find('=');
+		if ( uiEqual != std::string::npos )
+		{
+			lInterval = strtol(sName.c_str() + uiEqual + 1, nullptr, 10);
+			sName.resize(uiEqual);
+			if ( lInterval <= 0 )
+			{
+				fprintf(stderr, "Invalid interval for the profile '%s'.\n", sName.c_str());
+				return false;
+			}
+		}
+
+		int iAction = LGA_LOGIN;
+		for ( ; iAction < LGA_PING; ++iAction )
+		{
+			if ( sName == sm_szActionNames[iAction] )
+				break;
+		}
+		if ( iAction == LGA_PING )
+		{
+			fprintf(stderr, "Unknown profile '%s'.\n", sName.c_str());
+			return false;
+		}
+		config.fProfile[iAction] = true;
+		if ( lInterval > 0 )
+			config.uiIntervalMsecs[iAction] = (uint)lInterval;
+	}
+	return true;
+}
+
+static bool LoadGen_ParseArgs( CLoadConfig & config, int argc, char * argv[] )
+{
+	for ( int i = 1; i < argc; ++i )
+	{
+		const char * pszArg = argv[i];
+		if ( (pszArg[0] != '-') || (pszArg[1] == '\0') || (pszArg[2] != '\0') || (i + 1 >= argc) )
+		{
+			fprintf(stderr, "Invalid or incomplete option '%s' (-? for the help).\n", pszArg);
+			return false;
+		}
+		const char * pszVal = argv[++i];
+		switch ( pszArg[1] )
+		{
+			case 'h':	config.sHost = pszVal;	break;
+			case 'p':	config.wPort = (word)atoi(pszVal);	break;
+			case 'n':	config.uiClients = (uint)atoi(pszVal);	break;
+			case 't':	config.uiThreads = (uint)atoi(pszVal);	break;
+			case 'a':	config.sPrefix = pszVal;	break;
+			case 'f':	config.uiIndexFirst = (uint)atoi(pszVal);	break;
+			case 'r':	config.uiLoginRate = (uint)atoi(pszVal);	break;
+			case 'd':	config.uiDuration = (uint)atoi(pszVal);	break;
+			case 'i':	config.uiReportInterval = (uint)atoi(pszVal);	break;
+			case 'm':	config.sMetricsFile = pszVal;	break;
+			case 'c':	config.sCSVFile = pszVal;	break;
+			case 'P':
+				if ( !LoadGen_ParseProfiles(config, pszVal) )
+					return false;
+				break;
+			default:
+				fprintf(stderr, "Unknown option '%s' (-? for the help).\n", pszArg);
+				return false;
+		}
+	}
+
+	if ( (config.uiClients == 0) || (config.uiLoginRate == 0) || (config.uiReportInterval == 0) )
+	{
+		fprintf(stderr, "The number of clients, the login rate and the report interval can't be 0.\n");
+		return false;
+	}
+	if ( config.uiThreads == 0 )
+		config.uiThreads = 1;
+	if ( config.uiThreads > config.uiClients )
+		config.uiThreads = config.uiClients;
+	if ( config.sPrefix.size() + 10 > 20 )
+	{
+		// The server accepts account names up to 20 chars (MAX_ACCOUNT_NAME_SIZE).
+		fprintf(stderr, "The account prefix is too long.\n");
+		return false;
+	}
+
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo * pResult = nullptr;
+	if ( (getaddrinfo(config.sHost.c_str(), nullptr, &hints, &pResult) != 0) || (pResult == nullptr) )
+	{
+		fprintf(stderr, "Can't resolve the server address '%s'.\n", config.sHost.c_str());
+		return false;
+	}
+	memcpy(&config.addrServer, pResult->ai_addr, sizeof(config.addrServer));
+	config.addrServer.sin_port = htons(config.wPort);
+	freeaddrinfo(pResult);
+	return true;
+}
+
+static void LoadGen_Worker( const CLoadConfig & config, uint uiThread, llong iTimeStart )
+{
+	// Runs the clients uiThread, uiThread + uiThreads...: the ramp up is spread on all the threads.
+	CLoadStats stats;
+	std::vector<std::unique_ptr<CLoadBot>> vBots;
+	for ( uint i = uiThread; i < config.uiClients; i += config.uiThreads )
+		vBots.emplace_back(new CLoadBot(config, i, &stats, iTimeStart + ((llong)i * 1000000 / config.uiLoginRate)));
+
+	std::vector<pollfd> vPoll;
+	std::vector<CLoadBot *> vPollBots;
+	vPoll.reserve(vBots.size());
+	vPollBots.reserve(vBots.size());
+	llong iTimeMerge = LoadGen_GetTimeMicro();
+	uint uiInGame = 0;
+
+	while ( !sm_fStop )
+	{
+		vPoll.clear();
+		vPollBots.clear();
+		for ( const std::unique_ptr<CLoadBot> & pBot : vBots )
+		{
+			const short iEvents = pBot->GetPollEvents();
+			if ( iEvents == 0 )
+				continue;
+			pollfd fd;
+			fd.fd = pBot->GetSocket();
+			fd.events = iEvents;
+			fd.revents = 0;
+			vPoll.push_back(fd);
+			vPollBots.push_back(pBot.get());
+		}
+
+		// The clients' timers are checked at least every 5 ms.
+		int iReady = 0;
+		if ( vPoll.empty() )
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		else
+			iReady = poll(vPoll.data(), (uint)vPoll.size(), 5);
+
+		llong iTimeNow = LoadGen_GetTimeMicro();
+		if ( iReady > 0 )
+		{
+			for ( size_t i = 0; i < vPoll.size(); ++i )
+			{
+				if ( vPoll[i].revents != 0 )
+					vPollBots[i]->OnPoll(vPoll[i].revents, iTimeNow);
+			}
+			iTimeNow = LoadGen_GetTimeMicro();
+		}
+
+		uint uiInGameNow = 0;
+		for ( const std::unique_ptr<CLoadBot> & pBot : vBots )
+		{
+			pBot->OnTick(iTimeNow);
+			if ( pBot->IsInGame() )
+				++uiInGameNow;
+		}
+
+		if ( iTimeNow - iTimeMerge >= 250000 )
+		{
+			iTimeMerge = iTimeNow;
+			{
+				std::lock_guard<std::mutex> lock(sm_StatsMutex);
+				sm_StatsTotal.Merge(stats);
+			}
+			stats.Clear();
+			sm_uiInGame += uiInGameNow;
+			sm_uiInGame -= uiInGame;
+			uiInGame = uiInGameNow;
+		}
+	}
+
+	for ( const std::unique_ptr<CLoadBot> & pBot : vBots )
+		pBot->Close();
+	std::lock_guard<std::mutex> lock(sm_StatsMutex);
+	sm_StatsTotal.Merge(stats);
+}
+
+static bool LoadGen_ReadTickMetrics( const std::string & sFile, double & dSumSeconds, ullong & uiCount )
+{
+	// The server replaces the file with a new snapshot every MetricsInterval.
+	FILE * pFile = fopen(sFile.c_str(), "r");
+	if ( pFile == nullptr )
+		return false;
+
+	bool fSum = false, fCount = false;
+	char szLine[512];
+	while ( fgets(szLine, sizeof(szLine), pFile) != nullptr )
+	{
+		static const char sm_szSum[] = "sphere_tick_duration_sum ";
+		static const char sm_szCount[] = "sphere_tick_duration_count ";
+		if ( !strncmp(szLine, sm_szSum, sizeof(sm_szSum) - 1) )
+		{
+			dSumSeconds = strtod(szLine + sizeof(sm_szSum) - 1, nullptr);
+			fSum = true;
+		}
+		else if ( !strncmp(szLine, sm_szCount, sizeof(sm_szCount) - 1) )
+		{
+			uiCount = strtoull(szLine + sizeof(sm_szCount) - 1, nullptr, 10);
+			fCount = true;
+		}
+	}
+	fclose(pFile);
+	return fSum && fCount;
+}
+
+struct CLoadTickSample
+{
+	bool fValid;
+	double dSumSeconds;
+	ullong uiCount;
+
+	CLoadTickSample() : fValid(false), dSumSeconds(0.0), uiCount(0) {}
+	void Read( const CLoadConfig & config )
+	{
+		if ( !config.sMetricsFile.empty() )
+			fValid = LoadGen_ReadTickMetrics(config.sMetricsFile, dSumSeconds, uiCount);
+	}
+	// Average tick duration in ms since the previous sample, < 0 if unknown.
+	double GetAverageMsecs( const CLoadTickSample & previous ) const
+	{
+		if ( !fValid || !previous.fValid || (uiCount <= previous.uiCount) )
+			return -1.0;
+		return (dSumSeconds - previous.dSumSeconds) * 1000.0 / (double)(uiCount - previous.uiCount);
+	}
+};
+
+static void LoadGen_Report( const CLoadStats & stats, double dSeconds, uint uiInGame, double dTickMsecs )
+{
+	printf("%7.1fs  in game %u  ping avg %.2f ms p99 %.2f ms  walk p99 %.2f ms  in %.1f KB/s  out %.1f KB/s",
+		dSeconds, uiInGame,
+		stats.m_Latency[LGA_PING].GetAverageMsecs(), stats.m_Latency[LGA_PING].GetPercentileMsecs(99.0),
+		stats.m_Latency[LGA_WALK].GetPercentileMsecs(99.0),
+		(double)stats.m_uiBytesIn / 1024.0, (double)stats.m_uiBytesOut / 1024.0);
+	if ( dTickMsecs >= 0.0 )
+		printf("  tick avg %.2f ms", dTickMsecs);
+	printf("\n");
+	fflush(stdout);
+}
+
+static void LoadGen_WriteResults( const CLoadConfig & config, const CLoadStats & stats, double dSeconds, double dTickMsecs )
+{
+	printf("\nResults over %.1f s, %u clients:\n", dSeconds, config.uiClients);
+	printf("%-8s %10s %9s %9s %9s %9s %9s %9s\n", "request", "count", "timeouts", "avg ms", "p50 ms", "p95 ms", "p99 ms", "max ms");
+	for ( int i = 0; i < LGA_QTY; ++i )
+	{
+		const CLoadLatency & latency = stats.m_Latency[i];
+		if ( !config.fProfile[i] && !latency.GetCount() )
+			continue;
+		printf("%-8s %10llu %9llu %9.2f %9.2f %9.2f %9.2f %9.2f\n", sm_szActionNames[i],
+			latency.GetCount(), latency.GetTimeouts(), latency.GetAverageMsecs(),
+			latency.GetPercentileMsecs(50.0), latency.GetPercentileMsecs(95.0), latency.GetPercentileMsecs(99.0), latency.GetMaxMsecs());
+	}
+	const double dDivisor = (dSeconds > 0.0) ? dSeconds : 1.0;
+	printf("Received: %llu packets, %llu bytes (%.1f KB/s, %.1f bytes/s per client)\n", stats.m_uiPacketsIn, stats.m_uiBytesIn,
+		(double)stats.m_uiBytesIn / 1024.0 / dDivisor, (double)stats.m_uiBytesIn / dDivisor / config.uiClients);
+	printf("Sent: %llu packets, %llu bytes (%.1f KB/s, %.1f bytes/s per client)\n", stats.m_uiPacketsOut, stats.m_uiBytesOut,
+		(double)stats.m_uiBytesOut / 1024.0 / dDivisor, (double)stats.m_uiBytesOut / dDivisor / config.uiClients);
+	printf("Walk rejected: %llu, login failures: %llu, disconnections: %llu\n", stats.m_uiWalkRejected, stats.m_uiLoginFailures, stats.m_uiDisconnects);
+	if ( dTickMsecs >= 0.0 )
+		printf("Server tick: %.3f ms average (from %s)\n", dTickMsecs, config.sMetricsFile.c_str());
+
+	if ( config.sCSVFile.empty() )
+		return;
+	FILE * pFile = fopen(config.sCSVFile.c_str(), "w");
+	if ( pFile == nullptr )
+	{
+		fprintf(stderr, "Can't write the results to '%s'.\n", config.sCSVFile.c_str());
+		return;
+	}
+	fprintf(pFile, "request,count,timeouts,avg_ms,p50_ms,p95_ms,p99_ms,max_ms\n");
+	for ( int i = 0; i < LGA_QTY; ++i )
+	{
+		const CLoadLatency & latency = stats.m_Latency[i];
+		fprintf(pFile, "%s,%llu,%llu,%.3f,%.3f,%.3f,%.3f,%.3f\n", sm_szActionNames[i],
+			latency.GetCount(), latency.GetTimeouts(), latency.GetAverageMsecs(),
+			latency.GetPercentileMsecs(50.0), latency.GetPercentileMsecs(95.0), latency.GetPercentileMsecs(99.0), latency.GetMaxMsecs());
+	}
+	fprintf(pFile, "bytes_in_per_sec,%.1f\nbytes_out_per_sec,%.1f\npackets_in,%llu\npackets_out,%llu\n",
+		(double)stats.m_uiBytesIn / dDivisor, (double)stats.m_uiBytesOut / dDivisor, stats.m_uiPacketsIn, stats.m_uiPacketsOut);
+	fprintf(pFile, "walk_rejected,%llu\nlogin_failures,%llu\ndisconnects,%llu\n", stats.m_uiWalkRejected, stats.m_uiLoginFailures, stats.m_uiDisconnects);
+	if ( dTickMsecs >= 0.0 )
+		fprintf(pFile, "tick_avg_ms,%.3f\n", dTickMsecs);
+	fclose(pFile);
+	printf("Results written to %s\n", config.sCSVFile.c_str());
+}
+
+static void LoadGen_OnSignal( int )
+{
+	sm_fStop = true;
+}
+
+int main( int argc, char * argv[] )
+{
+#ifdef _WIN32
+	WSADATA wsaData;
+	if ( WSAStartup(MAKEWORD(2, 2), &wsaData) != 0 )
+	{
+		fprintf(stderr, "Can't initialize Winsock.\n");
+		return 1;
+	}
+#else
+	signal(SIGPIPE, SIG_IGN);	// Writing to a socket closed by the server.
+#endif
+	signal(SIGINT, LoadGen_OnSignal);
+
+	for ( int i = 1; i < argc; ++i )
+	{
+		if ( !strcmp(argv[i], "-?") || !strcmp(argv[i], "--help") )
+		{
+			LoadGen_Usage();
+			return 0;
+		}
+	}
+
+	CLoadConfig config;
+	if ( !LoadGen_ParseArgs(config, argc, argv) )
+		return 1;
+
+	printf("%u clients on %s:%u (%u threads, %u logins/s), profiles:", config.uiClients, config.sHost.c_str(), config.wPort, config.uiThreads, config.uiLoginRate);
+	for ( int i = 0; i < LGA_PING; ++i )
+	{
+		if ( config.fProfile[i] )
+			printf(" %s=%ums", sm_szActionNames[i], config.uiIntervalMsecs[i]);
+	}
+	printf("\n");
+
+	const llong iTimeStart = LoadGen_GetTimeMicro();
+	const llong iTimeEnd = iTimeStart + ((llong)config.uiClients * 1000000 / config.uiLoginRate) + ((llong)config.uiDuration * 1000000);
+
+	std::vector<std::thread> vThreads;
+	for ( uint i = 0; i < config.uiThreads; ++i )
+		vThreads.emplace_back(LoadGen_Worker, std::cref(config), i, iTimeStart);
+
+	// The reports show what happened since the previous one, the results everything.
+	CLoadStats statsAll, statsInterval;
+	CLoadTickSample tickFirst, tickPrevious;
+	tickFirst.Read(config);
+	tickPrevious = tickFirst;
+	llong iTimeReport = iTimeStart;
+	while ( !sm_fStop )
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		const llong iTimeNow = LoadGen_GetTimeMicro();
+		if ( iTimeNow >= iTimeEnd )
+			sm_fStop = true;
+		else if ( iTimeNow - iTimeReport < (llong)config.uiReportInterval * 1000000 )
+			continue;
+
+		{
+			std::lock_guard<std::mutex> lock(sm_StatsMutex);
+			statsInterval = sm_StatsTotal;
+			sm_StatsTotal.Clear();
+		}
+		statsAll.Merge(statsInterval);
+
+		CLoadTickSample tick;
+		tick.Read(config);
+		const double dIntervalSeconds = (double)(iTimeNow - iTimeReport) / 1000000.0;
+		statsInterval.m_uiBytesIn = (ullong)((double)statsInterval.m_uiBytesIn / dIntervalSeconds);
+		statsInterval.m_uiBytesOut = (ullong)((double)statsInterval.m_uiBytesOut / dIntervalSeconds);
+		LoadGen_Report(statsInterval, (double)(iTimeNow - iTimeStart) / 1000000.0, sm_uiInGame, tick.GetAverageMsecs(tickPrevious));
+		if ( tick.fValid )
+			tickPrevious = tick;
+		iTimeReport = iTimeNow;
+	}
+
+	for ( std::thread & thread : vThreads )
+		thread.join();
+	statsAll.Merge(sm_StatsTotal);
+
+	CLoadTickSample tickLast;
+	tickLast.Read(config);
+	LoadGen_WriteResults(config, statsAll, (double)(LoadGen_GetTimeMicro() - iTimeStart) / 1000000.0, tickLast.GetAverageMsecs(tickFirst));
+
+#ifdef _WIN32
+	WSACleanup();
+#endif
+	return 0;
+}
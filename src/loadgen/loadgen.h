@@ -0,0 +1,90 @@
+/**
+* @file loadgen.h
+* @brief Common definitions of the load generator: headless clients playing on a running server, to measure it under load.
+*/
+
+#ifndef _INC_LOADGEN_H
+#define _INC_LOADGEN_H
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <winsock2.h>
+	#include <ws2tcpip.h>
+	#define poll			WSAPoll
+	#define CLOSESOCKET(_x_)	closesocket(_x_)
+	#define SOCKET_WOULDBLOCK()		(WSAGetLastError() == WSAEWOULDBLOCK)
+	#define SOCKET_CONNECTING()		(WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+	#include <sys/socket.h>
+	#include <netinet/in.h>
+	#include <netinet/tcp.h>
+	#include <arpa/inet.h>
+	#include <netdb.h>
+	#include <poll.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <errno.h>
+
+	#define SOCKET			int
+	#define INVALID_SOCKET	(-1)
+	#define CLOSESOCKET(_x_)	close(_x_)
+	#define SOCKET_WOULDBLOCK()		((errno == EAGAIN) || (errno == EWOULDBLOCK))
+	#define SOCKET_CONNECTING()		(errno == EINPROGRESS)
+#endif
+
+#include "../common/datatypes.h"
+#include <string>
+
+
+// Client version reported in the login handshake (0xEF): the packets are then read in the newest formats (0x78 with hues...).
+#define LOADGEN_CLIVER_MAJOR		7
+#define LOADGEN_CLIVER_MINOR		0
+#define LOADGEN_CLIVER_REVISION		50
+#define LOADGEN_CLIVER_PATCH		0
+#define LOADGEN_CLIVER_STRING		"7.0.50.0"
+
+#define LOADGEN_TIMEOUT_MSECS		5000	// A request without an answer after this long is counted as timed out.
+#define LOADGEN_LOGIN_TIMEOUT_MSECS	30000	// A client not in game after this long is disconnected and retried.
+#define LOADGEN_RETRY_MSECS			5000	// Delay before reconnecting a client after a failure or a disconnection.
+#define LOADGEN_PING_MSECS			1000	// Every client pings the server this often.
+
+
+// The requests sent by the clients and timed until the server answers.
+enum LOADGEN_ACTION_TYPE
+{
+	LGA_LOGIN,		// From the connection to the login server to the login complete packet (0x55).
+	LGA_WALK,		// 0x02 walk request -> 0x22 walk ack.
+	LGA_SPEECH,		// 0xAD speech -> 0xAE/0x1C speech of the own char.
+	LGA_USE,		// 0x06 double click on the backpack -> 0x24 container open.
+	LGA_TARGET,		// 0x12 use skill Anatomy -> 0x6C target cursor, answered on a char in sight (or self).
+	LGA_PING,		// 0x73 ping -> 0x73: the wait for the main loop to handle a packet, so it follows the tick time.
+	LGA_QTY
+};
+
+struct CLoadConfig
+{
+	std::string sHost;
+	word wPort;
+	sockaddr_in addrServer;		// sHost:wPort resolved.
+	uint uiClients;
+	uint uiThreads;
+	std::string sPrefix;		// The accounts are <prefix><index>, with the same password.
+	uint uiIndexFirst;
+	uint uiLoginRate;			// New clients connecting per second, while ramping up.
+	uint uiDuration;			// Seconds to run once all the clients are connecting.
+	uint uiReportInterval;		// Seconds between the reports.
+	bool fProfile[LGA_QTY];
+	uint uiIntervalMsecs[LGA_QTY];	// Time between two requests of each type, per client (for LGA_LOGIN: time in game before reconnecting).
+	std::string sMetricsFile;	// metrics.prom of the server, for the tick times.
+	std::string sCSVFile;
+
+	CLoadConfig();
+};
+
+llong LoadGen_GetTimeMicro() noexcept;
+lpctstr LoadGen_GetActionName( LOADGEN_ACTION_TYPE action ) noexcept;
+
+
+#endif // _INC_LOADGEN_H
@@ -23,6 +23,7 @@ CNetState::CNetState(int id)
     m_useAsync = false;
     m_outgoing.currentTransaction = nullptr;
     m_outgoing.pendingTransaction = nullptr;
+    m_outgoing.tickQueuePending = false;
     m_incoming.buffer = nullptr;
     m_incoming.rawBuffer = nullptr;
     m_packetExceptions = 0;
@@ -121,6 +122,11 @@ void CNetState::clear(void)
         m_outgoing.pendingTransaction = nullptr;
     }
 
+    for (PacketTransaction* transaction : m_outgoing.tickQueue)
+        delete transaction;
+    m_outgoing.tickQueue.clear();
+    m_outgoing.tickQueuePending = false;
+
     if (m_incoming.buffer != nullptr)
     {
         delete m_incoming.buffer;
@@ -296,6 +302,10 @@ bool CNetState::hasPendingData(void) const
     if (isAsyncMode() && m_outgoing.asyncQueue.empty() == false)
         return true;
 
+    // check the transactions not yet handed over to the network thread
+    if (m_outgoing.tickQueuePending)
+        return true;
+
     // check byte queue
     if (m_outgoing.bytes.GetDataQty() > 0)
         return true;
@@ -11,6 +11,8 @@
 #include "../sphere/containers.h"
 #include "CSocket.h"
 #include "packet.h"
+#include <atomic>
+#include <vector>
 
 #ifdef _LIBEV
     #include "linuxev.h"
@@ -68,6 +70,9 @@ protected:
 
         PacketTransaction* currentTransaction;			// transaction currently being processed
         ExtendedPacketTransaction* pendingTransaction;	// transaction being built
+
+        std::vector<PacketTransaction*> tickQueue;	// transactions queued by the main thread during this tick (threaded output only, main thread only)
+        std::atomic_bool tickQueuePending;			// tickQueue isn't empty (read by the network thread)
     } m_outgoing; // outgoing data
 
     struct
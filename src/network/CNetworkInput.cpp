@@ -1,8 +1,11 @@
 #include "../common/crypto/CCrypto.h"
+#include "../game/chars/CChar.h"
 #include "../game/clients/CClient.h"
 #include "../game/CServer.h"
 #include "../game/CWorldGameTime.h"
+#include "../game/spheresvr.h"
 #include "../sphere/threads.h"
+#include "../sphere/TickWatchdog.h"
 #include "packet.h"
 #include "send.h"
 #include "CNetState.h"
@@ -78,6 +81,7 @@ void CNetworkInput::receiveData()
         return;
 
     EXC_SET_BLOCK("messages");
+    bool fReceived = false;
     NetworkThreadStateIterator states(m_thread);
     while (CNetState* state = states.next())
     {
@@ -105,6 +109,7 @@ void CNetworkInput::receiveData()
 
         EXC_SET_BLOCK("start client profile");
         CurrentProfileData.Count(PROFILE_DATA_RX, received);
+        fReceived = true;
 
         EXC_SET_BLOCK("messages - parse");
 
@@ -127,6 +132,10 @@ void CNetworkInput::receiveData()
         }
     }
 
+    // the main thread may be sleeping until its next timer, wake it up to handle the packets now
+    if (fReceived && m_thread->isActive())
+        g_Main.awaken();
+
     EXC_CATCH;
 }
 
@@ -375,7 +384,12 @@ bool CNetworkInput::processGameClientData(CNetState* state, Packet* buffer)
             // move to position 1 (no need for id) and fire onReceive()
             handler->resize(packetLength);
             handler->seek(1);
+            CurrentProfileData.CountPacket(false, packetId);
+            const CChar* pCharPacket = CTickWatchdog::IsRecording() ? client->GetChar() : nullptr;
+            const TickWatchdogUnit watchdogUnit(TICKUNIT_PACKET, pCharPacket ? pCharPacket->GetUID().GetObjUID() : 0, "game", packetId);
+            const llong iPacketStart = GetPreciseSysTimeMicro();
             handler->onReceive(state);
+            CurrentProfileData.CountPacketTime(packetId, GetPreciseSysTimeMicro() - iPacketStart);
         }
         else
         {
@@ -386,6 +386,14 @@ void CNetworkManager::processAllOutput(void)
     // process network output
     ADDTOCALLSTACK("CNetworkManager::processAllOutput");
 
+    // hand the packets queued during this tick over to the network threads, they send them while the next tick runs
+    for (int i = 0; i < m_stateCount; ++i)
+    {
+        CNetState* state = m_states[i];
+        if (state->m_outgoing.tickQueuePending)
+            CNetworkOutput::QueueTickTransactions(state);
+    }
+
     if (isOutputThreaded() == false) // Don't do this if the output is multi threaded, since the CNetworkThread ticks automatically by itself
     {
         // force each thread to process output (NOT THREADSAFE)
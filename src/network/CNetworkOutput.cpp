@@ -170,7 +170,8 @@ size_t CNetworkOutput::flush(CNetState* state)
 	if (m_thread->isActive() && m_thread->isCurrentThread() == false)
 	{
 		// when this isn't the active thread, all we can do is raise a request to flush this
-		// client later
+		// client later (with the packets queued so far in this tick, to keep them in order)
+		QueueTickTransactions(state);
 		state->markFlush(true);
 		if (m_thread->getPriority() == IThread::Disabled)
 			m_thread->awaken();
@@ -457,6 +458,8 @@ bool CNetworkOutput::sendPacketData(CNetState* state, PacketSend* packet)
 		processByteQueue(state);
 	}
 
+	CurrentProfileData.CountPacket(true, *packet->getData());
+
 	EXC_SET_BLOCK("sent trigger");
 	packet->onSent(client);
 	delete packet;
@@ -625,6 +628,54 @@ void CNetworkOutput::QueuePacketTransaction(PacketTransaction* transaction)
 		return;
 	}
 
+	CNetworkThread* thread = state->getParentThread();
+	if (thread != nullptr && thread->isActive() && thread->isCurrentThread() == false)
+	{
+		// the network thread may still be sending the packets of the previous tick: keep this tick's ones
+		// aside and hand them over all together at the end of the tick (or when the client is flushed)
+		state->m_outgoing.tickQueue.push_back(transaction);
+		state->m_outgoing.tickQueuePending = true;
+		return;
+	}
+
+	pushTransaction(state, transaction);
+
+	// notify thread
+	if (thread != nullptr && thread->getPriority() == IThread::Disabled)
+		thread->awaken();
+}
+
+void CNetworkOutput::QueueTickTransactions(CNetState* state)
+{
+	// hand the transactions queued during this tick over to the network thread
+	ADDTOCALLSTACK("CNetworkOutput::QueueTickTransactions");
+	ASSERT(state != nullptr);
+
+	if (state->m_outgoing.tickQueue.empty())
+		return;
+
+	for (PacketTransaction* transaction : state->m_outgoing.tickQueue)
+	{
+		// the state may have been closed since the transaction was queued
+		if (state->isInUse() == false || state->isWriteClosed())
+		{
+			delete transaction;
+			continue;
+		}
+		pushTransaction(state, transaction);
+	}
+	state->m_outgoing.tickQueue.clear();
+	state->m_outgoing.tickQueuePending = false;
+
+	// notify thread, once for the whole tick
+	CNetworkThread* thread = state->getParentThread();
+	if (thread != nullptr && thread->getPriority() == IThread::Disabled)
+		thread->awaken();
+}
+
+void CNetworkOutput::pushTransaction(CNetState* state, PacketTransaction* transaction)
+{
+	// add a transaction to the packet queue of its priority
 	int priority = transaction->getPriority();
 	ASSERT(priority >= PacketSend::PRI_IDLE && priority < PacketSend::PRI_QTY);
 
@@ -640,9 +691,4 @@ void CNetworkOutput::QueuePacketTransaction(PacketTransaction* transaction)
 	}
 
 	state->m_outgoing.queue[priority].push(transaction);
-
-	// notify thread
-	CNetworkThread* thread = state->getParentThread();
-	if (thread != nullptr && thread->getPriority() == IThread::Disabled)
-		thread->awaken();
 }
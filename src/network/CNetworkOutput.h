@@ -41,6 +41,10 @@ public:
 
 	static void QueuePacket(PacketSend* packet, bool appendTransaction);// queue a packet for sending
 	static void QueuePacketTransaction(PacketTransaction* transaction);	// queue a packet transaction for sending
+	static void QueueTickTransactions(CNetState* state);				// hand the transactions queued during this tick over to the network thread
+
+private:
+	static void pushTransaction(CNetState* state, PacketTransaction* transaction);	// add a transaction to the packet queue of its priority
 
 private:
 	void checkFlushRequests(void);										// check for clients who need data flushing
@@ -4,6 +4,8 @@
 #include "ProfileData.h"
 #include "threads.h"
 
+bool ProfileData::sm_fMetrics = false;
+
 ProfileData::ProfileData()
 {
 	// we don't want to use SetActive here because ADDTOCALLSTACK will cause an infinite loop
@@ -16,10 +18,7 @@ ProfileData::ProfileData()
 	m_iActiveWindowSeconds = 10 * 1000; // expressed in milliseconds
 	m_iAverageCount = 1;
 
-	llong llTicksStart;
-	TIME_PROFILE_START;
-
-	m_CurrentTime = llTicksStart;
+	m_CurrentTime = GetPreciseSysTimeMilli();
 	m_CurrentTask = PROFILE_IDLE;
 	m_TimeTotal = 0;
 }
@@ -43,10 +42,7 @@ void ProfileData::SetActive(int iSampleSec)
 	if (m_iActiveWindowSeconds == 0)
 		return;
 
-	llong llTicksStart;
-	TIME_PROFILE_START;
-
-	m_CurrentTime = llTicksStart;
+	m_CurrentTime = GetPreciseSysTimeMilli();
 	m_CurrentTask = PROFILE_OVERHEAD;
 	m_TimeTotal = 0;
 }
@@ -54,14 +50,14 @@ void ProfileData::SetActive(int iSampleSec)
 void ProfileData::Start(PROFILE_TYPE id)
 {
 	// ADDTOCALLSTACK("ProfileData::Start"); // CPU intensive
-	if (( id >= PROFILE_TIME_QTY ) || !m_iActiveWindowSeconds )
+	if (( id >= PROFILE_TIME_QTY ) || !( m_iActiveWindowSeconds || sm_fMetrics ))
 		return;
 
 	// ensure profile is enabled
 	EnableProfile(id);
 
 	// Stop prev task.
-	if ( m_TimeTotal >= m_iActiveWindowSeconds )
+	if ( m_iActiveWindowSeconds && (m_TimeTotal >= m_iActiveWindowSeconds) )
 	{
 		for ( int i = 0; i < PROFILE_DATA_QTY; ++i )
 		{
@@ -91,8 +87,7 @@ void ProfileData::Start(PROFILE_TYPE id)
 	}
 
 	// Get the current precise time.
-	llong llTicksStart;
-	TIME_PROFILE_START;
+	const llong llTicksStart = GetPreciseSysTimeMilli();
 
 	// accumulate the time for this task.
 	llong llDiff = ( llTicksStart - m_CurrentTime );
@@ -101,6 +96,8 @@ void ProfileData::Start(PROFILE_TYPE id)
     ASSERT(m_TimeTotal >= 0);
 	m_CurrentTimes[m_CurrentTask].m_Time += llDiff;
 	++ m_CurrentTimes[m_CurrentTask].m_iCount;
+	m_TotalTimes[m_CurrentTask].Add((ullong)llDiff);
+	m_TotalCounts[m_CurrentTask].Add(1);
 
 	// We are now on to the new task.
 	m_CurrentTime = llTicksStart;
@@ -114,6 +111,8 @@ void ProfileData::Count(PROFILE_TYPE id, dword dwVal)
 	ASSERT( id >= PROFILE_TIME_QTY && id < PROFILE_QTY );
 	m_CurrentTimes[id].m_Time += dwVal;
 	++ m_CurrentTimes[id].m_iCount;
+	m_TotalTimes[id].Add(dwVal);
+	m_TotalCounts[id].Add(1);
 }
 
 bool ProfileData::IsEnabled(PROFILE_TYPE id) const
@@ -162,6 +161,7 @@ lpctstr ProfileData::GetName(PROFILE_TYPE id) const
 		"MAP",
         "MULTIS",
 		"NPC_AI",
+		"NPC_AI_LOD",
 		"SCRIPTS",
         "SECTORS",
         "SHIPS",
@@ -169,7 +169,8 @@ lpctstr ProfileData::GetName(PROFILE_TYPE id) const
         "TIMERS",
 		"DATA_TX",
 		"DATA_RX",
-		"FAULTS"
+		"FAULTS",
+		"NPC_AI_FROZEN"
 	};
 
 	return (id < PROFILE_QTY) ? sm_pszProfileName[id] : "";
@@ -7,6 +7,9 @@
 #define _INC_PROFILEDATA_H
 
 #include "../common/common.h"
+#include <atomic>
+
+#define PROFILE_PACKET_IDS	0x100	// Packet ids counted by the metrics (one byte).
 
 enum PROFILE_TYPE : uchar
 {
@@ -20,6 +23,7 @@ enum PROFILE_TYPE : uchar
 	PROFILE_MAP,		// reading map data
     PROFILE_MULTIS,     // Multi's stuff
 	PROFILE_NPC_AI,		// processing npc ai
+	PROFILE_NPC_AI_LOD,	// processing npc ai at a reduced level of detail (out of players view)
 	PROFILE_SCRIPTS,	// running scripts
     PROFILE_SECTORS,    // sector stuff
     PROFILE_SHIPS,      // sips moving
@@ -33,10 +37,32 @@ enum PROFILE_TYPE : uchar
 	PROFILE_DATA_QTY,
 
 	PROFILE_STAT_FAULTS = PROFILE_DATA_QTY,	// exceptions raised
+	PROFILE_STAT_NPC_AI_FROZEN,				// npc ai ticks skipped because no player is nearby
 
 	PROFILE_QTY
 };
 
+class ProfileMetricCounter
+{
+	// Monotonic counter written by a single thread and read by any other one (the metrics exporter).
+	// With a single writer a relaxed load and store are enough: no locked instruction on the hot path.
+	std::atomic<ullong> _uiValue;
+
+public:
+	ProfileMetricCounter() noexcept : _uiValue(0) {}
+
+	void Add(ullong uiVal) noexcept {
+		_uiValue.store(_uiValue.load(std::memory_order_relaxed) + uiVal, std::memory_order_relaxed);
+	}
+	ullong Get() const noexcept {
+		return _uiValue.load(std::memory_order_relaxed);
+	}
+
+private:
+	ProfileMetricCounter(const ProfileMetricCounter& copy);
+	ProfileMetricCounter& operator=(const ProfileMetricCounter& other);
+};
+
 class ProfileData
 {
 protected:
@@ -60,6 +86,16 @@ protected:
 	PROFILE_TYPE  m_CurrentTask;	// What task are we currently processing ?
 	llong m_CurrentTime;			// in milliseconds
 
+	// Totals since the start, never reset: msecs for the time profiles, bytes or instances for the others.
+	// Written by the owner thread only, read by the metrics exporter thread.
+	ProfileMetricCounter m_TotalTimes[PROFILE_QTY];
+	ProfileMetricCounter m_TotalCounts[PROFILE_QTY];
+	ProfileMetricCounter m_TotalPackets[2][PROFILE_PACKET_IDS];	// [0] received, [1] sent
+	ProfileMetricCounter m_TotalPacketMicros[PROFILE_PACKET_IDS];	// Time spent handling the received packets, in usecs.
+
+public:
+	static bool sm_fMetrics;	// Keep the totals even when the sample window is off.
+
 public:
 	ProfileData();
 
@@ -76,12 +112,31 @@ public:
 	void SetActive(int iSampleSec);
 	void Start(PROFILE_TYPE id);
 	void Count(PROFILE_TYPE id, dword dwVal);
+	void CountPacket(bool fSent, byte bPacketId) noexcept {
+		m_TotalPackets[fSent ? 1 : 0][bPacketId].Add(1);
+	}
+	void CountPacketTime(byte bPacketId, llong iMicro) noexcept {
+		m_TotalPacketMicros[bPacketId].Add((ullong)iMicro);
+	}
 	void EnableProfile(PROFILE_TYPE id);
 
 	PROFILE_TYPE GetCurrentTask() const;
 	lpctstr GetName(PROFILE_TYPE id) const;
 	lpctstr GetDescription(PROFILE_TYPE id) const;
 	bool IsEnabled(PROFILE_TYPE id = PROFILE_QTY) const;
+
+	ullong GetTotalTime(PROFILE_TYPE id) const noexcept {
+		return m_TotalTimes[id].Get();
+	}
+	ullong GetTotalCount(PROFILE_TYPE id) const noexcept {
+		return m_TotalCounts[id].Get();
+	}
+	ullong GetTotalPackets(bool fSent, byte bPacketId) const noexcept {
+		return m_TotalPackets[fSent ? 1 : 0][bPacketId].Get();
+	}
+	ullong GetTotalPacketTime(byte bPacketId) const noexcept {
+		return m_TotalPacketMicros[bPacketId].Get();
+	}
 };
 
 #endif // _INC_PROFILEDATA_H
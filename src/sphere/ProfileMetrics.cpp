@@ -0,0 +1,206 @@
+#include "../common/sphere_library/CSFileText.h"
+#include "../common/CLog.h"
+#include "../game/CServerConfig.h"
+#include "../game/CServerTime.h"
+#include "ProfileMetrics.h"
+#include <cstdio>
+
+CServerMetrics g_ServerMetrics;
+CMetricsExporter g_MetricsExporter;
+
+const llong ProfileMetricHistogram::sm_iBoundsMicro[METRICS_HISTOGRAM_BOUNDS] =
+{
+	100, 250, 500, 1000, 2000, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+	1000000, 2500000, 5000000, 10000000, 30000000
+};
+
+
+//*******************************************************
+// ProfileMetricHistogram
+
+void ProfileMetricHistogram::Add( llong iMicro ) noexcept
+{
+	uint uiBucket = 0;
+	while ( (uiBucket < METRICS_HISTOGRAM_BOUNDS) && (iMicro > sm_iBoundsMicro[uiBucket]) )
+		++uiBucket;
+
+	_uiBuckets[uiBucket].Add(1);
+	_uiSumMicro.Add((ullong)maximum(iMicro, 0));
+}
+
+void ProfileMetricHistogram::Write( CSFileText * pFile, lpctstr pszName, lpctstr pszHelp, lpctstr pszTimestamp ) const
+{
+	// The buckets are read one by one while the main thread may be adding: a snapshot can be off by a sample,
+	// the next one will be right.
+	pFile->Printf("# TYPE %s histogram\n# UNIT %s seconds\n# HELP %s %s\n", pszName, pszName, pszName, pszHelp);
+
+	ullong uiCumulative = 0;
+	for ( uint i = 0; i < METRICS_HISTOGRAM_BOUNDS; ++i )
+	{
+		uiCumulative += _uiBuckets[i].Get();
+		pFile->Printf("%s_bucket{le=\"%g\"} %llu %s\n", pszName, sm_iBoundsMicro[i] / 1000000.0, uiCumulative, pszTimestamp);
+	}
+	uiCumulative += _uiBuckets[METRICS_HISTOGRAM_BOUNDS].Get();
+	pFile->Printf("%s_bucket{le=\"+Inf\"} %llu %s\n", pszName, uiCumulative, pszTimestamp);
+	pFile->Printf("%s_sum %.6f %s\n", pszName, _uiSumMicro.Get() / 1000000.0, pszTimestamp);
+	pFile->Printf("%s_count %llu %s\n", pszName, uiCumulative, pszTimestamp);
+}
+
+
+//*******************************************************
+// CMetricsExporter
+
+CMetricsExporter::CMetricsExporter() : AbstractSphereThread("T_Metrics", IThread::Low),
+	_iTimeNext(0)
+{
+}
+
+void CMetricsExporter::start()
+{
+	// The threads keep their profile totals from now on, even with the Profile sample window off.
+	ProfileData::sm_fMetrics = true;
+	_iTimeNext = GetPreciseSysTimeMilli() + (llong)g_Cfg._iMetricsInterval * MSECS_PER_SEC;
+	AbstractSphereThread::start();
+}
+
+void CMetricsExporter::tick()
+{
+	if ( g_Cfg._iMetricsInterval <= 0 )
+		return;
+
+	const llong iTimeNow = GetPreciseSysTimeMilli();
+	if ( iTimeNow < _iTimeNext )
+		return;
+	_iTimeNext = iTimeNow + (llong)g_Cfg._iMetricsInterval * MSECS_PER_SEC;
+
+	CSString sFilePath;
+	sFilePath.Format("%smetrics.prom", g_Log.GetLogDir());
+	if ( !Export(sFilePath.GetPtr()) )
+		g_Log.Event(LOGL_WARN, "Can't write the metrics to '%s'.\n", sFilePath.GetPtr());
+}
+
+bool CMetricsExporter::Export( lpctstr pszFilePath )
+{
+	ADDTOCALLSTACK("CMetricsExporter::Export");
+	// Written aside then renamed over the file, so a scraper never reads a partial exposition.
+	CSString sTempPath;
+	sTempPath.Format("%s.tmp", pszFilePath);
+	CSFileText fileMetrics;
+	if ( !fileMetrics.Open(sTempPath.GetPtr(), OF_CREATE|OF_WRITE|OF_TEXT) )
+		return false;
+
+	tchar szTimestamp[24];
+	snprintf(szTimestamp, sizeof(szTimestamp), "%lld", (llong)CSTime::GetCurrentTime().GetTime());
+
+	g_ServerMetrics.m_TickTime.Write(&fileMetrics, "sphere_tick_duration", "Duration of the main loop ticks.", szTimestamp);
+	g_ServerMetrics.m_TickLateness.Write(&fileMetrics, "sphere_tick_lateness", "Delay between the time a main loop iteration was due (timer, packet or MainLoopRate) and its start.", szTimestamp);
+	g_ServerMetrics.m_SaveTime.Write(&fileMetrics, "sphere_world_save_duration", "Duration of the world saves, from the start to the end.", szTimestamp);
+
+	fileMetrics.Printf("# TYPE sphere_timers_fired counter\n# HELP sphere_timers_fired Timeouts of items, chars and sectors.\n");
+	fileMetrics.Printf("sphere_timers_fired_total %llu %s\n", g_ServerMetrics.m_TimersFired.Get(), szTimestamp);
+	fileMetrics.Printf("# TYPE sphere_main_loop_deferred counter\n# HELP sphere_main_loop_deferred Main loop iterations postponing the low priority work to catch up.\n");
+	fileMetrics.Printf("sphere_main_loop_deferred_total %llu %s\n", g_ServerMetrics.m_LoopsDeferred.Get(), szTimestamp);
+	fileMetrics.Printf("# TYPE sphere_garbage_collections counter\n# HELP sphere_garbage_collections Garbage collections run.\n");
+	fileMetrics.Printf("sphere_garbage_collections_total %llu %s\n", g_ServerMetrics.m_GarbageCollections.Get(), szTimestamp);
+	fileMetrics.Printf("# TYPE sphere_garbage_deleted_objects counter\n# HELP sphere_garbage_deleted_objects Invalid objects deleted by the garbage collection.\n");
+	fileMetrics.Printf("sphere_garbage_deleted_objects_total %llu %s\n", g_ServerMetrics.m_GarbageDeleted.Get(), szTimestamp);
+
+	// Per thread ProfileData totals. The samples of a metric family must be contiguous, so each family loops on the threads.
+	const size_t uiThreads = ThreadHolder::getActiveThreads();
+
+	fileMetrics.Printf("# TYPE sphere_profile_time_seconds counter\n# HELP sphere_profile_time_seconds Time spent by each thread in each profile category.\n");
+	for ( size_t uiThread = 0; uiThread < uiThreads; ++uiThread )
+	{
+		const AbstractSphereThread * pThread = static_cast<const AbstractSphereThread *>(ThreadHolder::getThreadAt(uiThread));
+		if ( pThread == nullptr )
+			continue;
+		const ProfileData & profile = pThread->m_profile;
+		for ( int i = 0; i < PROFILE_TIME_QTY; ++i )
+		{
+			const PROFILE_TYPE id = static_cast<PROFILE_TYPE>(i);
+			if ( profile.GetTotalCount(id) == 0 )
+				continue;
+			fileMetrics.Printf("sphere_profile_time_seconds_total{thread=\"%s\",category=\"%s\"} %.3f %s\n",
+				pThread->getName(), profile.GetName(id), profile.GetTotalTime(id) / 1000.0, szTimestamp);
+		}
+	}
+
+	fileMetrics.Printf("# TYPE sphere_network_bytes counter\n# HELP sphere_network_bytes Bytes received and sent by each thread.\n");
+	for ( size_t uiThread = 0; uiThread < uiThreads; ++uiThread )
+	{
+		const AbstractSphereThread * pThread = static_cast<const AbstractSphereThread *>(ThreadHolder::getThreadAt(uiThread));
+		if ( pThread == nullptr )
+			continue;
+		const ProfileData & profile = pThread->m_profile;
+		if ( profile.GetTotalCount(PROFILE_DATA_RX) )
+			fileMetrics.Printf("sphere_network_bytes_total{thread=\"%s\",direction=\"rx\"} %llu %s\n", pThread->getName(), profile.GetTotalTime(PROFILE_DATA_RX), szTimestamp);
+		if ( profile.GetTotalCount(PROFILE_DATA_TX) )
+			fileMetrics.Printf("sphere_network_bytes_total{thread=\"%s\",direction=\"tx\"} %llu %s\n", pThread->getName(), profile.GetTotalTime(PROFILE_DATA_TX), szTimestamp);
+	}
+
+	fileMetrics.Printf("# TYPE sphere_network_packets counter\n# HELP sphere_network_packets Game packets received and sent, by packet id.\n");
+	for ( size_t uiThread = 0; uiThread < uiThreads; ++uiThread )
+	{
+		const AbstractSphereThread * pThread = static_cast<const AbstractSphereThread *>(ThreadHolder::getThreadAt(uiThread));
+		if ( pThread == nullptr )
+			continue;
+		const ProfileData & profile = pThread->m_profile;
+		for ( uint uiPacket = 0; uiPacket < PROFILE_PACKET_IDS; ++uiPacket )
+		{
+			for ( int iSent = 0; iSent < 2; ++iSent )
+			{
+				const ullong uiPackets = profile.GetTotalPackets(iSent != 0, (byte)uiPacket);
+				if ( uiPackets == 0 )
+					continue;
+				fileMetrics.Printf("sphere_network_packets_total{thread=\"%s\",direction=\"%s\",packet=\"0x%02x\"} %llu %s\n",
+					pThread->getName(), iSent ? "out" : "in", uiPacket, uiPackets, szTimestamp);
+			}
+		}
+	}
+
+	fileMetrics.Printf("# TYPE sphere_network_packet_handling_seconds counter\n# HELP sphere_network_packet_handling_seconds Time spent handling the received game packets, by packet id (divided by sphere_network_packets_total it's the average server time per packet).\n");
+	for ( size_t uiThread = 0; uiThread < uiThreads; ++uiThread )
+	{
+		const AbstractSphereThread * pThread = static_cast<const AbstractSphereThread *>(ThreadHolder::getThreadAt(uiThread));
+		if ( pThread == nullptr )
+			continue;
+		const ProfileData & profile = pThread->m_profile;
+		for ( uint uiPacket = 0; uiPacket < PROFILE_PACKET_IDS; ++uiPacket )
+		{
+			if ( profile.GetTotalPackets(false, (byte)uiPacket) == 0 )
+				continue;
+			fileMetrics.Printf("sphere_network_packet_handling_seconds_total{thread=\"%s\",packet=\"0x%02x\"} %.6f %s\n",
+				pThread->getName(), uiPacket, profile.GetTotalPacketTime((byte)uiPacket) / 1000000.0, szTimestamp);
+		}
+	}
+
+	fileMetrics.Printf("# TYPE sphere_events counter\n# HELP sphere_events Exceptions raised and npc ai ticks skipped, by thread.\n");
+	for ( size_t uiThread = 0; uiThread < uiThreads; ++uiThread )
+	{
+		const AbstractSphereThread * pThread = static_cast<const AbstractSphereThread *>(ThreadHolder::getThreadAt(uiThread));
+		if ( pThread == nullptr )
+			continue;
+		const ProfileData & profile = pThread->m_profile;
+		for ( int i = PROFILE_DATA_QTY; i < PROFILE_QTY; ++i )
+		{
+			const PROFILE_TYPE id = static_cast<PROFILE_TYPE>(i);
+			if ( profile.GetTotalCount(id) == 0 )
+				continue;
+			fileMetrics.Printf("sphere_events_total{thread=\"%s\",event=\"%s\"} %llu %s\n",
+				pThread->getName(), profile.GetName(id), profile.GetTotalTime(id), szTimestamp);
+		}
+	}
+
+	fileMetrics.Printf("# EOF\n");
+	fileMetrics.Close();
+
+#ifdef _WIN32
+	remove(pszFilePath);	// rename doesn't replace an existing file here.
+#endif
+	if ( rename(sTempPath.GetPtr(), pszFilePath) )
+	{
+		remove(sTempPath.GetPtr());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,77 @@
+/**
+* @file ProfileMetrics.h
+* @brief Server metrics (tick duration distribution, timers, GC, saves) and their periodic export,
+*	with the per-thread ProfileData totals, to a rotating file in the OpenMetrics text format.
+*/
+
+#ifndef _INC_PROFILEMETRICS_H
+#define _INC_PROFILEMETRICS_H
+
+#include "ProfileData.h"
+#include "threads.h"
+
+class CSFileText;
+
+#define METRICS_HISTOGRAM_BOUNDS	17
+
+
+class ProfileMetricHistogram
+{
+	// Distribution of durations over fixed buckets (OpenMetrics histogram), written by a single thread.
+private:
+	static const llong sm_iBoundsMicro[METRICS_HISTOGRAM_BOUNDS];
+
+	ProfileMetricCounter _uiBuckets[METRICS_HISTOGRAM_BOUNDS + 1];	// Not cumulative, the last one is +Inf.
+	ProfileMetricCounter _uiSumMicro;
+
+public:
+	ProfileMetricHistogram() = default;
+private:
+	ProfileMetricHistogram(const ProfileMetricHistogram& copy);
+	ProfileMetricHistogram& operator=(const ProfileMetricHistogram& other);
+
+public:
+	void Add( llong iMicro ) noexcept;
+	void Write( CSFileText * pFile, lpctstr pszName, lpctstr pszHelp, lpctstr pszTimestamp ) const;
+};
+
+struct CServerMetrics
+{
+	// Metrics of the main thread, which is the only one writing them.
+	ProfileMetricHistogram m_TickTime;		// Duration of the whole Sphere_OnTick.
+	ProfileMetricHistogram m_TickLateness;	// How late the main loop iterations started, compared to when they were due.
+	ProfileMetricCounter m_LoopsDeferred;	// Main loop iterations which postponed the low priority work, being late.
+	ProfileMetricHistogram m_SaveTime;		// From the start to the end of a world save.
+	ProfileMetricCounter m_TimersFired;		// Timed objects (items, chars, sectors...) elapsed.
+	ProfileMetricCounter m_GarbageCollections;
+	ProfileMetricCounter m_GarbageDeleted;	// Objects deleted by the garbage collection.
+};
+
+extern CServerMetrics g_ServerMetrics;
+
+
+class CMetricsExporter : public AbstractSphereThread
+{
+	// Every MetricsInterval seconds, replaces metrics.prom in the log folder with a snapshot of the metrics.
+	// The snapshot is a complete OpenMetrics exposition ending with "# EOF", its samples carry the snapshot time.
+private:
+	llong _iTimeNext;	// Real time of the next export, in msecs.
+
+public:
+	CMetricsExporter();
+	~CMetricsExporter() = default;
+private:
+	CMetricsExporter(const CMetricsExporter& copy);
+	CMetricsExporter& operator=(const CMetricsExporter& other);
+
+public:
+	virtual void start() override;
+	virtual void tick() override;
+
+	bool Export( lpctstr pszFilePath );
+};
+
+extern CMetricsExporter g_MetricsExporter;
+
+
+#endif // _INC_PROFILEMETRICS_H
@@ -0,0 +1,208 @@
+#include "../common/sphere_library/CSFileText.h"
+#include "../common/CLog.h"
+#include "../game/CServerConfig.h"
+#include "TickWatchdog.h"
+#include <algorithm>
+
+CTickWatchdog g_TickWatchdog;
+CStackSampler g_StackSampler;
+
+thread_local bool CTickWatchdog::sm_fRecording = false;
+
+static lpctstr const sm_szTickUnitNames[TICKUNIT_QTY] =
+{
+	"timer",
+	"periodic",
+	"trigger",
+	"function",
+	"packet"
+};
+
+
+//*******************************************************
+// CTickWatchdog
+
+CTickWatchdog::CTickWatchdog() : _iTickStart(0), _dwSlowTicks(0)
+{
+}
+
+void CTickWatchdog::BeginTick()
+{
+	sm_fRecording = (g_Cfg._iTickBudget > 0);
+	if ( !sm_fRecording )
+		return;
+	_vTop.clear();
+	_iTickStart = GetPreciseSysTimeMicro();
+}
+
+void CTickWatchdog::EndTick()
+{
+	if ( !sm_fRecording )
+		return;
+	sm_fRecording = false;
+
+	const llong iTickMicro = GetPreciseSysTimeMicro() - _iTickStart;
+	if ( iTickMicro > (llong)g_Cfg._iTickBudget * 1000 )
+	{
+		++_dwSlowTicks;
+		_LogSlowTick(iTickMicro);
+	}
+}
+
+void CTickWatchdog::_AddUnit( llong iMicro, TICKUNIT_TYPE type, dword dwUID, int iDetail, const char * pszFunction, lpctstr pszName )
+{
+	// Keep only the slowest ones. The list is short, a linear search for the fastest is enough.
+	const size_t uiMax = (size_t)g_Cfg._iTickBudgetTopN;
+	TickUnitRecord * pRecord;
+	if ( _vTop.size() < uiMax )
+	{
+		_vTop.emplace_back();
+		pRecord = &_vTop.back();
+	}
+	else
+	{
+		std::vector<TickUnitRecord>::iterator itMin = std::min_element(_vTop.begin(), _vTop.end(),
+			[](const TickUnitRecord & rec1, const TickUnitRecord & rec2) { return rec1.iMicro < rec2.iMicro; });
+		if ( (itMin == _vTop.end()) || (itMin->iMicro >= iMicro) )
+			return;
+		pRecord = &(*itMin);
+	}
+
+	pRecord->iMicro = iMicro;
+	pRecord->type = type;
+	pRecord->dwUID = dwUID;
+	pRecord->iDetail = iDetail;
+	pRecord->pszFunction = pszFunction;
+	Str_CopyLimitNull(pRecord->szName, pszName ? pszName : "", sizeof(pRecord->szName));
+}
+
+void CTickWatchdog::_LogSlowTick( llong iTickMicro )
+{
+	g_Log.Event(LOGL_WARN, "Tick took %lld ms (TickBudget is %d ms), its most expensive units of work are logged in slowticks.log.\n",
+		iTickMicro / 1000, g_Cfg._iTickBudget);
+
+	CSFileText fileLog;
+	CSString sFilePath;
+	sFilePath.Format("%sslowticks.log", g_Log.GetLogDir());
+	if ( !fileLog.Open(sFilePath.GetPtr(), OF_SHARE_DENY_NONE|OF_READWRITE|OF_TEXT) )
+		return;
+
+	std::sort(_vTop.begin(), _vTop.end(),
+		[](const TickUnitRecord & rec1, const TickUnitRecord & rec2) { return rec1.iMicro > rec2.iMicro; });
+
+	fileLog.Printf("%s Tick took %.3f ms (budget %d ms). Slowest units of work (nested ones are included in the outer ones):\n",
+		CSTime::GetCurrentTime().Format("%Y/%m/%d %H:%M:%S"), iTickMicro / 1000.0, g_Cfg._iTickBudget);
+	for ( const TickUnitRecord & rec : _vTop )
+	{
+		tchar szDetail[32] = "";
+		if ( rec.iDetail >= 0 )
+		{
+			if ( rec.type == TICKUNIT_PACKET )
+				snprintf(szDetail, sizeof(szDetail), " packet=0x%02x", rec.iDetail);
+			else
+				snprintf(szDetail, sizeof(szDetail), " sector=%d", rec.iDetail);
+		}
+		fileLog.Printf("\t%9.3f ms  %-8s %-32s uid=0%08x%s%s%s\n",
+			rec.iMicro / 1000.0,
+			sm_szTickUnitNames[rec.type],
+			rec.szName,
+			rec.dwUID,
+			szDetail,
+			rec.pszFunction ? " in " : "",
+			rec.pszFunction ? rec.pszFunction : "");
+	}
+	fileLog.Close();
+}
+
+
+//*******************************************************
+// TickWatchdogUnit
+
+TickWatchdogUnit::TickWatchdogUnit( TICKUNIT_TYPE type, dword dwUID, lpctstr pszName, int iDetail ) :
+	_iTimeStart(0), _type(type), _dwUID(dwUID), _iDetail(iDetail), _pszName(pszName), _pszFunction(nullptr)
+{
+	if ( !CTickWatchdog::IsRecording() )
+		return;
+#ifdef THREAD_TRACK_CALLSTACK
+	_pszFunction = static_cast<AbstractSphereThread *>(ThreadHolder::current())->getStackTop();
+#endif
+	_iTimeStart = GetPreciseSysTimeMicro();
+}
+
+TickWatchdogUnit::~TickWatchdogUnit()
+{
+	if ( (_iTimeStart == 0) || !CTickWatchdog::IsRecording() )
+		return;
+	g_TickWatchdog._AddUnit(GetPreciseSysTimeMicro() - _iTimeStart, _type, _dwUID, _iDetail, _pszFunction, _pszName);
+}
+
+
+//*******************************************************
+// CStackSampler
+
+CStackSampler::CStackSampler() : AbstractSphereThread("StackSampler", IThread::Highest),
+	_pSampled(nullptr), _uiSamples(0)
+{
+}
+
+void CStackSampler::Start( const AbstractSphereThread * pSampled )
+{
+	_pSampled = pSampled;
+	AbstractSphereThread::start();
+}
+
+void CStackSampler::tick()
+{
+#ifdef THREAD_TRACK_CALLSTACK
+	if ( _pSampled == nullptr )
+		return;
+
+	const char * ppNames[STACKSAMPLER_MAX_DEPTH];
+	const size_t uiDepth = _pSampled->getStackSnapshot(ppNames, CountOf(ppNames));
+	if ( uiDepth == 0 )
+		return;		// Idle, between two ticks.
+
+	std::string sStack;
+	for ( size_t i = 0; i < uiDepth; ++i )
+	{
+		if ( i != 0 )
+			sStack += ';';
+		sStack += ppNames[i];
+	}
+
+	std::unique_lock<std::mutex> lock(_mutexStacks);
+	++_mapStacks[sStack];
+	++_uiSamples;
+#endif
+}
+
+void CStackSampler::waitForClose()
+{
+	const bool fWasActive = isActive();
+	AbstractSphereThread::waitForClose();
+	if ( fWasActive )
+	{
+		CSString sFilePath;
+		sFilePath.Format("%scallstack.folded", g_Log.GetLogDir());
+		Dump(sFilePath.GetPtr());
+	}
+}
+
+bool CStackSampler::Dump( lpctstr pszFilePath )
+{
+	CSFileText fileDump;
+	if ( !fileDump.Open(pszFilePath, OF_CREATE|OF_WRITE|OF_TEXT) )
+		return false;
+
+	std::unique_lock<std::mutex> lock(_mutexStacks);
+	for ( const std::pair<const std::string, uint> & stack : _mapStacks )
+		fileDump.Printf("%s %u\n", stack.first.c_str(), stack.second);
+	fileDump.Close();
+	return true;
+}
+
+uint CStackSampler::GetSampleCount()
+{
+	std::unique_lock<std::mutex> lock(_mutexStacks);
+	return _uiSamples;
+}
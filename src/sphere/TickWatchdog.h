@@ -0,0 +1,149 @@
+/**
+* @file TickWatchdog.h
+* @brief Logging of the most expensive units of work done in the ticks lasting longer than TickBudget,
+*	and sampling of the main thread call stack for flame graphs.
+*/
+
+#ifndef _INC_TICKWATCHDOG_H
+#define _INC_TICKWATCHDOG_H
+
+#include "threads.h"
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define TICKWATCHDOG_MAX_UNITS		64	// Max units of work logged for a slow tick.
+#define TICKWATCHDOG_NAME_LENGTH	48
+#define STACKSAMPLER_MAX_DEPTH		64	// Deeper frames are not sampled.
+
+
+enum TICKUNIT_TYPE
+{
+	TICKUNIT_TIMER,		// Timeout of an item, char, sector... (CWorldTicker)
+	TICKUNIT_PERIODIC,	// Periodic char tick
+	TICKUNIT_TRIGGER,
+	TICKUNIT_FUNCTION,
+	TICKUNIT_PACKET,	// Received packet
+	TICKUNIT_QTY
+};
+
+class CTickWatchdog
+{
+	// Keeps the most expensive units of work of the current tick, and logs them if the tick goes over budget.
+	// Only the main thread records: the network threads and the others don't take part in the tick time.
+	friend class TickWatchdogUnit;
+
+private:
+	struct TickUnitRecord
+	{
+		llong iMicro;			// Execution time, including the nested units.
+		TICKUNIT_TYPE type;
+		dword dwUID;			// Object doing the work, if any.
+		int iDetail;			// Packet id (TICKUNIT_PACKET) or sector index (TICKUNIT_TIMER), -1 if none.
+		const char * pszFunction;	// Innermost ADDTOCALLSTACK function when the unit began (if the call stack is tracked).
+		tchar szName[TICKWATCHDOG_NAME_LENGTH];	// Trigger/function name, or the kind of timer.
+	};
+
+	std::vector<TickUnitRecord> _vTop;
+	llong _iTickStart;
+	dword _dwSlowTicks;
+
+	static thread_local bool sm_fRecording;
+
+public:
+	CTickWatchdog();
+	~CTickWatchdog() = default;
+private:
+	CTickWatchdog(const CTickWatchdog& copy);
+	CTickWatchdog& operator=(const CTickWatchdog& other);
+
+private:
+	void _AddUnit( llong iMicro, TICKUNIT_TYPE type, dword dwUID, int iDetail, const char * pszFunction, lpctstr pszName );
+	void _LogSlowTick( llong iTickMicro );
+
+public:
+	// To be called by the main thread around each tick.
+	void BeginTick();
+	void EndTick();
+
+	static bool IsRecording()
+	{
+		return sm_fRecording;
+	}
+	dword GetSlowTicks() const
+	{
+		return _dwSlowTicks;
+	}
+};
+
+extern CTickWatchdog g_TickWatchdog;
+
+
+// Measures a unit of work of the current tick (no-op if the watchdog is off or this isn't the main thread).
+// pszName must be valid until the unit ends.
+class TickWatchdogUnit
+{
+private:
+	llong _iTimeStart;
+	TICKUNIT_TYPE _type;
+	dword _dwUID;
+	int _iDetail;
+	lpctstr _pszName;
+	const char * _pszFunction;
+
+public:
+	TickWatchdogUnit( TICKUNIT_TYPE type, dword dwUID, lpctstr pszName, int iDetail = -1 );
+	~TickWatchdogUnit();
+
+	void SetName( lpctstr pszName )
+	{
+		_pszName = pszName;
+	}
+	void SetUID( dword dwUID )
+	{
+		_dwUID = dwUID;
+	}
+	void SetDetail( int iDetail )
+	{
+		_iDetail = iDetail;
+	}
+
+private:
+	TickWatchdogUnit(const TickWatchdogUnit& copy);
+	TickWatchdogUnit& operator=(const TickWatchdogUnit& other);
+};
+
+
+class CStackSampler : public AbstractSphereThread
+{
+	// Copies the call stack of the sampled thread every few msecs and counts how many times each stack was seen.
+	// The stack is read while the sampled thread runs: a sample taken during a call or a return may miss a frame,
+	// which is fine for a statistical profile.
+private:
+	const AbstractSphereThread * _pSampled;
+	std::mutex _mutexStacks;
+	std::unordered_map<std::string, uint> _mapStacks;	// "func1;func2;func3" -> samples
+	uint _uiSamples;
+
+public:
+	CStackSampler();
+	~CStackSampler() = default;
+private:
+	CStackSampler(const CStackSampler& copy);
+	CStackSampler& operator=(const CStackSampler& other);
+
+public:
+	void Start( const AbstractSphereThread * pSampled );
+	virtual void tick() override;
+	virtual void waitForClose() override;
+
+	// Write the samples in the folded stacks format (one "frame1;frame2;... count" line per distinct stack).
+	bool Dump( lpctstr pszFilePath );
+	uint GetSampleCount();
+};
+
+extern CStackSampler g_StackSampler;
+
+
+#endif // _INC_TICKWATCHDOG_H
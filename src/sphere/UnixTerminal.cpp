@@ -23,7 +23,8 @@ UnixTerminal::UnixTerminal() : AbstractSphereThread("T_UnixTerm", IThread::Highe
 UnixTerminal::~UnixTerminal()
 {
     ConsoleInterface::_ciQueueCV.notify_one();  // tell to the condition variable to stop waiting, it's time to exit
-	restore();
+	if (m_prepared)	// The thread may have never been started (or failed to prepare the terminal).
+		restore();
     //_thread_selfTerminateAfterThisTick = true;  // just to be sure
 }
 
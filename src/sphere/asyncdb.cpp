@@ -1,4 +1,6 @@
 
+#include "../common/sqlite/SQLite.h"
+#include "../common/sqlite/sqlite3.h"
 #include "../common/CScriptObj.h"
 #include "../common/CScriptTriggerArgs.h"
 #include "../game/triggers.h"
@@ -6,6 +8,7 @@
 #include "asyncdb.h"
 
 CDataBaseAsyncHelper g_asyncHdb;
+CSQLiteAsyncHelper g_asyncLdb;
 
 CDataBaseAsyncHelper::CDataBaseAsyncHelper(void) : AbstractSphereThread("AsyncDatabaseHelper", IThread::Low)
 {
@@ -63,3 +66,90 @@ void CDataBaseAsyncHelper::addQuery(bool isQuery, lpctstr sFunction, lpctstr sQu
 
 	m_queriesTodo.emplace_back( QueryBlob_t(isQuery, FunctionQueryPair_t(CSString(sFunction), CSString(sQuery))) );
 }
+
+
+CSQLiteAsyncHelper::CSQLiteAsyncHelper(void) : AbstractSphereThread("AsyncSQLiteHelper", IThread::Low)
+{
+}
+
+void CSQLiteAsyncHelper::tick()
+{
+	_ProcessQueries(true);
+}
+
+void CSQLiteAsyncHelper::waitForClose()
+{
+	AbstractSphereThread::waitForClose();
+
+	// Don't lose the queued writes, but nobody is going to handle the results now.
+	_ProcessQueries(false);
+}
+
+void CSQLiteAsyncHelper::addQuery(CSQLite * pDb, bool fQuery, lpctstr sFunction, lpctstr sQuery, std::vector<CSString> && vArgs)
+{
+	SimpleThreadLock stlThelock(m_queryMutex);
+
+	m_queriesTodo.emplace_back( QueryBlob_t{pDb, fQuery, CSString(sFunction), CSString(sQuery), std::move(vArgs)} );
+}
+
+void CSQLiteAsyncHelper::_ProcessQueries(bool fReturnResults)
+{
+	QueueQuery_t queriesTodo;
+	{
+		SimpleThreadLock lock(m_queryMutex);
+		queriesTodo.swap(m_queriesTodo);
+	}
+
+	size_t uiCur = 0;
+	while ( uiCur < queriesTodo.size() )
+	{
+		CSQLite * pDb = queriesTodo[uiCur].pDb;
+		SimpleThreadLock lock(pDb->m_connectionMutex);
+
+		// Group the following writes to the same database, unless a transaction was opened by the scripts.
+		size_t uiEnd = uiCur + 1;
+		if ( !queriesTodo[uiCur].fQuery )
+		{
+			while ( (uiEnd < queriesTodo.size()) && ((uiEnd - uiCur) < SQLITE_ASYNC_BATCH) &&
+				(queriesTodo[uiEnd].pDb == pDb) && !queriesTodo[uiEnd].fQuery )
+			{
+				++uiEnd;
+			}
+		}
+		const bool fTransaction = ((uiEnd - uiCur) > 1) && pDb->IsOpen() && sqlite3_get_autocommit(pDb->GetPtr());
+		if ( fTransaction )
+			pDb->BeginTransaction();
+
+		for ( ; uiCur < uiEnd; ++uiCur )
+		{
+			QueryBlob_t & query = queriesTodo[uiCur];
+			if ( query.fQuery && !fReturnResults )
+				continue;
+
+			CScriptTriggerArgs * theArgs = nullptr;
+			if ( fReturnResults && !query.sFunction.IsEmpty() )
+			{
+				theArgs = new CScriptTriggerArgs();
+				theArgs->m_iN1 = query.fQuery;
+				theArgs->m_s1 = query.sQuery;
+			}
+
+			int iErr;
+			if ( query.fQuery )
+				iErr = pDb->QueryPrepared(query.sQuery, query.vArgs, theArgs->m_VarsLocal);
+			else
+				iErr = pDb->ExecutePrepared(query.sQuery, query.vArgs);
+
+			if ( theArgs )
+			{
+				theArgs->m_iN2 = (iErr == SQLITE_OK);
+				theArgs->m_iN3 = (!query.fQuery && (iErr == SQLITE_OK)) ? pDb->GetLastChangesCount() : 0;
+				pDb->addQueryResult(query.sFunction, theArgs);
+			}
+		}
+
+		// A failed statement may have rolled back the transaction already.
+		if ( fTransaction && !sqlite3_get_autocommit(pDb->GetPtr()) )
+			pDb->CommitTransaction();
+	}
+}
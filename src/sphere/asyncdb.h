@@ -8,6 +8,11 @@
 
 #include "../common/sphere_library/smutex.h"
 #include "threads.h"
+#include <vector>
+
+#define SQLITE_ASYNC_BATCH	512	// Max consecutive queued writes committed in a single transaction.
+
+class CSQLite;
 
 
 class CDataBaseAsyncHelper : public AbstractSphereThread
@@ -37,4 +42,44 @@ public:
 	void addQuery(bool isQuery, lpctstr sFunction, lpctstr sQuery);
 };
 
+
+class CSQLiteAsyncHelper : public AbstractSphereThread
+{
+	// Runs the AEXECUTE/AQUERY statements of the SQLite databases. Consecutive writes to the same database
+	// are grouped in a single transaction; the results are passed back to the main thread by CSQLite::OnTick.
+private:
+	struct QueryBlob_t
+	{
+		CSQLite * pDb;
+		bool fQuery;
+		CSString sFunction;
+		CSString sQuery;
+		std::vector<CSString> vArgs;
+	};
+	typedef std::deque<QueryBlob_t> QueueQuery_t;
+
+private:
+	SimpleMutex m_queryMutex;
+	QueueQuery_t m_queriesTodo;
+
+public:
+	CSQLiteAsyncHelper(void);
+	~CSQLiteAsyncHelper(void) = default;
+private:
+	CSQLiteAsyncHelper(const CSQLiteAsyncHelper& copy);
+	CSQLiteAsyncHelper& operator=(const CSQLiteAsyncHelper& other);
+
+public:
+	virtual void tick() override;
+	virtual void waitForClose() override;
+
+public:
+	void addQuery(CSQLite * pDb, bool fQuery, lpctstr sFunction, lpctstr sQuery, std::vector<CSString> && vArgs);
+
+private:
+	void _ProcessQueries(bool fReturnResults);
+};
+
+extern CSQLiteAsyncHelper g_asyncLdb;
+
 #endif // _INC_ASYNCDB_H
@@ -0,0 +1,158 @@
+#include "../common/CLog.h"
+#include "asynclog.h"
+
+CLogAsyncWriter g_asyncLog;
+
+CLogAsyncWriter::CLogAsyncWriter() : AbstractSphereThread("AsyncLogWriter", IThread::High),
+	_uiEnqueuePos(0), _uiDequeuePos(0), _uiDropped(0), _uiDroppedReported(0)
+{
+}
+
+void CLogAsyncWriter::start()
+{
+	// Allocate the queue only when needed.
+	if ( !_pRecords )
+	{
+		_pRecords.reset(new LogRecord[LOGASYNC_QUEUE_SIZE]);
+		for ( size_t i = 0; i < LOGASYNC_QUEUE_SIZE; ++i )
+			_pRecords[i].uiSeq.store(i, std::memory_order_relaxed);
+	}
+	AbstractSphereThread::start();
+}
+
+void CLogAsyncWriter::tick()
+{
+	_Drain();
+}
+
+void CLogAsyncWriter::waitForClose()
+{
+	// Give the thread a bounded time to write what's pending, then write the rest from here.
+	Flush(LOGASYNC_FLUSH_TIMEOUT);
+	AbstractSphereThread::waitForClose();
+	_Drain();
+}
+
+bool CLogAsyncWriter::Push( dword dwMask, const CSTime & datetime, lpctstr pszTime, lpctstr pszScriptContext, lpctstr pszMsg, bool fConsoleTime )
+{
+	if ( !_pRecords )
+		return false;
+	const size_t uiMsgLen = strlen(pszMsg);
+	if ( uiMsgLen >= LOGASYNC_MSG_LENGTH )
+		return false;
+
+	const size_t uiMask = LOGASYNC_QUEUE_SIZE - 1;
+	size_t uiPos = _uiEnqueuePos.load(std::memory_order_relaxed);
+	LogRecord * pRecord;
+	for (;;)
+	{
+		pRecord = &_pRecords[uiPos & uiMask];
+		const size_t uiSeq = pRecord->uiSeq.load(std::memory_order_acquire);
+		const ssize_t iDiff = (ssize_t)uiSeq - (ssize_t)uiPos;
+		if ( iDiff == 0 )
+		{
+			// The slot is free: reserve it.
+			if ( _uiEnqueuePos.compare_exchange_weak(uiPos, uiPos + 1, std::memory_order_relaxed) )
+				break;
+		}
+		else if ( iDiff < 0 )
+		{
+			// The queue is full: don't block the caller.
+			_uiDropped.fetch_add(1, std::memory_order_relaxed);
+			awaken();
+			return true;
+		}
+		else
+		{
+			uiPos = _uiEnqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	pRecord->dwMask = dwMask;
+	pRecord->fConsoleTime = fConsoleTime;
+	pRecord->datetime = datetime;
+	Str_CopyLimitNull(pRecord->szTime, pszTime, sizeof(pRecord->szTime));
+	Str_CopyLimitNull(pRecord->szScriptContext, pszScriptContext, sizeof(pRecord->szScriptContext));
+	memcpy(pRecord->szMsg, pszMsg, uiMsgLen + 1);
+	pRecord->uiSeq.store(uiPos + 1, std::memory_order_release);
+
+	if ( (uiPos - _uiDequeuePos.load(std::memory_order_relaxed)) >= (LOGASYNC_QUEUE_SIZE / 2) )
+		awaken();	// Getting full, don't wait for the next tick.
+	return true;
+}
+
+void CLogAsyncWriter::Flush( llong iTimeout )
+{
+	if ( !_pRecords )
+		return;
+	if ( isCurrentThread() )
+	{
+		_Drain();
+		return;
+	}
+
+	const size_t uiTarget = _uiEnqueuePos.load(std::memory_order_acquire);
+	const llong iTimeEnd = GetPreciseSysTimeMilli() + iTimeout;
+	while ( _uiDequeuePos.load(std::memory_order_acquire) < uiTarget )
+	{
+		if ( !isActive() || (GetPreciseSysTimeMilli() >= iTimeEnd) )
+			break;
+		awaken();
+		Sleep(1);
+	}
+}
+
+size_t CLogAsyncWriter::GetPendingCount() const
+{
+	return _uiEnqueuePos.load(std::memory_order_relaxed) - _uiDequeuePos.load(std::memory_order_relaxed);
+}
+
+uint CLogAsyncWriter::GetDroppedCount() const
+{
+	return _uiDropped.load(std::memory_order_relaxed);
+}
+
+size_t CLogAsyncWriter::_Drain()
+{
+	// Single consumer: only the writer thread (or the closing one, after the writer has ended) gets here.
+	if ( !_pRecords )
+		return 0;
+
+	const size_t uiMask = LOGASYNC_QUEUE_SIZE - 1;
+	size_t uiPos = _uiDequeuePos.load(std::memory_order_relaxed);
+	size_t uiWritten = 0;
+	for (;;)
+	{
+		LogRecord * pRecord = &_pRecords[uiPos & uiMask];
+		if ( pRecord->uiSeq.load(std::memory_order_acquire) != uiPos + 1 )
+			break;	// Empty, or the producer is still filling it.
+
+		if ( uiWritten == 0 )
+			g_Log.BeginEventBatch();
+		g_Log.OutputEvent(pRecord->dwMask, pRecord->datetime, pRecord->szTime, pRecord->szScriptContext, pRecord->szMsg, pRecord->fConsoleTime);
+		++uiWritten;
+
+		pRecord->uiSeq.store(uiPos + LOGASYNC_QUEUE_SIZE, std::memory_order_release);
+		++uiPos;
+		_uiDequeuePos.store(uiPos, std::memory_order_release);
+	}
+
+	const uint uiDropped = _uiDropped.load(std::memory_order_relaxed);
+	if ( uiDropped != _uiDroppedReported )
+	{
+		if ( uiWritten == 0 )
+			g_Log.BeginEventBatch();
+		tchar szMsg[128];
+		snprintf(szMsg, sizeof(szMsg), "Log queue full, %u messages were dropped (%u in total).\n", uiDropped - _uiDroppedReported, uiDropped);
+		const CSTime datetime = CSTime::GetCurrentTime();
+		tchar szTime[16];
+		snprintf(szTime, sizeof(szTime), "%02d:%02d:", datetime.GetHour(), datetime.GetMinute());
+		g_Log.OutputEvent(LOGL_WARN, datetime, szTime, "", szMsg, true);
+		_uiDroppedReported = uiDropped;
+		++uiWritten;
+	}
+
+	if ( uiWritten != 0 )
+		g_Log.EndEventBatch();
+	return uiWritten;
+}
@@ -0,0 +1,69 @@
+/**
+* @file asynclog.h
+* @brief Log messages written by a dedicated thread.
+*/
+
+#ifndef _INC_ASYNCLOG_H
+#define _INC_ASYNCLOG_H
+
+#include "../common/sphere_library/CSTime.h"
+#include "threads.h"
+#include <atomic>
+#include <memory>
+
+#define LOGASYNC_QUEUE_SIZE		2048	// Slots in the log ring, must be a power of 2.
+#define LOGASYNC_MSG_LENGTH		1024	// Longer messages are written directly by the calling thread.
+#define LOGASYNC_FLUSH_TIMEOUT	1000	// Max milliseconds to wait for the pending messages to be written.
+
+
+class CLogAsyncWriter : public AbstractSphereThread
+{
+	// Lock-free bounded queue with many producers (every thread using g_Log) and a single consumer (this thread).
+	// The messages are formatted by the caller, this thread does the console output and the log file append.
+private:
+	struct LogRecord
+	{
+		std::atomic<size_t> uiSeq;
+		dword dwMask;
+		bool fConsoleTime;
+		CSTime datetime;
+		tchar szTime[16];
+		tchar szScriptContext[_MAX_PATH + 16];
+		tchar szMsg[LOGASYNC_MSG_LENGTH];
+	};
+
+	std::unique_ptr<LogRecord[]> _pRecords;
+	std::atomic<size_t> _uiEnqueuePos;
+	std::atomic<size_t> _uiDequeuePos;
+
+	std::atomic<uint> _uiDropped;	// Messages lost because the queue was full.
+	uint _uiDroppedReported;
+
+public:
+	CLogAsyncWriter();
+	~CLogAsyncWriter() = default;
+private:
+	CLogAsyncWriter(const CLogAsyncWriter& copy);
+	CLogAsyncWriter& operator=(const CLogAsyncWriter& other);
+
+public:
+	virtual void start() override;
+	virtual void tick() override;
+	virtual void waitForClose() override;
+
+public:
+	// Queue a message. Returns false if it has to be written by the caller (too long), true if it was queued or dropped.
+	bool Push( dword dwMask, const CSTime & datetime, lpctstr pszTime, lpctstr pszScriptContext, lpctstr pszMsg, bool fConsoleTime );
+	// Wait for the messages queued until now to be written, for max iTimeout milliseconds.
+	void Flush( llong iTimeout );
+
+	size_t GetPendingCount() const;
+	uint GetDroppedCount() const;
+
+private:
+	size_t _Drain();
+};
+
+extern CLogAsyncWriter g_asyncLog;
+
+#endif // _INC_ASYNCLOG_H
@@ -23,6 +23,8 @@
 #define THREADJOIN_TIMEOUT	60000
 
 
+// Shared storage, used only by the dummy thread (see AbstractSphereThread::allocateBuffer)
+
 // Normal Buffer
 SimpleMutex g_tmpStringMutex;
 volatile int g_tmpStringIndex = 0;
@@ -32,11 +34,7 @@ char g_tmpStrings[THREAD_TSTRING_STORAGE][THREAD_STRING_LENGTH];
 SimpleMutex g_tmpTemporaryStringMutex;
 volatile int g_tmpTemporaryStringIndex = 0;
 
-struct TemporaryStringStorage
-{
-	char m_buffer[THREAD_STRING_LENGTH];
-	char m_state;
-} g_tmpTemporaryStringStorage[THREAD_STRING_STORAGE];
+TemporaryStringStorage g_tmpTemporaryStringStorage[THREAD_STRING_STORAGE];
 
 #ifdef _WIN32
 #pragma pack(push, 8)
@@ -524,27 +522,77 @@ AbstractSphereThread::AbstractSphereThread(const char *name, Priority priority)
     m_exceptionStackUnwinding = false;
 #endif
 
+	m_fSharedTempStorage = false;
+	m_iTempBufferQty = THREAD_TSTRING_STORAGE_AUX;
+	m_iTempBufferIndex = 0;
+	m_iTempStringQty = THREAD_STRING_STORAGE_AUX;
+	m_iTempStringIndex = 0;
+	m_iTempScopeDepth = 0;
+	m_iTempScopeAllocs = 0;
+
 	// profiles that apply to every thread
 	m_profile.EnableProfile(PROFILE_IDLE);
 	m_profile.EnableProfile(PROFILE_OVERHEAD);
 	m_profile.EnableProfile(PROFILE_STAT_FAULTS);
 }
 
-// IMHO we need a lock on allocateBuffer and allocateStringBuffer
+void AbstractSphereThread::setTempStorageSize(size_t iBuffers, size_t iStrings)
+{
+	ASSERT(!m_pTempBuffers && !m_pTempStrings);
+	m_iTempBufferQty = iBuffers;
+	m_iTempStringQty = iStrings;
+}
 
-char *AbstractSphereThread::allocateBuffer()
+void AbstractSphereThread::setSharedTempStorage()
 {
-	SimpleThreadLock stlBuffer(g_tmpStringMutex);
+	m_fSharedTempStorage = true;
+	m_iTempBufferQty = THREAD_TSTRING_STORAGE;
+	m_iTempStringQty = THREAD_STRING_STORAGE;
+}
 
+char *AbstractSphereThread::allocateBuffer()
+{
 	char * buffer = nullptr;
-	++g_tmpStringIndex;
+	if ( m_fSharedTempStorage )
+	{
+		SimpleThreadLock stlBuffer(g_tmpStringMutex);
+
+		++g_tmpStringIndex;
+
+		if( g_tmpStringIndex >= THREAD_TSTRING_STORAGE )
+		{
+			g_tmpStringIndex %= THREAD_TSTRING_STORAGE;
+		}
+
+		buffer = g_tmpStrings[g_tmpStringIndex];
+		*buffer = '\0';
 
-	if( g_tmpStringIndex >= THREAD_TSTRING_STORAGE )
+		return buffer;
+	}
+
+	// Only this thread uses its storage, no need to lock.
+	if ( !m_pTempBuffers )
+		m_pTempBuffers.reset(new char[m_iTempBufferQty * THREAD_STRING_LENGTH]);
+
+	if ( ++m_iTempBufferIndex >= m_iTempBufferQty )
+		m_iTempBufferIndex = 0;
+
+	if ( m_iTempScopeDepth > 0 )
 	{
-		g_tmpStringIndex %= THREAD_TSTRING_STORAGE;
+		++m_iTempScopeAllocs;
+#ifdef _DEBUG
+		if ( m_iTempScopeAllocs == m_iTempBufferQty + 1 )
+		{
+			// Report it only once for each scope.
+			DEBUG_WARN(( "Thread '%s': more than %" PRIuSIZE_T " temporary buffers used in a single scope, the first ones were overwritten.\n", getName(), m_iTempBufferQty ));
+#ifdef THREAD_TRACK_CALLSTACK
+			printStackTrace();
+#endif
+		}
+#endif
 	}
 
-	buffer = g_tmpStrings[g_tmpStringIndex];
+	buffer = &m_pTempBuffers[m_iTempBufferIndex * THREAD_STRING_LENGTH];
 	*buffer = '\0';
 
 	return buffer;
@@ -552,19 +600,42 @@ char *AbstractSphereThread::allocateBuffer()
 
 TemporaryStringStorage *AbstractSphereThread::allocateStringBuffer()
 {
-	int initialPosition = g_tmpTemporaryStringIndex;
-	int index;
-	for (;;)
+	// The thread's own storage, or the global one for the dummy thread (with the lock taken by the caller).
+	TemporaryStringStorage * pStorage;
+	size_t iQty;
+	size_t index;
+	if ( m_fSharedTempStorage )
 	{
-		index = ++g_tmpTemporaryStringIndex;
-		if( g_tmpTemporaryStringIndex >= THREAD_STRING_STORAGE )
+		pStorage = g_tmpTemporaryStringStorage;
+		iQty = THREAD_STRING_STORAGE;
+		index = (size_t)g_tmpTemporaryStringIndex;
+	}
+	else
+	{
+		if ( !m_pTempStrings )
 		{
-			index = g_tmpTemporaryStringIndex %= THREAD_STRING_STORAGE;
+			m_pTempStrings.reset(new TemporaryStringStorage[m_iTempStringQty]);
+			for ( size_t i = 0; i < m_iTempStringQty; ++i )
+				m_pTempStrings[i].m_state = 0;
 		}
+		pStorage = m_pTempStrings.get();
+		iQty = m_iTempStringQty;
+		index = m_iTempStringIndex;
+	}
+
+	const size_t initialPosition = index;
+	for (;;)
+	{
+		if ( ++index >= iQty )
+			index = 0;
+		if ( m_fSharedTempStorage )
+			g_tmpTemporaryStringIndex = (int)index;
+		else
+			m_iTempStringIndex = index;
 
-		if( g_tmpTemporaryStringStorage[index].m_state == 0 )
+		if( pStorage[index].m_state == 0 )
 		{
-			TemporaryStringStorage * store = &g_tmpTemporaryStringStorage[index];
+			TemporaryStringStorage * store = &pStorage[index];
 			*store->m_buffer = '\0';
 			return store;
 		}
@@ -585,7 +656,14 @@ TemporaryStringStorage *AbstractSphereThread::allocateStringBuffer()
 
 void AbstractSphereThread::allocateString(TemporaryString &string)
 {
-	SimpleThreadLock stlBuffer(g_tmpTemporaryStringMutex);
+	if ( m_fSharedTempStorage )
+	{
+		SimpleThreadLock stlBuffer(g_tmpTemporaryStringMutex);
+
+		TemporaryStringStorage * store = allocateStringBuffer();
+		string.init(store->m_buffer, &store->m_state);
+		return;
+	}
 
 	TemporaryStringStorage * store = allocateStringBuffer();
 	string.init(store->m_buffer, &store->m_state);
@@ -614,13 +692,28 @@ void AbstractSphereThread::pushStackCall(const char *name)
 {
     if (m_freezeCallStack == false)
     {
-        m_stackInfo[m_stackPos].functionName = name;
-        m_stackInfo[m_stackPos].startTime = GetPreciseSysTimeMicro();
-        ++m_stackPos;
-        m_stackInfo[m_stackPos].startTime = 0;
+        const size_t stackPos = m_stackPos.load(std::memory_order_relaxed);
+        m_stackInfo[stackPos].functionName = name;
+        m_stackInfo[stackPos].startTime = GetPreciseSysTimeMicro();
+        m_stackInfo[stackPos + 1].startTime = 0;
+        m_stackPos.store(stackPos + 1, std::memory_order_release);
     }
 }
 
+const char *AbstractSphereThread::getStackTop() const
+{
+    const size_t stackPos = m_stackPos.load(std::memory_order_relaxed);
+    return (stackPos > 0) ? m_stackInfo[stackPos - 1].functionName : nullptr;
+}
+
+size_t AbstractSphereThread::getStackSnapshot(const char **ppNames, size_t iMaxNames) const
+{
+    const size_t stackPos = minimum(m_stackPos.load(std::memory_order_acquire), iMaxNames);
+    for (size_t i = 0; i < stackPos; ++i)
+        ppNames[i] = m_stackInfo[i].functionName;
+    return stackPos;
+}
+
 void AbstractSphereThread::exceptionNotifyStackUnwinding(void)
 {
     //ASSERT(isCurrentThread());
@@ -677,6 +770,7 @@ DummySphereThread *DummySphereThread::instance = nullptr;
 DummySphereThread::DummySphereThread()
 	: AbstractSphereThread("dummy", IThread::Normal)
 {
+	setSharedTempStorage();
 }
 
 DummySphereThread *DummySphereThread::getInstance()
@@ -692,6 +786,41 @@ void DummySphereThread::tick()
 {
 }
 
+/*
+ * TemporaryBufferScope
+*/
+TemporaryBufferScope::TemporaryBufferScope(bool fRewind)
+{
+	m_pThread = static_cast<AbstractSphereThread *>(ThreadHolder::current());
+	if ( m_pThread->m_fSharedTempStorage )
+	{
+		m_pThread = nullptr;	// Other threads may be using it.
+		return;
+	}
+	m_fRewind = fRewind;
+	m_iMark = m_pThread->m_iTempBufferIndex;
+	m_iAllocsOuter = m_pThread->m_iTempScopeAllocs;
+	m_pThread->m_iTempScopeAllocs = 0;
+	++m_pThread->m_iTempScopeDepth;
+}
+
+TemporaryBufferScope::~TemporaryBufferScope()
+{
+	if ( m_pThread == nullptr )
+		return;
+	--m_pThread->m_iTempScopeDepth;
+	if ( m_fRewind )
+	{
+		// The buffers handed out in this scope are free again, from the outer scope's point of view.
+		m_pThread->m_iTempBufferIndex = m_iMark;
+		m_pThread->m_iTempScopeAllocs = m_iAllocsOuter;
+	}
+	else
+	{
+		m_pThread->m_iTempScopeAllocs += m_iAllocsOuter;
+	}
+}
+
 
 /*
 * StackDebugInformation
@@ -12,8 +12,10 @@
 #include "../common/sphere_library/sstringobjs.h"
 #include "../sphere/ProfileData.h"
 #include "../sphere_library/CSTime.h"
+#include <atomic>
 #include <exception>
 #include <list>
+#include <memory>
 
 #ifndef _WIN32
 	#include <pthread.h>
@@ -195,12 +197,35 @@ private:
 	static SPHERE_THREADENTRY_RETNTYPE SPHERE_THREADENTRY_CALLTYPE runner(void *callerThread);
 };
 
-struct TemporaryStringStorage;
+struct TemporaryStringStorage
+{
+	char m_buffer[THREAD_STRING_LENGTH];
+	char m_state;
+};
+
+// Temp buffers kept by the threads other than the main one (they format only logs, packets and queries).
+#define THREAD_TSTRING_STORAGE_AUX	256
+#define THREAD_STRING_STORAGE_AUX	512
 
 // Sphere thread. Have some sphere-specific
 class AbstractSphereThread : public AbstractThread
 {
+	friend class TemporaryBufferScope;
+
 private:
+	// Temp buffers owned by this thread, so no locking is needed. They are allocated at the first use.
+	// The dummy thread is shared by every thread not created by us, so it keeps using the global storage, with a lock.
+	bool m_fSharedTempStorage;
+	size_t m_iTempBufferQty;
+	size_t m_iTempBufferIndex;
+	std::unique_ptr<char[]> m_pTempBuffers;
+	size_t m_iTempStringQty;
+	size_t m_iTempStringIndex;
+	std::unique_ptr<TemporaryStringStorage[]> m_pTempStrings;
+
+	int m_iTempScopeDepth;
+	size_t m_iTempScopeAllocs;	// Buffers handed out since the innermost TemporaryBufferScope was opened.
+
 #ifdef THREAD_TRACK_CALLSTACK
 	struct STACK_INFO_REC
 	{
@@ -209,7 +234,7 @@ private:
 	};
 
 	STACK_INFO_REC m_stackInfo[0x1000];
-	size_t m_stackPos;
+	std::atomic<size_t> m_stackPos;	// Atomic only to be read by the stack sampler, it's changed only by this thread.
 	bool m_freezeCallStack;
     bool m_exceptionStackUnwinding;
 #endif
@@ -222,6 +247,11 @@ private:
 	AbstractSphereThread(const AbstractSphereThread& copy);
 	AbstractSphereThread& operator=(const AbstractSphereThread& other);
 
+protected:
+	// Size of the temp storage: to be called by the constructor of the derived class.
+	void setTempStorageSize(size_t iBuffers, size_t iStrings);
+	void setSharedTempStorage();
+
 public:
 	// allocates a char* with size of THREAD_MAX_LINE_LENGTH characters from the thread local storage
 	char *allocateBuffer();
@@ -242,11 +272,16 @@ public:
 	inline void popStackCall(void)
 	{
 		if (m_freezeCallStack == false)
-			--m_stackPos;
+			m_stackPos.store(m_stackPos.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
 	}
 
     void exceptionNotifyStackUnwinding(void);
 	void printStackTrace();
+
+	// Innermost function of the call stack (only from this thread).
+	const char *getStackTop() const;
+	// Copy the function names of the call stack, outermost first. Can be called by another thread.
+	size_t getStackSnapshot(const char **ppNames, size_t iMaxNames) const;
 #endif
 
 	ProfileData m_profile;	// the current active statistical profile.
@@ -269,6 +304,28 @@ protected:
 	virtual void tick();
 };
 
+// Marks a block (a trigger, a tick) whose Str_GetTemp buffers aren't used anymore after it ends.
+// If fRewind is true, the buffers are recycled at the end of the block, so that the next ones are taken from
+// the same (warm) memory instead of going around the whole ring.
+// In debug builds, a warning is printed if the block uses more buffers than the ring has: the first ones were
+// overwritten while they might still have been in use.
+class TemporaryBufferScope
+{
+private:
+	AbstractSphereThread * m_pThread;
+	size_t m_iMark;
+	size_t m_iAllocsOuter;
+	bool m_fRewind;
+
+public:
+	explicit TemporaryBufferScope(bool fRewind);
+	~TemporaryBufferScope();
+
+private:
+	TemporaryBufferScope(const TemporaryBufferScope& copy);
+	TemporaryBufferScope& operator=(const TemporaryBufferScope& other);
+};
+
 // stores a value unique to each thread, intended to hold
 // a pointer (e.g. the current IThread instance)
 template<class T>